@@ -2,8 +2,13 @@
 #include <memory>
 
 #include "cl_benchmark_main.hpp"
+#include "fixtures/compute_opencl_fixture.h"
 #include "fixtures/cuboid_opencl_fixture.h"
+#include "fixtures/factorial_multi_device_fixture.h"
+#include "fixtures/factorial_multi_queue_fixture.h"
 #include "fixtures/factorial_opencl_fixture.h"
+#include "fixtures/primitive_host_fixture.h"
+#include "fixtures/primitive_opencl_fixture.h"
 
 using namespace kpv::cl_benchmark;
 
@@ -17,11 +22,17 @@ template <>
 const char* const OpenClTypeTraits<float>::short_description = "single precision";
 template <>
 const char* const OpenClTypeTraits<double>::short_description = "double precision";
+template <>
+const char* const OpenClTypeTraits<cl_int>::short_description = "32-bit integer";
+
+// Numbers of command queues used to check if devices execute independent work concurrently
+const int kQueueCounts[] = {2, 4};
 
 FixtureFamily CreateFactorialFixture(const PlatformList& platform_list, int32_t data_size) {
     FixtureFamily fixture_family;
     fixture_family.name = (boost::format("Factorial, %1% elements") % data_size).str();
     fixture_family.element_count = data_size;
+    std::vector<std::shared_ptr<DeviceInterface>> all_devices;
     for (auto& platform : platform_list.OpenClPlatforms()) {
         for (auto& device : platform->GetDevices()) {
             fixture_family.fixtures.insert(
@@ -29,6 +40,48 @@ FixtureFamily CreateFactorialFixture(const PlatformList& platform_list, int32_t
                     FixtureId(fixture_family.name, device, ""),
                     std::make_shared<kpv::FactorialOpenClFixture>(
                         std::dynamic_pointer_cast<OpenClDevice>(device), data_size)));
+            for (int queue_count : kQueueCounts) {
+                fixture_family.fixtures.insert(
+                    std::make_pair<const FixtureId, std::shared_ptr<Fixture>>(
+                        FixtureId(
+                            fixture_family.name, device,
+                            (boost::format("%1% queues") % queue_count).str()),
+                        std::make_shared<kpv::FactorialMultiQueueFixture>(
+                            std::dynamic_pointer_cast<OpenClDevice>(device), data_size,
+                            queue_count)));
+            }
+            all_devices.push_back(device);
+        }
+        // Compute unit sweep compares a single queue fixture of sub-devices with the whole device
+        auto opencl_platform = std::dynamic_pointer_cast<OpenClPlatform>(platform);
+        for (auto& sub_device : opencl_platform->GetSubDevices()) {
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, sub_device, ""),
+                std::make_shared<kpv::FactorialOpenClFixture>(
+                    std::dynamic_pointer_cast<OpenClDevice>(sub_device), data_size));
+        }
+    }
+
+    // Split the same work between all devices to see if using them together pays off. Every
+    // device alone in a group of its own is a baseline measured by the same host code
+    if (all_devices.size() > 1) {
+        for (auto& device : all_devices) {
+            auto single_device = std::make_shared<DeviceGroup>(
+                std::vector<std::shared_ptr<DeviceInterface>>{device});
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, single_device, "single device"),
+                std::make_shared<kpv::FactorialMultiDeviceFixture>(
+                    single_device, data_size, PartitionStrategy::kStatic));
+        }
+        auto device_group = std::make_shared<DeviceGroup>(all_devices);
+        for (PartitionStrategy strategy :
+             {PartitionStrategy::kStatic, PartitionStrategy::kProportional,
+              PartitionStrategy::kDynamic}) {
+            fixture_family.fixtures.insert(
+                std::make_pair<const FixtureId, std::shared_ptr<Fixture>>(
+                    FixtureId(fixture_family.name, device_group, PartitionStrategyName(strategy)),
+                    std::make_shared<kpv::FactorialMultiDeviceFixture>(
+                        device_group, data_size, strategy)));
         }
     }
     return fixture_family;
@@ -41,13 +94,84 @@ FixtureFamily CreateCuboidFixture(const PlatformList& platform_list, int32_t dat
                            OpenClTypeTraits<T>::short_description % data_size)
                               .str();
     fixture_family.element_count = data_size;
+    // Zero-copy fixture keeps data in page aligned host memory that a device uses directly,
+    // CPU devices usually map such buffers without copying
+    HostAllocationStrategy zero_copy;
+    zero_copy.alignment = HostAllocationStrategy::kPageSize;
+    zero_copy.huge_pages = HostAllocationStrategy::HugePages::kTransparent;
+    zero_copy.use_host_ptr = true;
     for (auto& platform : platform_list.OpenClPlatforms()) {
         for (auto& device : platform->GetDevices()) {
+            auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device);
             fixture_family.fixtures.insert(
                 std::make_pair<const FixtureId, std::shared_ptr<Fixture>>(
                     FixtureId(fixture_family.name, device, ""),
-                    std::make_shared<kpv::CuboidOpenClFixture<T>>(
-                        std::dynamic_pointer_cast<OpenClDevice>(device), data_size)));
+                    std::make_shared<kpv::CuboidOpenClFixture<T>>(opencl_device, data_size)));
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, device, "zero-copy"),
+                std::make_shared<kpv::CuboidOpenClFixture<T>>(
+                    opencl_device, data_size, std::string(), zero_copy));
+        }
+    }
+    return fixture_family;
+}
+
+// Boost.Compute algorithm, hand-written kernels and threads of a host compute the same primitive
+template <typename T>
+FixtureFamily CreatePrimitiveFixture(
+    const PlatformList& platform_list, kpv::Primitive primitive, int32_t data_size) {
+    FixtureFamily fixture_family;
+    fixture_family.name =
+        (boost::format("%1%, %2%, %3% elements") % kpv::PrimitiveName(primitive) %
+         OpenClTypeTraits<T>::short_description % data_size)
+            .str();
+    fixture_family.element_count = data_size;
+    for (auto& platform : platform_list.OpenClPlatforms()) {
+        for (auto& device : platform->GetDevices()) {
+            auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device);
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, device, "boost.compute"),
+                std::make_shared<kpv::PrimitiveOpenClFixture<T>>(
+                    opencl_device, primitive, kpv::PrimitiveImplementation::kBoostCompute,
+                    data_size));
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, device, "local memory kernels"),
+                std::make_shared<kpv::PrimitiveOpenClFixture<T>>(
+                    opencl_device, primitive, kpv::PrimitiveImplementation::kHandWritten,
+                    data_size));
+        }
+    }
+    for (auto& platform : platform_list.HostPlatforms()) {
+        for (auto& device : platform->GetDevices()) {
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, device, "threads"),
+                std::make_shared<kpv::PrimitiveHostFixture<T>>(
+                    std::dynamic_pointer_cast<HostDevice>(device), primitive, data_size));
+        }
+    }
+    return fixture_family;
+}
+
+// Kernels with increasing data reuse solve the same problem, so their places on a roofline of
+// a device can be compared
+template <typename T>
+FixtureFamily CreateComputeFixture(
+    const PlatformList& platform_list, kpv::ComputeProblem problem, int32_t size) {
+    FixtureFamily fixture_family;
+    fixture_family.name = (boost::format("%1%, %2%, %3%x%3%") % kpv::ComputeProblemName(problem) %
+                           OpenClTypeTraits<T>::short_description % size)
+                              .str();
+    fixture_family.element_count = size * size;
+    for (auto& platform : platform_list.OpenClPlatforms()) {
+        for (auto& device : platform->GetDevices()) {
+            for (kpv::ComputeKernel kernel :
+                 {kpv::ComputeKernel::kNaive, kpv::ComputeKernel::kLocalTiles,
+                  kpv::ComputeKernel::kRegisterBlocking}) {
+                fixture_family.fixtures.emplace(
+                    FixtureId(fixture_family.name, device, kpv::ComputeKernelName(kernel)),
+                    std::make_shared<kpv::ComputeOpenClFixture<T>>(
+                        std::dynamic_pointer_cast<OpenClDevice>(device), problem, kernel, size));
+            }
         }
     }
     return fixture_family;
@@ -55,6 +179,8 @@ FixtureFamily CreateCuboidFixture(const PlatformList& platform_list, int32_t dat
 }  // namespace
 
 using namespace ::std::placeholders;
+using kpv::ComputeProblem;
+using kpv::Primitive;
 
 REGISTER_FIXTURE("trivial-factorial", std::bind(&CreateFactorialFixture, _1, 100));
 REGISTER_FIXTURE("trivial-factorial", std::bind(&CreateFactorialFixture, _1, 1000));
@@ -64,3 +190,48 @@ REGISTER_FIXTURE("cuboid", std::bind(&CreateCuboidFixture<float>, _1, 100));
 REGISTER_FIXTURE("cuboid", std::bind(&CreateCuboidFixture<float>, _1, 1000));
 REGISTER_FIXTURE("cuboid", std::bind(&CreateCuboidFixture<double>, _1, 100000));
 REGISTER_FIXTURE("cuboid", std::bind(&CreateCuboidFixture<double>, _1, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kReduce, 65536));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kReduce, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kReduce, 65536));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kReduce, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kInclusiveScan, 65536));
+REGISTER_FIXTURE(
+    "primitives",
+    std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kInclusiveScan, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kInclusiveScan, 65536));
+REGISTER_FIXTURE(
+    "primitives",
+    std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kInclusiveScan, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kSort, 65536));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<cl_int>, _1, Primitive::kSort, 1000000));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kSort, 65536));
+REGISTER_FIXTURE(
+    "primitives", std::bind(&CreatePrimitiveFixture<float>, _1, Primitive::kSort, 1000000));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<float>, _1, ComputeProblem::kMatrixMultiply, 256));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<float>, _1, ComputeProblem::kMatrixMultiply, 1024));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<double>, _1, ComputeProblem::kMatrixMultiply, 256));
+REGISTER_FIXTURE(
+    "compute",
+    std::bind(&CreateComputeFixture<double>, _1, ComputeProblem::kMatrixMultiply, 1024));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<float>, _1, ComputeProblem::kStencil, 1024));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<float>, _1, ComputeProblem::kStencil, 4096));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<double>, _1, ComputeProblem::kStencil, 1024));
+REGISTER_FIXTURE(
+    "compute", std::bind(&CreateComputeFixture<double>, _1, ComputeProblem::kStencil, 4096));
+REGISTER_FIXTURE("simulated", std::bind(&CreateSimulatedFixtureFamily, _1, 1));
+REGISTER_FIXTURE("simulated", std::bind(&CreateSimulatedFixtureFamily, _1, 4));
@@ -0,0 +1,168 @@
+#include "compute_common.h"
+
+#include <algorithm>
+#include <boost/format.hpp>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+namespace {
+// Weights of the stencil, same as in compute_opencl_fixture.cpp
+const double kCenterWeight = 0.5;
+const double kSideWeight = 0.125;
+
+// Maximum relative error allowed during result verification. Matrix elements are sums of
+// thousands of products, so single precision error is much larger than for one operation
+template <typename T>
+struct ComputeVerificationTraits {
+    static const double max_relative_error;
+};
+
+template <>
+const double ComputeVerificationTraits<float>::max_relative_error = 1e-4;
+template <>
+const double ComputeVerificationTraits<double>::max_relative_error = 1e-10;
+
+// Expected results are calculated in double precision, loops are ordered for sequential access
+template <typename T>
+void MultiplyMatrices(kpv::ComputeDataset<T>& dataset, std::size_t size) {
+    std::vector<double> result(size * size, 0.0);
+    for (std::size_t row = 0; row < size; ++row) {
+        for (std::size_t k = 0; k < size; ++k) {
+            const double a = dataset.first_input[row * size + k];
+            const T* b_row = dataset.second_input.data() + k * size;
+            double* result_row = result.data() + row * size;
+            for (std::size_t col = 0; col < size; ++col) {
+                result_row[col] += a * b_row[col];
+            }
+        }
+    }
+    dataset.expected.assign(result.cbegin(), result.cend());
+}
+
+// Boundary points are copied from input
+template <typename T>
+void ApplyStencil(kpv::ComputeDataset<T>& dataset, std::size_t size) {
+    const std::vector<T>& input = dataset.first_input;
+    dataset.expected = input;
+    for (std::size_t y = 1; y + 1 < size; ++y) {
+        for (std::size_t x = 1; x + 1 < size; ++x) {
+            const std::size_t i = y * size + x;
+            const double sides = static_cast<double>(input[i - size]) + input[i + size] +
+                                 input[i - 1] + input[i + 1];
+            dataset.expected[i] = static_cast<T>(kCenterWeight * input[i] + kSideWeight * sides);
+        }
+    }
+}
+
+template <typename T>
+kpv::ComputeDataset<T> GenerateData(
+    const kpv::cl_benchmark::DataGenerator& generator, kpv::ComputeProblem problem, int size) {
+    const std::size_t side = static_cast<std::size_t>(size);
+    kpv::ComputeDataset<T> dataset;
+    // Values are positive, so relative error of sums is small for any summation order
+    dataset.first_input.resize(side * side);
+    generator.FillUniformReal(dataset.first_input, T(0), T(1), "Compute first input");
+    if (problem == kpv::ComputeProblem::kMatrixMultiply) {
+        dataset.second_input.resize(side * side);
+        generator.FillUniformReal(dataset.second_input, T(0), T(1), "Compute second input");
+        MultiplyMatrices(dataset, side);
+    } else {
+        ApplyStencil(dataset, side);
+    }
+    return dataset;
+}
+}  // namespace
+
+namespace kpv {
+const char* ComputeProblemName(ComputeProblem problem) {
+    switch (problem) {
+    case ComputeProblem::kMatrixMultiply:
+        return "Matrix multiply";
+    case ComputeProblem::kStencil:
+        return "5-point stencil";
+    }
+    throw std::invalid_argument("Unknown compute problem.");
+}
+
+template <typename T>
+std::shared_ptr<const ComputeDataset<T>> GetComputeDataset(
+    const cl_benchmark::InitializationParams& params, ComputeProblem problem, int size) {
+    return params.dataset_cache->GetOrCreate<ComputeDataset<T>>(
+        (boost::format("%1%, %2% bytes per value, %3%x%3%") % ComputeProblemName(problem) %
+         sizeof(T) % size)
+            .str(),
+        [&params, problem, size]() {
+            return GenerateData<T>(params.data_generator, problem, size);
+        });
+}
+
+template <typename T>
+cl_benchmark::WorkAmount ComputeWorkAmount(ComputeProblem problem, int size) {
+    const double side = size;
+    cl_benchmark::WorkAmount result;
+    result.precision = sizeof(T) == sizeof(double) ? cl_benchmark::WorkAmount::Precision::kDouble
+                                                   : cl_benchmark::WorkAmount::Precision::kSingle;
+    if (problem == ComputeProblem::kMatrixMultiply) {
+        // A multiplication and an addition for every pair of elements, A and B are read and C
+        // is written
+        result.flops = 2.0 * side * side * side;
+        result.bytes = 3.0 * side * side * sizeof(T);
+    } else {
+        // 4 additions and 2 multiplications for every inner point
+        result.flops = 6.0 * (side - 2) * (side - 2);
+        result.bytes = 2.0 * side * side * sizeof(T);
+    }
+    return result;
+}
+
+template <typename T>
+cl_benchmark::ResultAccuracy VerifyComputeResults(
+    ComputeProblem problem, const std::vector<T>& output, const ComputeDataset<T>& dataset,
+    bool throw_on_error) {
+    if (output.size() != dataset.expected.size()) {
+        throw std::runtime_error(
+            (boost::format("Result verification has failed for %1% fixture. "
+                           "Output data count is another from expected one.") %
+             ComputeProblemName(problem))
+                .str());
+    }
+    const double max_relative_error = ComputeVerificationTraits<T>::max_relative_error;
+    cl_benchmark::ResultAccuracy accuracy;
+    double error_sum = 0.0;
+    for (std::size_t i = 0; i < output.size(); ++i) {
+        const double expected = dataset.expected[i];
+        const double relative_error =
+            std::abs(output[i] - expected) /
+            std::max(std::abs(expected), std::numeric_limits<double>::min());
+        if (!(relative_error <= max_relative_error) && throw_on_error) {
+            throw std::runtime_error(
+                (boost::format("Result verification has failed for %1% fixture. "
+                               "Relative error of element %2% is %3% (maximum allowed is %4%).") %
+                 ComputeProblemName(problem) % i % relative_error % max_relative_error)
+                    .str());
+        }
+        // NaN is propagated, so broken results of a variant are visible in the report
+        if (std::isnan(relative_error) || relative_error > accuracy.max_relative_error) {
+            accuracy.max_relative_error = relative_error;
+        }
+        error_sum += relative_error;
+    }
+    if (!output.empty()) {
+        accuracy.mean_relative_error = error_sum / output.size();
+    }
+    return accuracy;
+}
+
+template std::shared_ptr<const ComputeDataset<float>> GetComputeDataset<float>(
+    const cl_benchmark::InitializationParams&, ComputeProblem, int);
+template std::shared_ptr<const ComputeDataset<double>> GetComputeDataset<double>(
+    const cl_benchmark::InitializationParams&, ComputeProblem, int);
+template cl_benchmark::WorkAmount ComputeWorkAmount<float>(ComputeProblem, int);
+template cl_benchmark::WorkAmount ComputeWorkAmount<double>(ComputeProblem, int);
+template cl_benchmark::ResultAccuracy VerifyComputeResults<float>(
+    ComputeProblem, const std::vector<float>&, const ComputeDataset<float>&, bool);
+template cl_benchmark::ResultAccuracy VerifyComputeResults<double>(
+    ComputeProblem, const std::vector<double>&, const ComputeDataset<double>&, bool);
+}  // namespace kpv
@@ -0,0 +1,51 @@
+#ifndef EXAMPLES_FIXTURES_COMPUTE_COMMON_H_
+#define EXAMPLES_FIXTURES_COMPUTE_COMMON_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+
+namespace kpv {
+/*
+Dense kernels with a known amount of arithmetic and memory traffic: a multiplication of square
+matrices (C = A * B) and a 5-point Jacobi stencil on a square grid
+*/
+enum class ComputeProblem { kMatrixMultiply, kStencil };
+
+const char* ComputeProblemName(ComputeProblem problem);
+
+/*
+Input data and expected results, shared by all fixtures of one family. Matrix multiplication
+has two inputs (A and B), a stencil has one.
+*/
+template <typename T>
+struct ComputeDataset {
+    std::vector<T> first_input;
+    std::vector<T> second_input;
+    std::vector<T> expected;
+};
+
+// size is a side of a matrix or of a grid
+template <typename T>
+std::shared_ptr<const ComputeDataset<T>> GetComputeDataset(
+    const cl_benchmark::InitializationParams& params, ComputeProblem problem, int size);
+
+/*
+Flops and compulsory global memory traffic of one run of a problem: every input is read once
+and every output is written once
+*/
+template <typename T>
+cl_benchmark::WorkAmount ComputeWorkAmount(ComputeProblem problem, int size);
+
+/*
+Relative error of output against expected results. Throws if it exceeds a tolerance of T,
+unless throw_on_error is false.
+*/
+template <typename T>
+cl_benchmark::ResultAccuracy VerifyComputeResults(
+    ComputeProblem problem, const std::vector<T>& output, const ComputeDataset<T>& dataset,
+    bool throw_on_error);
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_COMPUTE_COMMON_H_
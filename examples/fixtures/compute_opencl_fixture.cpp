@@ -0,0 +1,334 @@
+#include "compute_opencl_fixture.h"
+
+#include <boost/format.hpp>
+#include <stdexcept>
+#include <string>
+
+namespace {
+const char* kProgramCode = R"(
+#define TILE 16
+// Outputs calculated by one work-item of register blocking kernels
+#define WPT 4
+#define RTS (TILE / WPT)
+
+__kernel void MatrixMultiplyNaive(
+    __global const T* a, __global const T* b, __global T* c, uint n)
+{
+    const uint col = get_global_id(0);
+    const uint row = get_global_id(1);
+    T sum = 0;
+    for (uint k = 0; k < n; ++k) {
+        sum += a[row * n + k] * b[k * n + col];
+    }
+    c[row * n + col] = sum;
+}
+
+// Every element loaded to local memory is used by TILE work-items
+__kernel void MatrixMultiplyTiled(
+    __global const T* a, __global const T* b, __global T* c, uint n)
+{
+    __local T a_tile[TILE][TILE];
+    __local T b_tile[TILE][TILE];
+    const uint local_col = get_local_id(0);
+    const uint local_row = get_local_id(1);
+    const uint col = get_global_id(0);
+    const uint row = get_global_id(1);
+    T sum = 0;
+    for (uint tile = 0; tile < n / TILE; ++tile) {
+        a_tile[local_row][local_col] = a[row * n + tile * TILE + local_col];
+        b_tile[local_row][local_col] = b[(tile * TILE + local_row) * n + col];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint k = 0; k < TILE; ++k) {
+            sum += a_tile[local_row][k] * b_tile[k][local_col];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    c[row * n + col] = sum;
+}
+
+// Work-group of TILE x RTS work-items calculates a TILE x TILE tile, every work-item calculates
+// WPT rows of a column and reuses an element of B for all of them
+__kernel void MatrixMultiplyBlocked(
+    __global const T* a, __global const T* b, __global T* c, uint n)
+{
+    __local T a_tile[TILE][TILE];
+    __local T b_tile[TILE][TILE];
+    const uint local_col = get_local_id(0);
+    const uint local_row = get_local_id(1);
+    const uint col = get_group_id(0) * TILE + local_col;
+    const uint row = get_group_id(1) * TILE + local_row;
+    T sums[WPT];
+    for (uint w = 0; w < WPT; ++w) {
+        sums[w] = 0;
+    }
+    for (uint tile = 0; tile < n / TILE; ++tile) {
+        for (uint w = 0; w < WPT; ++w) {
+            const uint tile_row = local_row + w * RTS;
+            a_tile[tile_row][local_col] = a[(row + w * RTS) * n + tile * TILE + local_col];
+            b_tile[tile_row][local_col] = b[(tile * TILE + tile_row) * n + col];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+        for (uint k = 0; k < TILE; ++k) {
+            const T b_value = b_tile[k][local_col];
+            for (uint w = 0; w < WPT; ++w) {
+                sums[w] += a_tile[local_row + w * RTS][k] * b_value;
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    for (uint w = 0; w < WPT; ++w) {
+        c[(row + w * RTS) * n + col] = sums[w];
+    }
+}
+
+bool IsBoundary(uint x, uint y, uint n)
+{
+    return x == 0 || y == 0 || x == n - 1 || y == n - 1;
+}
+
+T Stencil(T center, T up, T down, T left, T right)
+{
+    return (T)0.5 * center + (T)0.125 * (up + down + left + right);
+}
+
+// Boundary points are copied from input
+__kernel void StencilNaive(__global const T* input, __global T* output, uint n)
+{
+    const uint x = get_global_id(0);
+    const uint y = get_global_id(1);
+    const uint i = y * n + x;
+    output[i] = IsBoundary(x, y, n)
+        ? input[i]
+        : Stencil(input[i], input[i - n], input[i + n], input[i - 1], input[i + 1]);
+}
+
+// Tile with a halo of one point is loaded by all work-items of a group, so every input point is
+// read from global memory about once. Halo outside of a grid is clamped
+__kernel void StencilTiled(__global const T* input, __global T* output, uint n)
+{
+    __local T tile[TILE + 2][TILE + 2];
+    const uint local_x = get_local_id(0);
+    const uint local_y = get_local_id(1);
+    const int base_x = (int)(get_group_id(0) * TILE) - 1;
+    const int base_y = (int)(get_group_id(1) * TILE) - 1;
+    for (uint i = local_y * TILE + local_x; i < (TILE + 2) * (TILE + 2); i += TILE * TILE) {
+        const int x = clamp(base_x + (int)(i % (TILE + 2)), 0, (int)n - 1);
+        const int y = clamp(base_y + (int)(i / (TILE + 2)), 0, (int)n - 1);
+        tile[i / (TILE + 2)][i % (TILE + 2)] = input[y * n + x];
+    }
+    barrier(CLK_LOCAL_MEM_FENCE);
+    const uint x = get_global_id(0);
+    const uint y = get_global_id(1);
+    const T center = tile[local_y + 1][local_x + 1];
+    output[y * n + x] = IsBoundary(x, y, n)
+        ? center
+        : Stencil(center, tile[local_y][local_x + 1], tile[local_y + 2][local_x + 1],
+                  tile[local_y + 1][local_x], tile[local_y + 1][local_x + 2]);
+}
+
+// Every work-item calculates WPT points of a column, points above and below are kept in
+// registers and reused by next points
+__kernel void StencilBlocked(__global const T* input, __global T* output, uint n)
+{
+    const uint x = get_global_id(0);
+    const uint first_y = get_global_id(1) * WPT;
+    T up = input[(first_y > 0 ? first_y - 1 : 0) * n + x];
+    T center = input[first_y * n + x];
+    for (uint w = 0; w < WPT; ++w) {
+        const uint y = first_y + w;
+        const T down = input[min(y + 1, n - 1) * n + x];
+        output[y * n + x] = IsBoundary(x, y, n)
+            ? center
+            : Stencil(center, up, down, input[y * n + x - 1], input[y * n + x + 1]);
+        up = center;
+        center = down;
+    }
+}
+)";
+
+constexpr const char* const kCompilerOptions = "-Werror";
+
+// Same as TILE and WPT of the program
+constexpr std::size_t kTile = 16;
+constexpr std::size_t kWorkPerItem = 4;
+
+template <typename T>
+struct OpenClTypeTraits {
+    static const char* const required_extension;
+    static const char* const type_name;
+    static const char* const source_prefix;  // Enables the required extension if needed
+};
+
+template <>
+const char* const OpenClTypeTraits<float>::required_extension = "";
+template <>
+const char* const OpenClTypeTraits<double>::required_extension = "cl_khr_fp64";
+template <>
+const char* const OpenClTypeTraits<float>::type_name = "float";
+template <>
+const char* const OpenClTypeTraits<double>::type_name = "double";
+template <>
+const char* const OpenClTypeTraits<float>::source_prefix = "";
+template <>
+const char* const OpenClTypeTraits<double>::source_prefix = R"(
+#if __OPENCL_VERSION__ <= CL_VERSION_1_1
+    #pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif)";
+
+const char* KernelFunctionName(kpv::ComputeProblem problem, kpv::ComputeKernel kernel) {
+    const bool matrix = problem == kpv::ComputeProblem::kMatrixMultiply;
+    switch (kernel) {
+    case kpv::ComputeKernel::kNaive:
+        return matrix ? "MatrixMultiplyNaive" : "StencilNaive";
+    case kpv::ComputeKernel::kLocalTiles:
+        return matrix ? "MatrixMultiplyTiled" : "StencilTiled";
+    case kpv::ComputeKernel::kRegisterBlocking:
+        return matrix ? "MatrixMultiplyBlocked" : "StencilBlocked";
+    }
+    throw std::invalid_argument("Unknown compute kernel.");
+}
+}  // namespace
+
+namespace kpv {
+const char* ComputeKernelName(ComputeKernel kernel) {
+    switch (kernel) {
+    case ComputeKernel::kNaive:
+        return "naive";
+    case ComputeKernel::kLocalTiles:
+        return "local memory tiles";
+    case ComputeKernel::kRegisterBlocking:
+        return "register blocking";
+    }
+    throw std::invalid_argument("Unknown compute kernel.");
+}
+
+template <typename T>
+std::vector<std::string> ComputeOpenClFixture<T>::GetRequiredExtensions() {
+    std::string required_extension = OpenClTypeTraits<T>::required_extension;
+    std::vector<std::string> result;
+    if (!required_extension.empty()) {
+        result.push_back(required_extension);
+    }
+    return result;
+}
+
+template <typename T>
+std::vector<cl_benchmark::ProgramSource> ComputeOpenClFixture<T>::GetProgramSources() {
+    return {GetProgramSource()};
+}
+
+template <typename T>
+void ComputeOpenClFixture<T>::Initialize(const cl_benchmark::InitializationParams& params) {
+    if (size_ <= 0 || static_cast<std::size_t>(size_) % kTile != 0) {
+        throw std::invalid_argument(
+            (boost::format("Size %1% is not a multiple of %2%") % size_ % kTile).str());
+    }
+    dataset_ = GetComputeDataset<T>(params, problem_, size_);
+
+    // Program is usually built in background already
+    boost::compute::program program = params.program_cache->Get(GetProgramSource());
+    kernel_ = program.create_kernel(KernelFunctionName(problem_, kernel_kind_));
+    // Work-group size of kernels that share data in local memory, see Launch()
+    std::size_t group_size = 0;
+    if (kernel_kind_ == ComputeKernel::kLocalTiles) {
+        group_size = kTile * kTile;
+    } else if (
+        kernel_kind_ == ComputeKernel::kRegisterBlocking &&
+        problem_ == ComputeProblem::kMatrixMultiply) {
+        group_size = kTile * kTile / kWorkPerItem;
+    }
+    const std::size_t max_group_size = kernel_.get_work_group_info<std::size_t>(
+        device_->device(), CL_KERNEL_WORK_GROUP_SIZE);
+    if (max_group_size < group_size) {
+        throw std::runtime_error(
+            (boost::format("Kernel supports work-groups of up to %1% work-items, %2% are needed") %
+             max_group_size % group_size)
+                .str());
+    }
+
+    boost::compute::context& context = device_->GetContext();
+    boost::compute::command_queue& queue = device_->GetQueue();
+    first_input_ = boost::compute::vector<T>(
+        dataset_->first_input.cbegin(), dataset_->first_input.cend(), queue);
+    output_ = boost::compute::vector<T>(dataset_->expected.size(), context);
+    output_data_.resize(dataset_->expected.size());
+    int arg = 0;
+    kernel_.set_arg(arg++, first_input_);
+    if (problem_ == ComputeProblem::kMatrixMultiply) {
+        second_input_ = boost::compute::vector<T>(
+            dataset_->second_input.cbegin(), dataset_->second_input.cend(), queue);
+        kernel_.set_arg(arg++, second_input_);
+    }
+    kernel_.set_arg(arg++, output_);
+    kernel_.set_arg(arg++, static_cast<cl_uint>(size_));
+}
+
+template <typename T>
+kpv::cl_benchmark::EventList ComputeOpenClFixture<T>::Execute(
+    const cl_benchmark::RuntimeParams& params) {
+    boost::compute::command_queue& queue = device_->GetQueue();
+    kpv::cl_benchmark::EventList event_list;
+
+    // Kernel overwrites its output, so it may be launched several times in a row
+    boost::compute::event first_launch = Launch(queue);
+    boost::compute::event last_launch = first_launch;
+    for (int i = 1; i < params.launch_count; ++i) {
+        last_launch = Launch(queue);
+    }
+    event_list.AddOpenClEventBatch("Calculating", first_launch, last_launch, params.launch_count);
+
+    event_list.AddOpenClEvent(
+        "Copying output data",
+        boost::compute::copy_async(output_.begin(), output_.end(), output_data_.begin(), queue));
+    return event_list;
+}
+
+template <typename T>
+void ComputeOpenClFixture<T>::VerifyResults() {
+    accuracy_ = VerifyComputeResults(problem_, output_data_, *dataset_, build_options_.empty());
+}
+
+template <typename T>
+boost::optional<cl_benchmark::WorkAmount> ComputeOpenClFixture<T>::GetWorkAmount() {
+    cl_benchmark::WorkAmount result = ComputeWorkAmount<T>(problem_, size_);
+    result.step = "Calculating";
+    return result;
+}
+
+template <typename T>
+cl_benchmark::ProgramSource ComputeOpenClFixture<T>::GetProgramSource() {
+    cl_benchmark::ProgramSource result;
+    result.context = device_->GetContext();
+    result.source = std::string(OpenClTypeTraits<T>::source_prefix) + kProgramCode;
+    result.options = std::string(kCompilerOptions) + " -DT=" + OpenClTypeTraits<T>::type_name +
+                     " " + build_options_;
+    return result;
+}
+
+template <typename T>
+boost::compute::event ComputeOpenClFixture<T>::Launch(boost::compute::command_queue& queue) {
+    const std::size_t side = static_cast<std::size_t>(size_);
+    std::size_t global_size[2] = {side, side};
+    std::size_t local_size[2] = {kTile, kTile};
+    const std::size_t* used_local_size = nullptr;  // Chosen by an implementation
+    switch (kernel_kind_) {
+    case ComputeKernel::kNaive:
+        break;
+    case ComputeKernel::kLocalTiles:
+        used_local_size = local_size;
+        break;
+    case ComputeKernel::kRegisterBlocking:
+        global_size[1] = side / kWorkPerItem;
+        // Matrix kernel shares tiles between work-items, a stencil one needs no local memory
+        if (problem_ == ComputeProblem::kMatrixMultiply) {
+            local_size[1] = kTile / kWorkPerItem;
+            used_local_size = local_size;
+        }
+        break;
+    }
+    return queue.enqueue_nd_range_kernel(kernel_, 2, nullptr, global_size, used_local_size);
+}
+
+template class ComputeOpenClFixture<float>;
+template class ComputeOpenClFixture<double>;
+}  // namespace kpv
@@ -0,0 +1,86 @@
+#ifndef EXAMPLES_FIXTURES_COMPUTE_OPENCL_FIXTURE_H_
+#define EXAMPLES_FIXTURES_COMPUTE_OPENCL_FIXTURE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+#include "compute_common.h"
+
+namespace kpv {
+// The same problem is solved by kernels with increasing data reuse
+enum class ComputeKernel {
+    kNaive,            // Every work-item reads all its operands from global memory
+    kLocalTiles,       // Work-groups share tiles of inputs in local memory
+    kRegisterBlocking  // Every work-item calculates several outputs and reuses operands
+};
+
+const char* ComputeKernelName(ComputeKernel kernel);
+
+/*
+Matrix multiplication or a stencil on an OpenCL device. Inputs are copied to a device once in
+Initialize(), every iteration launches a kernel and copies its output back. Fixture declares
+its work amount, so the report shows achieved GFLOP/s and a place on a roofline of a device.
+*/
+template <typename T>
+class ComputeOpenClFixture final : public cl_benchmark::Fixture {
+public:
+    // size is a side of matrices or of a grid, it must be a multiple of 16
+    ComputeOpenClFixture(
+        const std::shared_ptr<cl_benchmark::OpenClDevice>& device, ComputeProblem problem,
+        ComputeKernel kernel, int size, const std::string& build_options = std::string())
+        : device_(device),
+          problem_(problem),
+          kernel_kind_(kernel),
+          size_(size),
+          build_options_(build_options) {}
+
+    std::vector<std::string> GetRequiredExtensions() override;
+
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
+
+    virtual void VerifyResults() override;
+
+    virtual bool SupportsBatching() override { return true; }
+
+    virtual std::shared_ptr<cl_benchmark::Fixture> CreateBuildVariant(
+        const std::string& build_options) override {
+        return std::make_shared<ComputeOpenClFixture<T>>(
+            device_, problem_, kernel_kind_, size_, build_options_ + " " + build_options);
+    }
+
+    virtual boost::optional<cl_benchmark::ResultAccuracy> GetResultAccuracy() override {
+        return accuracy_;
+    }
+
+    virtual boost::optional<cl_benchmark::WorkAmount> GetWorkAmount() override;
+
+    virtual ~ComputeOpenClFixture() noexcept {}
+
+private:
+    const std::shared_ptr<cl_benchmark::OpenClDevice> device_;
+    const ComputeProblem problem_;
+    const ComputeKernel kernel_kind_;
+    const int size_;
+    // Results of a program built with non-default options are not required to be within
+    // the tolerance, their error is reported instead
+    const std::string build_options_;
+    boost::optional<cl_benchmark::ResultAccuracy> accuracy_;
+    std::shared_ptr<const ComputeDataset<T>> dataset_;
+    std::vector<T> output_data_;
+    boost::compute::vector<T> first_input_;
+    boost::compute::vector<T> second_input_;
+    boost::compute::vector<T> output_;
+    boost::compute::kernel kernel_;
+
+    cl_benchmark::ProgramSource GetProgramSource();
+    boost::compute::event Launch(boost::compute::command_queue& queue);
+};
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_COMPUTE_OPENCL_FIXTURE_H_
@@ -1,7 +1,7 @@
 #include "cuboid_opencl_fixture.h"
 
 #include <boost/format.hpp>
-#include <random>
+#include <cmath>
 
 namespace {
 const char* kProgramCode = R"(
@@ -26,6 +26,8 @@ __kernel void CuboidVolumesAndSurfaces(__global T* dimensions, __global T* volum
 template <typename T>
 struct OpenClTypeTraits {
     static const char* const required_extension;
+    static const char* const type_name;
+    static const char* const source_prefix;  // Enables the required extension if needed
 };
 
 // No extensions needed for single precision arithmetic
@@ -33,59 +35,60 @@ template <>
 const char* const OpenClTypeTraits<float>::required_extension = "";
 template <>
 const char* const OpenClTypeTraits<double>::required_extension = "cl_khr_fp64";
+template <>
+const char* const OpenClTypeTraits<float>::type_name = "float";
+template <>
+const char* const OpenClTypeTraits<double>::type_name = "double";
+template <>
+const char* const OpenClTypeTraits<float>::source_prefix = "";
+template <>
+const char* const OpenClTypeTraits<double>::source_prefix = R"(
+#if __OPENCL_VERSION__ <= CL_VERSION_1_1
+    #pragma OPENCL EXTENSION cl_khr_fp64 : enable
+#endif)";
 
-constexpr const char* const kCompilerOptions = "-Werror";
+// Maximum relative error allowed during result verification
+template <typename T>
+struct VerificationTraits {
+    static const T max_relative_error;
+};
 
-boost::compute::program BuildProgram(
-    const std::string& source, boost::compute::context& context,
-    const std::string& buildOptions = std::string()) {
-    // Taken from boost::compute::program::create_with_source() so we have build log
-    // left in case of errors
-    const char* source_string = source.c_str();
-
-    cl_int error = 0;
-    cl_program program_ = clCreateProgramWithSource(context, 1, &source_string, 0, &error);
-    boost::compute::program program;
-    try {
-        if (!program_) {
-            throw boost::compute::opencl_error(error);
-        }
-        program = boost::compute::program(program_);
-        program.build(buildOptions);
-        return program;
-    } catch (boost::compute::opencl_error& error) {
-        if (error.error_code() == CL_BUILD_PROGRAM_FAILURE) {
-            BOOST_LOG_TRIVIAL(error) << "OpenCL program build failure: " << program.build_log();
-        }
-        throw;
-    }
-}
+template <>
+const float VerificationTraits<float>::max_relative_error = 1e-5f;
+template <>
+const double VerificationTraits<double>::max_relative_error = 1e-12;
+
+constexpr const char* const kCompilerOptions = "-Werror";
 }  // namespace
 
 namespace kpv {
-template <>
-void CuboidOpenClFixture<float>::Initialize() {
-    GenerateData();
-    std::string compiler_options = kCompilerOptions;
-    compiler_options += " -DT=float";
-
-    auto program = BuildProgram(kProgramCode, device_->GetContext(), compiler_options);
+template <typename T>
+void CuboidOpenClFixture<T>::Initialize(const cl_benchmark::InitializationParams& params) {
+    InitializeDataset(params);
+    // Input is copied to host memory of the fixture once, so a device that uses host memory
+    // directly reads it without further copies
+    dimensions_ = cl_benchmark::HostBuffer<T>(3 * data_size_, host_allocation_);
+    std::copy(dataset_->dimensions.cbegin(), dataset_->dimensions.cend(), dimensions_.begin());
+    volume_buffer_ = cl_benchmark::HostBuffer<T>(data_size_, host_allocation_);
+    surface_buffer_ = cl_benchmark::HostBuffer<T>(data_size_, host_allocation_);
+    // Program is usually built in background already
+    auto program = params.program_cache->Get(GetProgramSource());
     kernel_ = program.create_kernel("CuboidVolumesAndSurfaces");
 }
 
-template <>
-void CuboidOpenClFixture<double>::Initialize() {
-    GenerateData();
-    std::string compiler_options = kCompilerOptions;
-    compiler_options += " -DT=double";
+template <typename T>
+std::vector<cl_benchmark::ProgramSource> CuboidOpenClFixture<T>::GetProgramSources() {
+    return {GetProgramSource()};
+}
 
-    std::string source = R"(
-#if __OPENCL_VERSION__ <= CL_VERSION_1_1
-    #pragma OPENCL EXTENSION cl_khr_fp64 : enable
-#endif)";
-    source += kProgramCode;
-    auto program = BuildProgram(source, device_->GetContext(), compiler_options);
-    kernel_ = program.create_kernel("CuboidVolumesAndSurfaces");
+template <typename T>
+cl_benchmark::ProgramSource CuboidOpenClFixture<T>::GetProgramSource() {
+    cl_benchmark::ProgramSource result;
+    result.context = device_->GetContext();
+    result.source = std::string(OpenClTypeTraits<T>::source_prefix) + kProgramCode;
+    result.options = std::string(kCompilerOptions) + " -DT=" + OpenClTypeTraits<T>::type_name +
+                     " " + build_options_;
+    return result;
 }
 
 template <typename T>
@@ -106,82 +109,146 @@ kpv::cl_benchmark::EventList CuboidOpenClFixture<T>::Execute(
 
     kpv::cl_benchmark::EventList event_list;
 
-    // create a vector on the device
-    boost::compute::vector<T> input_device_vector(3 * data_size_, context);
-    boost::compute::vector<T> output_volumes_vector(data_size_, context);
-    boost::compute::vector<T> output_surfaces_vector(data_size_, context);
+    // Create buffers on the device, they are backed by host buffers with CL_MEM_USE_HOST_PTR
+    boost::compute::buffer input_buffer = dimensions_.CreateDeviceBuffer(context);
+    boost::compute::buffer output_volumes_buffer = volume_buffer_.CreateDeviceBuffer(context);
+    boost::compute::buffer output_surfaces_buffer = surface_buffer_.CreateDeviceBuffer(context);
 
     // Map input data, copy them and unmap
     {
         boost::compute::event event;  // Mapping is blocking
         void* input_ptr = queue.enqueue_map_buffer(
-            input_device_vector.get_buffer(), CL_MAP_READ, 0,
-            input_device_vector.size() * sizeof(T), event);
+            input_buffer, CL_MAP_WRITE, 0, dimensions_.size() * sizeof(T), event);
         event_list.AddOpenClEvent("Map input data", event);
 
         T* input_ptr_casted = reinterpret_cast<T*>(input_ptr);
         // TODO include time spent on this, needs host timer
-        std::copy(std::cbegin(dimensions_), std::cend(dimensions_), input_ptr_casted);
+        // Data are already in place if a device maps host memory of the fixture itself
+        if (input_ptr_casted != dimensions_.data()) {
+            std::copy(dimensions_.begin(), dimensions_.end(), input_ptr_casted);
+        }
 
         event_list.AddOpenClEvent(
-            "Unmap input data",
-            queue.enqueue_unmap_buffer(input_device_vector.get_buffer(), input_ptr));
+            "Unmap input data", queue.enqueue_unmap_buffer(input_buffer, input_ptr));
     }
 
-    kernel_.set_arg(0, input_device_vector);
-    kernel_.set_arg(1, output_volumes_vector);
-    kernel_.set_arg(2, output_surfaces_vector);
+    kernel_.set_arg(0, input_buffer);
+    kernel_.set_arg(1, output_volumes_buffer);
+    kernel_.set_arg(2, output_surfaces_buffer);
 
-    event_list.AddOpenClEvent(
-        "Calculating", queue.enqueue_1d_range_kernel(kernel_, 0, data_size_, 0));
+    // Kernel overwrites its output, so it may be launched several times in a row
+    boost::compute::event first_launch = queue.enqueue_1d_range_kernel(kernel_, 0, data_size_, 0);
+    boost::compute::event last_launch = first_launch;
+    for (int i = 1; i < params.launch_count; ++i) {
+        last_launch = queue.enqueue_1d_range_kernel(kernel_, 0, data_size_, 0);
+    }
+    event_list.AddOpenClEventBatch("Calculating", first_launch, last_launch, params.launch_count);
 
     // Map volumes data, copy them and unmap
     {
         boost::compute::event event;  // Mapping is blocking
         void* ptr = queue.enqueue_map_buffer(
-            output_volumes_vector.get_buffer(), CL_MAP_WRITE, 0, data_size_ * sizeof(T), event);
+            output_volumes_buffer, CL_MAP_READ, 0, data_size_ * sizeof(T), event);
         event_list.AddOpenClEvent("Map output volume data", event);
 
         const T* ptr_casted = reinterpret_cast<const T*>(ptr);
         // TODO include time spent on this, needs host timer
-        volumes_.reserve(data_size_);
-        std::copy_n(ptr_casted, data_size_, std::back_inserter(volumes_));
+        volumes_.resize(data_size_);
+        std::copy_n(ptr_casted, data_size_, volumes_.begin());
 
         event_list.AddOpenClEvent(
             "Unmap output volume data",
-            queue.enqueue_unmap_buffer(output_volumes_vector.get_buffer(), ptr));
+            queue.enqueue_unmap_buffer(output_volumes_buffer, ptr));
     }
     // Map surface buffer, copy them and unmap
     {
         boost::compute::event event;  // Mapping is blocking
         void* ptr = queue.enqueue_map_buffer(
-            output_surfaces_vector.get_buffer(), CL_MAP_WRITE, 0, data_size_ * sizeof(T), event);
+            output_surfaces_buffer, CL_MAP_READ, 0, data_size_ * sizeof(T), event);
         event_list.AddOpenClEvent("Map output surface data", event);
 
         const T* ptr_casted = reinterpret_cast<const T*>(ptr);
         // TODO include time spent on this, needs host timer
-        surfaces_.reserve(data_size_);
-        std::copy_n(ptr_casted, data_size_, std::back_inserter(surfaces_));
+        surfaces_.resize(data_size_);
+        std::copy_n(ptr_casted, data_size_, surfaces_.begin());
 
         event_list.AddOpenClEvent(
             "Unmap output surface data",
-            queue.enqueue_unmap_buffer(output_surfaces_vector.get_buffer(), ptr));
+            queue.enqueue_unmap_buffer(output_surfaces_buffer, ptr));
     }
 
     return event_list;
 }
 
 template <typename T>
-void CuboidOpenClFixture<T>::GenerateData() {
-    std::random_device random_dev;
-    std::mt19937 gen(random_dev());
-    std::uniform_real_distribution<T> uniform_dist(min_len, max_len);
+void CuboidOpenClFixture<T>::VerifyResults() {
+    const T max_relative_error = VerificationTraits<T>::max_relative_error;
+    const bool is_build_variant = !build_options_.empty();
+    cl_benchmark::ResultAccuracy accuracy;
+    double error_sum = 0.0;
+    std::size_t value_count = 0;
+    auto verify = [&](const std::vector<T>& actual, const std::vector<T>& expected,
+                      const char* value_name) {
+        if (actual.size() != expected.size()) {
+            throw std::runtime_error(
+                (boost::format("Result verification has failed for cuboid fixture. "
+                               "Count of %1% is another from expected one.") %
+                 value_name)
+                    .str());
+        }
+        for (std::size_t i = 0; i < actual.size(); ++i) {
+            T relative_error = std::abs(actual[i] - expected[i]) / std::abs(expected[i]);
+            if (!(relative_error <= max_relative_error) && !is_build_variant) {
+                throw std::runtime_error(
+                    (boost::format("Result verification has failed for cuboid fixture. "
+                                   "Relative error of %1% is %2% for cuboid %3% "
+                                   "(maximum allowed is %4%).") %
+                     value_name % relative_error % i % max_relative_error)
+                        .str());
+            }
+            // NaN is propagated, so broken results of a variant are visible in the report
+            if (std::isnan(relative_error) || relative_error > accuracy.max_relative_error) {
+                accuracy.max_relative_error = relative_error;
+            }
+            error_sum += relative_error;
+            ++value_count;
+        }
+    };
+    verify(volumes_, dataset_->expected_volumes, "volumes");
+    verify(surfaces_, dataset_->expected_surfaces, "surfaces");
+    if (value_count > 0) {
+        accuracy.mean_relative_error = error_sum / value_count;
+    }
+    accuracy_ = accuracy;
+}
+
+template <typename T>
+void CuboidOpenClFixture<T>::InitializeDataset(const cl_benchmark::InitializationParams& params) {
+    dataset_ = params.dataset_cache->GetOrCreate<Dataset>(
+        (boost::format("Cuboid, %1% bytes per value, %2% cuboids") % sizeof(T) % data_size_).str(),
+        [this, &params]() { return GenerateData(params.data_generator); });
+}
 
+template <typename T>
+typename CuboidOpenClFixture<T>::Dataset CuboidOpenClFixture<T>::GenerateData(
+    const cl_benchmark::DataGenerator& generator) {
+    Dataset dataset;
     // data_size_ is amount of cuboids (i.e. triples of dimensions), so amount of values is 3 times
     // bigger
     int val_count = data_size_ * 3;
-    dimensions_.resize(val_count);
-    std::generate_n(
-        dimensions_.begin(), val_count, [&gen, &uniform_dist]() { return uniform_dist(gen); });
+    dataset.dimensions.resize(val_count);
+    generator.FillUniformReal(dataset.dimensions, min_len, max_len, "Cuboid dimensions");
+
+    // Expected results are calculated in double precision
+    dataset.expected_volumes.resize(data_size_);
+    dataset.expected_surfaces.resize(data_size_);
+    for (int i = 0; i < data_size_; ++i) {
+        const double a = dataset.dimensions[3 * i];
+        const double b = dataset.dimensions[3 * i + 1];
+        const double c = dataset.dimensions[3 * i + 2];
+        dataset.expected_volumes[i] = static_cast<T>(a * b * c);
+        dataset.expected_surfaces[i] = static_cast<T>(2 * (a * b + b * c + a * c));
+    }
+    return dataset;
 }
 }  // namespace kpv
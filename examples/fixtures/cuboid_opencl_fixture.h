@@ -2,6 +2,7 @@
 #define EXAMPLES_FIXTURES_CUBOID_OPENCL_FIXTURE_H_
 
 #include <memory>
+#include <string>
 
 #include "cl_benchmark.hpp"
 
@@ -9,29 +10,75 @@ namespace kpv {
 template <typename T>
 class CuboidOpenClFixture final : public cl_benchmark::Fixture {
 public:
-    // data_size is amount of cuboids that are processed
-    CuboidOpenClFixture(const std::shared_ptr<cl_benchmark::OpenClDevice>& device, int data_size)
-        : device_(device), data_size_(data_size) {}
+    // data_size is amount of cuboids that are processed, build_options are appended to default
+    // options of the program. Input and output data are kept in host buffers allocated with
+    // host_allocation, device buffers are created over them if it requests CL_MEM_USE_HOST_PTR
+    CuboidOpenClFixture(
+        const std::shared_ptr<cl_benchmark::OpenClDevice>& device, int data_size,
+        const std::string& build_options = std::string(),
+        const cl_benchmark::HostAllocationStrategy& host_allocation =
+            cl_benchmark::HostAllocationStrategy())
+        : data_size_(data_size),
+          build_options_(build_options),
+          host_allocation_(host_allocation),
+          device_(device) {}
 
     std::vector<std::string> GetRequiredExtensions() override;
 
-    virtual void Initialize() override;
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
 
     kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
 
+    virtual void VerifyResults() override;
+
+    virtual bool SupportsBatching() override { return true; }
+
+    virtual std::shared_ptr<cl_benchmark::Fixture> CreateBuildVariant(
+        const std::string& build_options) override {
+        return std::make_shared<CuboidOpenClFixture<T>>(
+            device_, data_size_, build_options_ + " " + build_options, host_allocation_);
+    }
+
+    virtual boost::optional<cl_benchmark::ResultAccuracy> GetResultAccuracy() override {
+        return accuracy_;
+    }
+
+    virtual boost::optional<cl_benchmark::HostAllocationStrategy> GetHostAllocation() override {
+        return dimensions_.strategy();
+    }
+
     virtual ~CuboidOpenClFixture() noexcept {}
 
 private:
+    // Input data and expected results, shared by fixtures on all devices
+    struct Dataset {
+        std::vector<T> dimensions;
+        std::vector<T> expected_volumes;
+        std::vector<T> expected_surfaces;
+    };
+
     const int data_size_;
-    std::vector<T> dimensions_;
+    // Results of a program built with non-default options are not required to be within
+    // the tolerance, their error is reported instead
+    const std::string build_options_;
+    const cl_benchmark::HostAllocationStrategy host_allocation_;
+    boost::optional<cl_benchmark::ResultAccuracy> accuracy_;
+    std::shared_ptr<const Dataset> dataset_;
     std::vector<T> volumes_;
     std::vector<T> surfaces_;
+    cl_benchmark::HostBuffer<T> dimensions_;
+    cl_benchmark::HostBuffer<T> volume_buffer_;
+    cl_benchmark::HostBuffer<T> surface_buffer_;
     boost::compute::kernel kernel_;
     const std::shared_ptr<cl_benchmark::OpenClDevice> device_;
     static constexpr T min_len = static_cast<T>(1e-6);  // Minimum value used for all dimensions
     static constexpr T max_len = static_cast<T>(1e6);   // Maximum value used for all dimensions
 
-    void GenerateData();
+    void InitializeDataset(const cl_benchmark::InitializationParams& params);
+    cl_benchmark::ProgramSource GetProgramSource();
+    Dataset GenerateData(const cl_benchmark::DataGenerator& generator);
 };
 
 template class CuboidOpenClFixture<float>;
@@ -0,0 +1,115 @@
+#include "factorial_common.h"
+
+#include <boost/format.hpp>
+#include <unordered_map>
+
+namespace {
+const char* kProgramCode = R"(
+ulong FactorialImplementation(int val)
+{
+    ulong result = 1;
+    for(int i = 1; i <= val; i++)
+    {
+        result *= i;
+    }
+    return result;
+}
+
+__kernel void TrivialFactorial(__global int* input, __global ulong* output)
+{
+    size_t id = get_global_id(0);
+    output[id] = FactorialImplementation(input[id]);
+}
+)";
+
+constexpr const char* const kCompilerOptions = "-Werror";
+
+const std::unordered_map<cl_int, cl_ulong> kCorrectFactorialValues = {
+    {0, 1ull},
+    {1, 1ull},
+    {2, 2ull},
+    {3, 6ull},
+    {4, 24ull},
+    {5, 120ull},
+    {6, 720ull},
+    {7, 5040ull},
+    {8, 40320ull},
+    {9, 362880ull},
+    {10, 3628800ull},
+    {11, 39916800ull},
+    {12, 479001600ull},
+    {13, 6227020800ull},
+    {14, 87178291200ull},
+    {15, 1307674368000ull},
+    {16, 20922789888000ull},
+    {17, 355687428096000ull},
+    {18, 6402373705728000ull},
+    {19, 121645100408832000ull},
+    {20, 2432902008176640000ull},
+};
+
+kpv::FactorialDataset GenerateData(
+    const kpv::cl_benchmark::DataGenerator& generator, int data_size) {
+    const cl_int min_input_val = 0;
+    const cl_int max_input_val =
+        20;  // Max value whose factorial fits into 64-bit unsigned integer number.
+
+    kpv::FactorialDataset dataset;
+    dataset.input_data.resize(data_size);
+    generator.FillUniformInt(dataset.input_data, min_input_val, max_input_val, "Factorial input");
+
+    dataset.expected_output_data.reserve(data_size);
+    std::transform(
+        dataset.input_data.cbegin(), dataset.input_data.cend(),
+        std::back_inserter(dataset.expected_output_data),
+        [](cl_int i) { return kCorrectFactorialValues.at(i); });
+    return dataset;
+}
+}  // namespace
+
+namespace kpv {
+std::shared_ptr<const FactorialDataset> GetFactorialDataset(
+    const cl_benchmark::InitializationParams& params, int data_size) {
+    return params.dataset_cache->GetOrCreate<FactorialDataset>(
+        (boost::format("Factorial, %1% elements") % data_size).str(),
+        [&params, data_size]() { return GenerateData(params.data_generator, data_size); });
+}
+
+const char* const kFactorialKernelName = "TrivialFactorial";
+
+cl_benchmark::ProgramSource GetFactorialProgramSource(const boost::compute::context& context) {
+    return cl_benchmark::ProgramSource{context, kProgramCode, kCompilerOptions};
+}
+
+boost::compute::program BuildFactorialProgram(
+    const cl_benchmark::InitializationParams& params, const boost::compute::context& context) {
+    return params.program_cache->Get(GetFactorialProgramSource(context));
+}
+
+boost::compute::kernel BuildFactorialKernel(
+    const cl_benchmark::InitializationParams& params, const boost::compute::context& context) {
+    return BuildFactorialProgram(params, context).create_kernel(kFactorialKernelName);
+}
+
+void VerifyFactorialResults(
+    const std::vector<cl_ulong>& output_data, const FactorialDataset& dataset) {
+    const std::vector<cl_ulong>& expected_output_data = dataset.expected_output_data;
+    if (output_data.size() != expected_output_data.size()) {
+        throw std::runtime_error(
+            "Result verification has failed for factorial fixture . "
+            "Output data count is another from expected one.");
+    }
+    auto mismatched_values = std::mismatch(
+        output_data.cbegin(), output_data.cend(), expected_output_data.cbegin(),
+        expected_output_data.cend());
+    if (mismatched_values.first != output_data.cend()) {
+        cl_ulong max_abs_error = *mismatched_values.first - *mismatched_values.second;
+        throw std::runtime_error(
+            (boost::format("Result verification has failed for trivial factorial fixture. "
+                           "Maximum absolute error is %1% for input value %2% "
+                           "(exact equality is expected).") %
+             max_abs_error % *mismatched_values.first)
+                .str());
+    }
+}
+}  // namespace kpv
@@ -0,0 +1,34 @@
+#ifndef EXAMPLES_FIXTURES_FACTORIAL_COMMON_H_
+#define EXAMPLES_FIXTURES_FACTORIAL_COMMON_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+
+namespace kpv {
+// Input data and expected results, shared by all factorial fixtures of one family
+struct FactorialDataset {
+    std::vector<cl_int> input_data;
+    std::vector<cl_ulong> expected_output_data;
+};
+
+std::shared_ptr<const FactorialDataset> GetFactorialDataset(
+    const cl_benchmark::InitializationParams& params, int data_size);
+
+cl_benchmark::ProgramSource GetFactorialProgramSource(const boost::compute::context& context);
+
+// Program is taken from a program cache of a run, so it is built once for every context
+boost::compute::program BuildFactorialProgram(
+    const cl_benchmark::InitializationParams& params, const boost::compute::context& context);
+
+boost::compute::kernel BuildFactorialKernel(
+    const cl_benchmark::InitializationParams& params, const boost::compute::context& context);
+
+extern const char* const kFactorialKernelName;
+
+void VerifyFactorialResults(
+    const std::vector<cl_ulong>& output_data, const FactorialDataset& dataset);
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_FACTORIAL_COMMON_H_
@@ -0,0 +1,121 @@
+#include "factorial_multi_device_fixture.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+// Every device processes this amount of chunks on average in dynamic mode
+constexpr int kChunksPerDevice = 8;
+}  // namespace
+
+namespace kpv {
+FactorialMultiDeviceFixture::FactorialMultiDeviceFixture(
+    const std::shared_ptr<cl_benchmark::DeviceGroup>& device_group, int data_size,
+    cl_benchmark::PartitionStrategy strategy)
+    : data_size_(data_size), strategy_(strategy), device_group_(device_group) {}
+
+void FactorialMultiDeviceFixture::Initialize(const cl_benchmark::InitializationParams& params) {
+    dataset_ = GetFactorialDataset(params, data_size_);
+    output_data_.resize(data_size_);
+
+    std::vector<std::shared_ptr<cl_benchmark::OpenClDevice>> devices =
+        device_group_->DevicesAs<cl_benchmark::OpenClDevice>();
+    const std::size_t device_count = devices.size();
+    chunk_size_ = std::max<std::size_t>(data_size_ / (device_count * kChunksPerDevice), 1);
+    // Dynamic mode needs buffers for one chunk only, other modes may process all data on one
+    // device (at least during speed measurement)
+    const std::size_t capacity = (strategy_ == cl_benchmark::PartitionStrategy::kDynamic)
+                                     ? std::min<std::size_t>(chunk_size_, data_size_)
+                                     : data_size_;
+    for (auto& device : devices) {
+        DeviceData data;
+        data.device = device;
+        data.kernel = BuildFactorialKernel(params, device->GetContext());
+        data.input = boost::compute::vector<cl_int>(capacity, device->GetContext());
+        data.output = boost::compute::vector<cl_ulong>(capacity, device->GetContext());
+        data.kernel.set_arg(0, data.input);
+        data.kernel.set_arg(1, data.output);
+        device_data_.push_back(std::move(data));
+    }
+    // Threads are not started inside of a timed region
+    thread_pool_ = std::make_unique<cl_benchmark::ThreadPool>(static_cast<int>(device_count), 1);
+
+    if (strategy_ == cl_benchmark::PartitionStrategy::kStatic) {
+        ranges_ = cl_benchmark::StaticPartition(data_size_, device_count);
+    } else if (strategy_ == cl_benchmark::PartitionStrategy::kProportional) {
+        ranges_ = cl_benchmark::ProportionalPartition(data_size_, MeasureDeviceSpeeds());
+    }
+}
+
+std::vector<cl_benchmark::ProgramSource> FactorialMultiDeviceFixture::GetProgramSources() {
+    std::vector<cl_benchmark::ProgramSource> result;
+    for (auto& device : device_group_->DevicesAs<cl_benchmark::OpenClDevice>()) {
+        result.push_back(GetFactorialProgramSource(device->GetContext()));
+    }
+    return result;
+}
+
+kpv::cl_benchmark::EventList FactorialMultiDeviceFixture::Execute(
+    const cl_benchmark::RuntimeParams& /*params*/) {
+    kpv::cl_benchmark::EventList event_list;
+    auto start = std::chrono::steady_clock::now();
+    if (strategy_ == cl_benchmark::PartitionStrategy::kDynamic) {
+        cl_benchmark::DynamicPartitioner partitioner(data_size_, chunk_size_);
+        thread_pool_->ParallelFor(
+            device_data_.size(), 1, [this, &partitioner](std::size_t device_index, std::size_t) {
+                cl_benchmark::WorkRange range;
+                while (partitioner.Next(range)) {
+                    ProcessRange(device_data_.at(device_index), range);
+                }
+            });
+    } else {
+        thread_pool_->ParallelFor(
+            device_data_.size(), 1, [this](std::size_t device_index, std::size_t) {
+                const cl_benchmark::WorkRange& range = ranges_.at(device_index);
+                if (range.size() > 0) {
+                    ProcessRange(device_data_.at(device_index), range);
+                }
+            });
+    }
+    auto finish = std::chrono::steady_clock::now();
+    event_list.AddHostEvent("Processing on all devices", cl_benchmark::Duration(finish - start));
+    return event_list;
+}
+
+void FactorialMultiDeviceFixture::VerifyResults() {
+    VerifyFactorialResults(output_data_, *dataset_);
+}
+
+void FactorialMultiDeviceFixture::ProcessRange(
+    DeviceData& device_data, const cl_benchmark::WorkRange& range) {
+    boost::compute::command_queue& queue = device_data.device->GetQueue();
+    boost::compute::copy(
+        dataset_->input_data.cbegin() + range.begin, dataset_->input_data.cbegin() + range.end,
+        device_data.input.begin(), queue);
+    queue.enqueue_1d_range_kernel(device_data.kernel, 0, range.size(), 0);
+    // Copying to a host is blocking, so the whole range is finished after it
+    boost::compute::copy(
+        device_data.output.begin(), device_data.output.begin() + range.size(),
+        output_data_.begin() + range.begin, queue);
+}
+
+std::vector<double> FactorialMultiDeviceFixture::MeasureDeviceSpeeds() {
+    // Every device processes all data alone twice, the first run is a warm-up
+    std::vector<double> speeds;
+    cl_benchmark::WorkRange full_range;
+    full_range.end = data_size_;
+    for (DeviceData& device_data : device_data_) {
+        ProcessRange(device_data, full_range);
+        auto start = std::chrono::steady_clock::now();
+        ProcessRange(device_data, full_range);
+        auto finish = std::chrono::steady_clock::now();
+        double seconds = std::chrono::duration<double>(finish - start).count();
+        speeds.push_back(seconds > 0.0 ? data_size_ / seconds : 0.0);
+    }
+    // Fall back to equal parts if no device was measurable
+    if (std::all_of(speeds.cbegin(), speeds.cend(), [](double s) { return s == 0.0; })) {
+        std::fill(speeds.begin(), speeds.end(), 1.0);
+    }
+    return speeds;
+}
+}  // namespace kpv
@@ -0,0 +1,57 @@
+#ifndef EXAMPLES_FIXTURES_FACTORIAL_MULTI_DEVICE_FIXTURE_H_
+#define EXAMPLES_FIXTURES_FACTORIAL_MULTI_DEVICE_FIXTURE_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+#include "factorial_common.h"
+
+namespace kpv {
+/*
+Factorial fixture that splits its input between all devices of a device group and processes
+parts on every device simultaneously (one host thread per device, threads are started once and
+live across iterations).
+Time is measured on a host from the first submitted command to the last finished one. A group with
+a single device runs the same code, so it is a baseline for a group of several devices.
+*/
+class FactorialMultiDeviceFixture final : public cl_benchmark::Fixture {
+public:
+    FactorialMultiDeviceFixture(
+        const std::shared_ptr<cl_benchmark::DeviceGroup>& device_group, int data_size,
+        cl_benchmark::PartitionStrategy strategy);
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
+
+    kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
+
+    virtual void VerifyResults() override;
+
+    virtual ~FactorialMultiDeviceFixture() noexcept {}
+
+private:
+    struct DeviceData {
+        std::shared_ptr<cl_benchmark::OpenClDevice> device;
+        boost::compute::kernel kernel;
+        boost::compute::vector<cl_int> input;
+        boost::compute::vector<cl_ulong> output;
+    };
+
+    const int data_size_;
+    const cl_benchmark::PartitionStrategy strategy_;
+    std::shared_ptr<const FactorialDataset> dataset_;
+    std::vector<cl_ulong> output_data_;
+    std::vector<DeviceData> device_data_;
+    std::vector<cl_benchmark::WorkRange> ranges_;  // Work of every device (static modes only)
+    std::size_t chunk_size_ = 1;                   // Size of a work chunk (dynamic mode only)
+    const std::shared_ptr<cl_benchmark::DeviceGroup> device_group_;
+    std::unique_ptr<cl_benchmark::ThreadPool> thread_pool_;  // A thread per device
+
+    void ProcessRange(DeviceData& device_data, const cl_benchmark::WorkRange& range);
+    std::vector<double> MeasureDeviceSpeeds();
+};
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_FACTORIAL_MULTI_DEVICE_FIXTURE_H_
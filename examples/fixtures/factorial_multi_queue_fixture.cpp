@@ -0,0 +1,78 @@
+#include "factorial_multi_queue_fixture.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace kpv {
+FactorialMultiQueueFixture::FactorialMultiQueueFixture(
+    const std::shared_ptr<cl_benchmark::OpenClDevice>& device, int data_size, int queue_count)
+    : data_size_(data_size), queue_count_(queue_count), device_(device) {
+    if (queue_count_ < 1) {
+        throw std::invalid_argument("Queue count must be positive.");
+    }
+}
+
+void FactorialMultiQueueFixture::Initialize(const cl_benchmark::InitializationParams& params) {
+    dataset_ = GetFactorialDataset(params, data_size_);
+    output_data_.resize(data_size_);
+
+    boost::compute::context& context = device_->GetContext();
+    boost::compute::program program = BuildFactorialProgram(params, context);
+    std::vector<cl_benchmark::WorkRange> ranges =
+        cl_benchmark::StaticPartition(data_size_, queue_count_);
+    for (int i = 0; i < queue_count_; ++i) {
+        QueueData data;
+        data.queue = device_->GetQueue(i);
+        // Kernel arguments are set separately for every queue, so every queue needs own kernel
+        data.kernel = program.create_kernel(kFactorialKernelName);
+        data.range = ranges.at(i);
+        // Empty buffers are not allowed
+        std::size_t buffer_size = std::max<std::size_t>(data.range.size(), 1);
+        data.input = boost::compute::vector<cl_int>(buffer_size, context);
+        data.output = boost::compute::vector<cl_ulong>(buffer_size, context);
+        data.kernel.set_arg(0, data.input);
+        data.kernel.set_arg(1, data.output);
+        queue_data_.push_back(std::move(data));
+    }
+}
+
+std::vector<cl_benchmark::ProgramSource> FactorialMultiQueueFixture::GetProgramSources() {
+    return {GetFactorialProgramSource(device_->GetContext())};
+}
+
+kpv::cl_benchmark::EventList FactorialMultiQueueFixture::Execute(
+    const cl_benchmark::RuntimeParams& /*params*/) {
+    std::vector<std::vector<boost::compute::event>> queue_events(queue_data_.size());
+    cl_benchmark::RunInParallel(queue_data_.size(), [this, &queue_events](std::size_t index) {
+        QueueData& data = queue_data_.at(index);
+        const cl_benchmark::WorkRange& range = data.range;
+        if (range.size() == 0) {
+            return;
+        }
+        std::vector<boost::compute::event>& events = queue_events.at(index);
+        events.push_back(boost::compute::copy_async(
+                             dataset_->input_data.cbegin() + range.begin,
+                             dataset_->input_data.cbegin() + range.end, data.input.begin(),
+                             data.queue)
+                             .get_event());
+        events.push_back(data.queue.enqueue_1d_range_kernel(data.kernel, 0, range.size(), 0));
+        events.push_back(boost::compute::copy_async(
+                             data.output.begin(), data.output.begin() + range.size(),
+                             output_data_.begin() + range.begin, data.queue)
+                             .get_event());
+        data.queue.flush();
+    });
+
+    std::vector<boost::compute::event> all_events;
+    for (auto& events : queue_events) {
+        all_events.insert(all_events.end(), events.begin(), events.end());
+    }
+    kpv::cl_benchmark::EventList event_list;
+    event_list.AddOpenClEventSpan("Processing on all queues", all_events);
+    return event_list;
+}
+
+void FactorialMultiQueueFixture::VerifyResults() {
+    VerifyFactorialResults(output_data_, *dataset_);
+}
+}  // namespace kpv
@@ -0,0 +1,52 @@
+#ifndef EXAMPLES_FIXTURES_FACTORIAL_MULTI_QUEUE_FIXTURE_H_
+#define EXAMPLES_FIXTURES_FACTORIAL_MULTI_QUEUE_FIXTURE_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+#include "factorial_common.h"
+
+namespace kpv {
+/*
+Factorial fixture that splits its input between several command queues of one device.
+Work is submitted to every queue from its own host thread, like a server that handles requests
+on several threads. Duration covers all queues from the first start to the last end.
+*/
+class FactorialMultiQueueFixture final : public cl_benchmark::Fixture {
+public:
+    FactorialMultiQueueFixture(
+        const std::shared_ptr<cl_benchmark::OpenClDevice>& device, int data_size,
+        int queue_count);
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
+
+    kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
+
+    virtual void VerifyResults() override;
+
+    virtual int QueueCount() override { return queue_count_; }
+
+    virtual ~FactorialMultiQueueFixture() noexcept {}
+
+private:
+    struct QueueData {
+        boost::compute::command_queue queue;
+        boost::compute::kernel kernel;
+        cl_benchmark::WorkRange range;
+        boost::compute::vector<cl_int> input;
+        boost::compute::vector<cl_ulong> output;
+    };
+
+    const int data_size_;
+    const int queue_count_;
+    std::shared_ptr<const FactorialDataset> dataset_;
+    std::vector<cl_ulong> output_data_;
+    std::vector<QueueData> queue_data_;
+    const std::shared_ptr<cl_benchmark::OpenClDevice> device_;
+};
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_FACTORIAL_MULTI_QUEUE_FIXTURE_H_
@@ -3,6 +3,7 @@
 #include <memory>
 
 #include "cl_benchmark.hpp"
+#include "factorial_common.h"
 
 namespace kpv {
 class FactorialOpenClFixture final : public cl_benchmark::Fixture {
@@ -10,24 +11,24 @@ public:
     FactorialOpenClFixture(
         const std::shared_ptr<cl_benchmark::OpenClDevice>& device, int data_size);
 
-    virtual void Initialize() override;
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
 
     kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
 
     virtual void VerifyResults() override;
 
+    virtual bool SupportsBatching() override { return true; }
+
     virtual ~FactorialOpenClFixture() noexcept {}
 
 private:
     const int data_size_;
-    std::vector<cl_int> input_data_;
-    std::vector<cl_ulong> expected_output_data_;
+    std::shared_ptr<const FactorialDataset> dataset_;
     std::vector<cl_ulong> output_data_;
     boost::compute::kernel kernel_;
     const std::shared_ptr<cl_benchmark::OpenClDevice> device_;
-    static const std::unordered_map<cl_int, cl_ulong> correct_factorial_values_;
-
-    void GenerateData();
 };
 
 }  // namespace kpv
@@ -0,0 +1,41 @@
+#include "primitive_host_fixture.h"
+
+#include <chrono>
+
+namespace kpv {
+template <typename T>
+void PrimitiveHostFixture<T>::Initialize(const cl_benchmark::InitializationParams& params) {
+    dataset_ = GetPrimitiveDataset<T>(params, primitive_, data_size_);
+    output_data_.resize(primitive_ == Primitive::kReduce ? 1 : data_size_);
+}
+
+template <typename T>
+kpv::cl_benchmark::EventList PrimitiveHostFixture<T>::Execute(
+    const cl_benchmark::RuntimeParams& /*params*/) {
+    kpv::cl_benchmark::EventList event_list;
+    cl_benchmark::ThreadPool& pool = device_->thread_pool();
+    auto start = std::chrono::steady_clock::now();
+    switch (primitive_) {
+    case Primitive::kReduce:
+        HostParallelReduce(dataset_->input, output_data_, pool);
+        break;
+    case Primitive::kInclusiveScan:
+        HostParallelInclusiveScan(dataset_->input, output_data_, pool);
+        break;
+    case Primitive::kSort:
+        HostParallelSort(dataset_->input, output_data_, pool);
+        break;
+    }
+    auto finish = std::chrono::steady_clock::now();
+    event_list.AddHostEvent("Calculating", cl_benchmark::Duration(finish - start));
+    return event_list;
+}
+
+template <typename T>
+void PrimitiveHostFixture<T>::VerifyResults() {
+    VerifyPrimitiveResults(primitive_, output_data_, *dataset_);
+}
+
+template class PrimitiveHostFixture<cl_int>;
+template class PrimitiveHostFixture<float>;
+}  // namespace kpv
@@ -0,0 +1,40 @@
+#ifndef EXAMPLES_FIXTURES_PRIMITIVE_HOST_FIXTURE_H_
+#define EXAMPLES_FIXTURES_PRIMITIVE_HOST_FIXTURE_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+#include "primitives_common.h"
+
+namespace kpv {
+/*
+Reduction, inclusive scan or sort on a host processor, parallel loops run on a thread pool of
+a host device. It is a native baseline for OpenCL implementations of the same primitive.
+*/
+template <typename T>
+class PrimitiveHostFixture final : public cl_benchmark::Fixture {
+public:
+    PrimitiveHostFixture(
+        const std::shared_ptr<cl_benchmark::HostDevice>& device, Primitive primitive,
+        int data_size)
+        : device_(device), primitive_(primitive), data_size_(data_size) {}
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
+
+    virtual void VerifyResults() override;
+
+    virtual ~PrimitiveHostFixture() noexcept {}
+
+private:
+    const std::shared_ptr<cl_benchmark::HostDevice> device_;
+    const Primitive primitive_;
+    const int data_size_;
+    std::shared_ptr<const PrimitiveDataset<T>> dataset_;
+    std::vector<T> output_data_;
+};
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_PRIMITIVE_HOST_FIXTURE_H_
@@ -0,0 +1,378 @@
+#include "primitive_opencl_fixture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <string>
+
+namespace {
+const char* kProgramCode = R"(
+// Every work-item sums a strided part of input, then a work-group sums these values as a tree
+// in local memory. Sum of a work-group is written to output at the index of a group
+__kernel void ReduceGroups(
+    __global const T* input, uint count, __global T* output, __local T* scratch)
+{
+    const uint local_id = get_local_id(0);
+    T sum = 0;
+    for (uint i = get_global_id(0); i < count; i += get_global_size(0)) {
+        sum += input[i];
+    }
+    scratch[local_id] = sum;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint offset = get_local_size(0) / 2; offset > 0; offset /= 2) {
+        if (local_id < offset) {
+            scratch[local_id] += scratch[local_id + offset];
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    if (local_id == 0) {
+        output[get_group_id(0)] = scratch[0];
+    }
+}
+
+// Inclusive scan of every block of local size elements in local memory (Hillis-Steele with two
+// buffers), a total of every block is written to block_sums
+__kernel void ScanBlocks(
+    __global const T* input, uint count, __global T* output, __global T* block_sums,
+    __local T* scratch)
+{
+    const uint local_id = get_local_id(0);
+    const uint local_size = get_local_size(0);
+    const uint id = get_global_id(0);
+    __local T* current = scratch;
+    __local T* next = scratch + local_size;
+    current[local_id] = id < count ? input[id] : 0;
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint offset = 1; offset < local_size; offset *= 2) {
+        next[local_id] =
+            local_id >= offset ? current[local_id] + current[local_id - offset] : current[local_id];
+        barrier(CLK_LOCAL_MEM_FENCE);
+        __local T* temp = current;
+        current = next;
+        next = temp;
+    }
+    if (id < count) {
+        output[id] = current[local_id];
+    }
+    if (local_id == local_size - 1) {
+        block_sums[get_group_id(0)] = current[local_id];
+    }
+}
+
+// Add a total of all previous blocks to every element of a block
+__kernel void AddBlockOffsets(__global T* output, uint count, __global const T* scanned_block_sums)
+{
+    const uint id = get_global_id(0);
+    const uint group_id = get_group_id(0);
+    if (group_id > 0 && id < count) {
+        output[id] += scanned_block_sums[group_id - 1];
+    }
+}
+
+// One compare-exchange step of a bitonic sort with a stride that is not smaller than local size
+__kernel void BitonicStep(__global T* data, uint block, uint stride)
+{
+    const uint id = get_global_id(0);
+    const uint partner = id ^ stride;
+    if (partner > id) {
+        const T a = data[id];
+        const T b = data[partner];
+        const bool ascending = (id & block) == 0;
+        if ((a > b) == ascending) {
+            data[id] = b;
+            data[partner] = a;
+        }
+    }
+}
+
+// All remaining steps of a bitonic merge with strides smaller than local size, made in local
+// memory of a work-group
+__kernel void BitonicLocal(__global T* data, uint block, uint max_stride, __local T* scratch)
+{
+    const uint local_id = get_local_id(0);
+    const uint id = get_global_id(0);
+    const bool ascending = (id & block) == 0;
+    scratch[local_id] = data[id];
+    barrier(CLK_LOCAL_MEM_FENCE);
+    for (uint stride = max_stride; stride > 0; stride /= 2) {
+        const uint partner = local_id ^ stride;
+        if (partner > local_id) {
+            const T a = scratch[local_id];
+            const T b = scratch[partner];
+            if ((a > b) == ascending) {
+                scratch[local_id] = b;
+                scratch[partner] = a;
+            }
+        }
+        barrier(CLK_LOCAL_MEM_FENCE);
+    }
+    data[id] = scratch[local_id];
+}
+)";
+
+constexpr const char* const kCompilerOptions = "-Werror";
+
+// Upper limit of a work-group size, larger groups make local memory scans longer
+constexpr std::size_t kMaxWorkGroupSize = 256;
+
+template <typename T>
+struct OpenClTypeTraits {
+    static const char* const type_name;
+};
+
+template <>
+const char* const OpenClTypeTraits<cl_int>::type_name = "int";
+template <>
+const char* const OpenClTypeTraits<float>::type_name = "float";
+
+// Padding is sorted to the end of an array
+template <typename T>
+T PaddingValue() {
+    return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                                : std::numeric_limits<T>::max();
+}
+
+std::size_t FloorPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result * 2 <= value) {
+        result *= 2;
+    }
+    return result;
+}
+
+std::size_t CeilPowerOfTwo(std::size_t value) {
+    std::size_t result = 1;
+    while (result < value) {
+        result *= 2;
+    }
+    return result;
+}
+
+std::size_t CeilDiv(std::size_t value, std::size_t divisor) {
+    return (value + divisor - 1) / divisor;
+}
+}  // namespace
+
+namespace kpv {
+template <typename T>
+void PrimitiveOpenClFixture<T>::Initialize(const cl_benchmark::InitializationParams& params) {
+    dataset_ = GetPrimitiveDataset<T>(params, primitive_, data_size_);
+    output_data_.resize(primitive_ == Primitive::kReduce ? 1 : data_size_);
+
+    boost::compute::context& context = device_->GetContext();
+    const bool hand_written = implementation_ == PrimitiveImplementation::kHandWritten;
+    const std::size_t input_size = (primitive_ == Primitive::kSort && hand_written)
+                                       ? CeilPowerOfTwo(data_size_)
+                                       : static_cast<std::size_t>(data_size_);
+    input_ = boost::compute::vector<T>(input_size, context);
+    if (input_size > static_cast<std::size_t>(data_size_)) {
+        boost::compute::fill(
+            input_.begin() + data_size_, input_.end(), PaddingValue<T>(), device_->GetQueue());
+    }
+    if (hand_written) {
+        InitializeKernels(params);
+    }
+    if (primitive_ == Primitive::kInclusiveScan) {
+        output_ = boost::compute::vector<T>(data_size_, context);
+    } else if (primitive_ == Primitive::kReduce && hand_written) {
+        // Sums of work-groups
+        output_ = boost::compute::vector<T>(work_group_size_, context);
+    }
+}
+
+template <typename T>
+std::vector<cl_benchmark::ProgramSource> PrimitiveOpenClFixture<T>::GetProgramSources() {
+    std::vector<cl_benchmark::ProgramSource> result;
+    if (implementation_ == PrimitiveImplementation::kHandWritten) {
+        result.push_back(GetProgramSource());
+    }
+    return result;
+}
+
+template <typename T>
+kpv::cl_benchmark::EventList PrimitiveOpenClFixture<T>::Execute(
+    const cl_benchmark::RuntimeParams& /*params*/) {
+    boost::compute::command_queue& queue = device_->GetQueue();
+    kpv::cl_benchmark::EventList event_list;
+
+    event_list.AddOpenClEvent(
+        "Copying input data",
+        boost::compute::copy_async(
+            dataset_->input.cbegin(), dataset_->input.cend(), input_.begin(), queue));
+    queue.finish();
+
+    auto start = std::chrono::steady_clock::now();
+    Calculate(queue);
+    auto finish = std::chrono::steady_clock::now();
+    event_list.AddHostEvent("Calculating", cl_benchmark::Duration(finish - start));
+
+    // A sum is already read by Calculate()
+    if (primitive_ != Primitive::kReduce) {
+        const boost::compute::vector<T>& result =
+            (primitive_ == Primitive::kInclusiveScan) ? output_ : input_;
+        event_list.AddOpenClEvent(
+            "Copying output data",
+            boost::compute::copy_async(
+                result.begin(), result.begin() + data_size_, output_data_.begin(), queue));
+    }
+    return event_list;
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::VerifyResults() {
+    VerifyPrimitiveResults(primitive_, output_data_, *dataset_);
+}
+
+template <typename T>
+cl_benchmark::ProgramSource PrimitiveOpenClFixture<T>::GetProgramSource() {
+    cl_benchmark::ProgramSource result;
+    result.context = device_->GetContext();
+    result.source = kProgramCode;
+    result.options = std::string(kCompilerOptions) + " -DT=" + OpenClTypeTraits<T>::type_name;
+    return result;
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::InitializeKernels(
+    const cl_benchmark::InitializationParams& params) {
+    boost::compute::program program = params.program_cache->Get(GetProgramSource());
+    std::vector<boost::compute::kernel*> used_kernels;
+    switch (primitive_) {
+    case Primitive::kReduce:
+        reduce_kernel_ = program.create_kernel("ReduceGroups");
+        used_kernels = {&reduce_kernel_};
+        break;
+    case Primitive::kInclusiveScan:
+        scan_kernel_ = program.create_kernel("ScanBlocks");
+        add_offsets_kernel_ = program.create_kernel("AddBlockOffsets");
+        used_kernels = {&scan_kernel_, &add_offsets_kernel_};
+        break;
+    case Primitive::kSort:
+        bitonic_step_kernel_ = program.create_kernel("BitonicStep");
+        bitonic_local_kernel_ = program.create_kernel("BitonicLocal");
+        used_kernels = {&bitonic_step_kernel_, &bitonic_local_kernel_};
+        break;
+    }
+
+    // Trees in local memory need a power of two work-items
+    std::size_t max_size = std::min(kMaxWorkGroupSize, device_->device().max_work_group_size());
+    for (boost::compute::kernel* kernel : used_kernels) {
+        max_size = std::min(
+            max_size, kernel->get_work_group_info<std::size_t>(
+                          device_->device(), CL_KERNEL_WORK_GROUP_SIZE));
+    }
+    if (primitive_ == Primitive::kSort) {
+        max_size = std::min(max_size, input_.size());
+    }
+    work_group_size_ = FloorPowerOfTwo(max_size);
+
+    if (primitive_ == Primitive::kInclusiveScan) {
+        // Totals of blocks are scanned recursively until they fit into one block
+        std::size_t count = data_size_;
+        do {
+            count = CeilDiv(count, work_group_size_);
+            block_sums_.emplace_back(count, device_->GetContext());
+        } while (count > 1);
+    }
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::Calculate(boost::compute::command_queue& queue) {
+    if (implementation_ == PrimitiveImplementation::kBoostCompute) {
+        switch (primitive_) {
+        case Primitive::kReduce:
+            // Result is copied to a host, so the call is blocking
+            boost::compute::reduce(
+                input_.begin(), input_.begin() + data_size_, output_data_.data(), queue);
+            break;
+        case Primitive::kInclusiveScan:
+            boost::compute::inclusive_scan(
+                input_.begin(), input_.begin() + data_size_, output_.begin(), queue);
+            break;
+        case Primitive::kSort:
+            boost::compute::sort(input_.begin(), input_.begin() + data_size_, queue);
+            break;
+        }
+    } else {
+        switch (primitive_) {
+        case Primitive::kReduce:
+            ReduceWithKernels(queue);
+            break;
+        case Primitive::kInclusiveScan:
+            ScanWithKernels(queue, input_, data_size_, output_, 0);
+            break;
+        case Primitive::kSort:
+            SortWithKernels(queue);
+            break;
+        }
+    }
+    queue.finish();
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::ReduceWithKernels(boost::compute::command_queue& queue) {
+    const std::size_t local_size = work_group_size_;
+    // Sums of all groups are reduced by one group in the second pass
+    const std::size_t group_count = std::min(local_size, CeilDiv(data_size_, local_size));
+    reduce_kernel_.set_arg(0, input_.get_buffer());
+    reduce_kernel_.set_arg(1, static_cast<cl_uint>(data_size_));
+    reduce_kernel_.set_arg(2, output_.get_buffer());
+    reduce_kernel_.set_arg(3, boost::compute::local_buffer<T>(local_size));
+    queue.enqueue_1d_range_kernel(reduce_kernel_, 0, group_count * local_size, local_size);
+    if (group_count > 1) {
+        reduce_kernel_.set_arg(0, output_.get_buffer());
+        reduce_kernel_.set_arg(1, static_cast<cl_uint>(group_count));
+        queue.enqueue_1d_range_kernel(reduce_kernel_, 0, local_size, local_size);
+    }
+    queue.enqueue_read_buffer(output_.get_buffer(), 0, sizeof(T), output_data_.data());
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::ScanWithKernels(
+    boost::compute::command_queue& queue, const boost::compute::vector<T>& input,
+    std::size_t count, boost::compute::vector<T>& output, std::size_t level) {
+    const std::size_t local_size = work_group_size_;
+    const std::size_t group_count = CeilDiv(count, local_size);
+    boost::compute::vector<T>& block_sums = block_sums_.at(level);
+    scan_kernel_.set_arg(0, input.get_buffer());
+    scan_kernel_.set_arg(1, static_cast<cl_uint>(count));
+    scan_kernel_.set_arg(2, output.get_buffer());
+    scan_kernel_.set_arg(3, block_sums.get_buffer());
+    scan_kernel_.set_arg(4, boost::compute::local_buffer<T>(2 * local_size));
+    queue.enqueue_1d_range_kernel(scan_kernel_, 0, group_count * local_size, local_size);
+    if (group_count > 1) {
+        // Every group reads its block before writing it, so totals are scanned in place
+        ScanWithKernels(queue, block_sums, group_count, block_sums, level + 1);
+        add_offsets_kernel_.set_arg(0, output.get_buffer());
+        add_offsets_kernel_.set_arg(1, static_cast<cl_uint>(count));
+        add_offsets_kernel_.set_arg(2, block_sums.get_buffer());
+        queue.enqueue_1d_range_kernel(
+            add_offsets_kernel_, 0, group_count * local_size, local_size);
+    }
+}
+
+template <typename T>
+void PrimitiveOpenClFixture<T>::SortWithKernels(boost::compute::command_queue& queue) {
+    const std::size_t size = input_.size();
+    const std::size_t local_size = work_group_size_;
+    for (std::size_t block = 2; block <= size; block *= 2) {
+        std::size_t stride = block / 2;
+        for (; stride >= local_size; stride /= 2) {
+            bitonic_step_kernel_.set_arg(0, input_.get_buffer());
+            bitonic_step_kernel_.set_arg(1, static_cast<cl_uint>(block));
+            bitonic_step_kernel_.set_arg(2, static_cast<cl_uint>(stride));
+            queue.enqueue_1d_range_kernel(bitonic_step_kernel_, 0, size, local_size);
+        }
+        if (stride > 0) {
+            bitonic_local_kernel_.set_arg(0, input_.get_buffer());
+            bitonic_local_kernel_.set_arg(1, static_cast<cl_uint>(block));
+            bitonic_local_kernel_.set_arg(2, static_cast<cl_uint>(stride));
+            bitonic_local_kernel_.set_arg(3, boost::compute::local_buffer<T>(local_size));
+            queue.enqueue_1d_range_kernel(bitonic_local_kernel_, 0, size, local_size);
+        }
+    }
+}
+
+template class PrimitiveOpenClFixture<cl_int>;
+template class PrimitiveOpenClFixture<float>;
+}  // namespace kpv
@@ -0,0 +1,72 @@
+#ifndef EXAMPLES_FIXTURES_PRIMITIVE_OPENCL_FIXTURE_H_
+#define EXAMPLES_FIXTURES_PRIMITIVE_OPENCL_FIXTURE_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+#include "primitives_common.h"
+
+namespace kpv {
+enum class PrimitiveImplementation {
+    kBoostCompute,  // Algorithms of Boost.Compute
+    kHandWritten    // Work-group kernels with local memory, see primitive_opencl_fixture.cpp
+};
+
+/*
+Reduction, inclusive scan or sort on an OpenCL device. "Calculating" step is measured on a host
+from an empty queue until the result is ready, since Boost.Compute algorithms don't return
+events. Input is copied to a device in every iteration, because a sort overwrites it.
+*/
+template <typename T>
+class PrimitiveOpenClFixture final : public cl_benchmark::Fixture {
+public:
+    PrimitiveOpenClFixture(
+        const std::shared_ptr<cl_benchmark::OpenClDevice>& device, Primitive primitive,
+        PrimitiveImplementation implementation, int data_size)
+        : device_(device),
+          primitive_(primitive),
+          implementation_(implementation),
+          data_size_(data_size) {}
+
+    virtual void Initialize(const cl_benchmark::InitializationParams& params) override;
+
+    std::vector<cl_benchmark::ProgramSource> GetProgramSources() override;
+
+    kpv::cl_benchmark::EventList Execute(const cl_benchmark::RuntimeParams& params) override;
+
+    virtual void VerifyResults() override;
+
+    virtual ~PrimitiveOpenClFixture() noexcept {}
+
+private:
+    const std::shared_ptr<cl_benchmark::OpenClDevice> device_;
+    const Primitive primitive_;
+    const PrimitiveImplementation implementation_;
+    const int data_size_;
+    std::shared_ptr<const PrimitiveDataset<T>> dataset_;
+    std::vector<T> output_data_;
+    // Sort input is padded with maximum values to a power of two for a bitonic sort
+    boost::compute::vector<T> input_;
+    boost::compute::vector<T> output_;
+    // Hand-written kernels only
+    std::size_t work_group_size_ = 1;
+    boost::compute::kernel reduce_kernel_;
+    boost::compute::kernel scan_kernel_;
+    boost::compute::kernel add_offsets_kernel_;
+    boost::compute::kernel bitonic_step_kernel_;
+    boost::compute::kernel bitonic_local_kernel_;
+    std::vector<boost::compute::vector<T>> block_sums_;  // Scan of every level of blocks
+
+    cl_benchmark::ProgramSource GetProgramSource();
+    void InitializeKernels(const cl_benchmark::InitializationParams& params);
+    void Calculate(boost::compute::command_queue& queue);
+    void ReduceWithKernels(boost::compute::command_queue& queue);
+    void ScanWithKernels(
+        boost::compute::command_queue& queue, const boost::compute::vector<T>& input,
+        std::size_t count, boost::compute::vector<T>& output, std::size_t level);
+    void SortWithKernels(boost::compute::command_queue& queue);
+};
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_PRIMITIVE_OPENCL_FIXTURE_H_
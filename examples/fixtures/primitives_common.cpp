@@ -0,0 +1,217 @@
+#include "primitives_common.h"
+
+#include <algorithm>
+#include <boost/format.hpp>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+namespace {
+template <typename T>
+struct PrimitiveTypeTraits;
+
+// Integer sums of all elements must fit into 32 bits, so summed values are small
+template <>
+struct PrimitiveTypeTraits<cl_int> {
+    static void FillSummed(
+        const kpv::cl_benchmark::DataGenerator& generator, std::vector<cl_int>& data) {
+        generator.FillUniformInt<cl_int>(data, 0, 100, "Primitive input");
+    }
+    static void FillSorted(
+        const kpv::cl_benchmark::DataGenerator& generator, std::vector<cl_int>& data) {
+        generator.FillUniformInt<cl_int>(data, -1000000000, 1000000000, "Primitive input");
+    }
+    static bool SumsEqual(cl_int actual, cl_int expected) { return actual == expected; }
+};
+
+template <>
+struct PrimitiveTypeTraits<float> {
+    static void FillSummed(
+        const kpv::cl_benchmark::DataGenerator& generator, std::vector<float>& data) {
+        generator.FillUniformReal(data, 0.0f, 1.0f, "Primitive input");
+    }
+    static void FillSorted(
+        const kpv::cl_benchmark::DataGenerator& generator, std::vector<float>& data) {
+        generator.FillUniformReal(data, -1.0f, 1.0f, "Primitive input");
+    }
+    static bool SumsEqual(float actual, float expected) {
+        // Values are positive, so relative error of a sum is small for any summation order
+        static const double kMaxRelativeError = 1e-3;
+        return std::abs(static_cast<double>(actual) - expected) <=
+               kMaxRelativeError * std::abs(static_cast<double>(expected));
+    }
+};
+
+template <typename T>
+kpv::PrimitiveDataset<T> GenerateData(
+    const kpv::cl_benchmark::DataGenerator& generator, kpv::Primitive primitive, int data_size) {
+    kpv::PrimitiveDataset<T> dataset;
+    dataset.input.resize(data_size);
+    if (primitive == kpv::Primitive::kSort) {
+        PrimitiveTypeTraits<T>::FillSorted(generator, dataset.input);
+        dataset.expected = dataset.input;
+        std::sort(dataset.expected.begin(), dataset.expected.end());
+        return dataset;
+    }
+
+    PrimitiveTypeTraits<T>::FillSummed(generator, dataset.input);
+    // Expected sums are calculated in double precision
+    double sum = 0.0;
+    for (T value : dataset.input) {
+        sum += value;
+        if (primitive == kpv::Primitive::kInclusiveScan) {
+            dataset.expected.push_back(static_cast<T>(sum));
+        }
+    }
+    if (primitive == kpv::Primitive::kReduce) {
+        dataset.expected.push_back(static_cast<T>(sum));
+    }
+    return dataset;
+}
+
+// Same chunks as ThreadPool::ParallelFor() makes with this chunk size
+std::vector<kpv::cl_benchmark::WorkRange> SplitIntoChunks(
+    std::size_t size, std::size_t chunk_size) {
+    std::vector<kpv::cl_benchmark::WorkRange> result;
+    for (std::size_t begin = 0; begin < size; begin += chunk_size) {
+        result.push_back(kpv::cl_benchmark::WorkRange{begin, std::min(begin + chunk_size, size)});
+    }
+    return result;
+}
+}  // namespace
+
+namespace kpv {
+const char* PrimitiveName(Primitive primitive) {
+    switch (primitive) {
+    case Primitive::kReduce:
+        return "Reduce";
+    case Primitive::kInclusiveScan:
+        return "Inclusive scan";
+    case Primitive::kSort:
+        return "Sort";
+    }
+    throw std::invalid_argument("Unknown primitive.");
+}
+
+template <typename T>
+std::shared_ptr<const PrimitiveDataset<T>> GetPrimitiveDataset(
+    const cl_benchmark::InitializationParams& params, Primitive primitive, int data_size) {
+    return params.dataset_cache->GetOrCreate<PrimitiveDataset<T>>(
+        (boost::format("%1%, %2% bytes per value, %3% elements") % PrimitiveName(primitive) %
+         sizeof(T) % data_size)
+            .str(),
+        [&params, primitive, data_size]() {
+            return GenerateData<T>(params.data_generator, primitive, data_size);
+        });
+}
+
+template <typename T>
+void VerifyPrimitiveResults(
+    Primitive primitive, const std::vector<T>& output, const PrimitiveDataset<T>& dataset) {
+    if (output.size() != dataset.expected.size()) {
+        throw std::runtime_error(
+            (boost::format("Result verification has failed for %1% fixture. "
+                           "Output data count is another from expected one.") %
+             PrimitiveName(primitive))
+                .str());
+    }
+    for (std::size_t i = 0; i < output.size(); ++i) {
+        const bool equal = (primitive == Primitive::kSort)
+                               ? output[i] == dataset.expected[i]
+                               : PrimitiveTypeTraits<T>::SumsEqual(output[i], dataset.expected[i]);
+        if (!equal) {
+            throw std::runtime_error(
+                (boost::format("Result verification has failed for %1% fixture. "
+                               "Element %2% is %3%, but %4% is expected.") %
+                 PrimitiveName(primitive) % i % output[i] % dataset.expected[i])
+                    .str());
+        }
+    }
+}
+
+template <typename T>
+void HostParallelReduce(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool) {
+    const std::size_t chunk_size = pool.ChunkSize(input.size());
+    std::vector<T> partial_sums(SplitIntoChunks(input.size(), chunk_size).size(), T());
+    pool.ParallelFor(input.size(), chunk_size, [&](std::size_t begin, std::size_t end) {
+        partial_sums[begin / chunk_size] =
+            std::accumulate(input.cbegin() + begin, input.cbegin() + end, T());
+    });
+    output.assign(1, std::accumulate(partial_sums.cbegin(), partial_sums.cend(), T()));
+}
+
+template <typename T>
+void HostParallelInclusiveScan(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool) {
+    output.resize(input.size());
+    const std::size_t chunk_size = pool.ChunkSize(input.size());
+    // Every chunk is scanned separately, then sums of previous chunks are added to it
+    std::vector<T> chunk_sums(SplitIntoChunks(input.size(), chunk_size).size(), T());
+    pool.ParallelFor(input.size(), chunk_size, [&](std::size_t begin, std::size_t end) {
+        std::partial_sum(input.cbegin() + begin, input.cbegin() + end, output.begin() + begin);
+        chunk_sums[begin / chunk_size] = output[end - 1];
+    });
+    std::partial_sum(chunk_sums.cbegin(), chunk_sums.cend(), chunk_sums.begin());
+    pool.ParallelFor(input.size(), chunk_size, [&](std::size_t begin, std::size_t end) {
+        if (begin == 0) {
+            return;
+        }
+        const T offset = chunk_sums[begin / chunk_size - 1];
+        for (std::size_t i = begin; i < end; ++i) {
+            output[i] += offset;
+        }
+    });
+}
+
+template <typename T>
+void HostParallelSort(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool) {
+    output = input;
+    std::vector<cl_benchmark::WorkRange> ranges =
+        SplitIntoChunks(input.size(), pool.ChunkSize(input.size()));
+    // Every chunk of a loop over ranges is a single range, sorts and merges take long enough
+    pool.ParallelFor(ranges.size(), 1, [&](std::size_t index, std::size_t) {
+        std::sort(output.begin() + ranges[index].begin, output.begin() + ranges[index].end);
+    });
+    while (ranges.size() > 1) {
+        std::vector<cl_benchmark::WorkRange> merged((ranges.size() + 1) / 2);
+        pool.ParallelFor(merged.size(), 1, [&](std::size_t index, std::size_t) {
+            const cl_benchmark::WorkRange& first = ranges[2 * index];
+            if (2 * index + 1 == ranges.size()) {
+                merged[index] = first;
+                return;
+            }
+            const cl_benchmark::WorkRange& second = ranges[2 * index + 1];
+            std::inplace_merge(
+                output.begin() + first.begin, output.begin() + second.begin,
+                output.begin() + second.end);
+            merged[index] = cl_benchmark::WorkRange{first.begin, second.end};
+        });
+        ranges.swap(merged);
+    }
+}
+
+template std::shared_ptr<const PrimitiveDataset<cl_int>> GetPrimitiveDataset<cl_int>(
+    const cl_benchmark::InitializationParams&, Primitive, int);
+template std::shared_ptr<const PrimitiveDataset<float>> GetPrimitiveDataset<float>(
+    const cl_benchmark::InitializationParams&, Primitive, int);
+template void VerifyPrimitiveResults<cl_int>(
+    Primitive, const std::vector<cl_int>&, const PrimitiveDataset<cl_int>&);
+template void VerifyPrimitiveResults<float>(
+    Primitive, const std::vector<float>&, const PrimitiveDataset<float>&);
+template void HostParallelReduce<cl_int>(
+    const std::vector<cl_int>&, std::vector<cl_int>&, cl_benchmark::ThreadPool&);
+template void HostParallelReduce<float>(
+    const std::vector<float>&, std::vector<float>&, cl_benchmark::ThreadPool&);
+template void HostParallelInclusiveScan<cl_int>(
+    const std::vector<cl_int>&, std::vector<cl_int>&, cl_benchmark::ThreadPool&);
+template void HostParallelInclusiveScan<float>(
+    const std::vector<float>&, std::vector<float>&, cl_benchmark::ThreadPool&);
+template void HostParallelSort<cl_int>(
+    const std::vector<cl_int>&, std::vector<cl_int>&, cl_benchmark::ThreadPool&);
+template void HostParallelSort<float>(
+    const std::vector<float>&, std::vector<float>&, cl_benchmark::ThreadPool&);
+}  // namespace kpv
@@ -0,0 +1,53 @@
+#ifndef EXAMPLES_FIXTURES_PRIMITIVES_COMMON_H_
+#define EXAMPLES_FIXTURES_PRIMITIVES_COMMON_H_
+
+#include <memory>
+#include <vector>
+
+#include "cl_benchmark.hpp"
+
+namespace kpv {
+// Parallel primitives that take most of GPU time in typical workloads
+enum class Primitive { kReduce, kInclusiveScan, kSort };
+
+const char* PrimitiveName(Primitive primitive);
+
+// Input data and expected results, shared by all fixtures of one family
+template <typename T>
+struct PrimitiveDataset {
+    std::vector<T> input;
+    // Sum for a reduction (one element), prefix sums for a scan, sorted input for a sort
+    std::vector<T> expected;
+};
+
+template <typename T>
+std::shared_ptr<const PrimitiveDataset<T>> GetPrimitiveDataset(
+    const cl_benchmark::InitializationParams& params, Primitive primitive, int data_size);
+
+/*
+Throw if output differs from expected results. Sums of floating point values are compared with
+a relative tolerance, since implementations add values in different order.
+*/
+template <typename T>
+void VerifyPrimitiveResults(
+    Primitive primitive, const std::vector<T>& output, const PrimitiveDataset<T>& dataset);
+
+/*
+Implementations of primitives on a host, input is cut into chunks of a thread pool (see
+ThreadPool::ChunkSize()) that are processed by its threads. Output is resized as needed.
+*/
+template <typename T>
+void HostParallelReduce(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool);
+
+template <typename T>
+void HostParallelInclusiveScan(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool);
+
+// Chunks are sorted separately and then merged pairwise
+template <typename T>
+void HostParallelSort(
+    const std::vector<T>& input, std::vector<T>& output, cl_benchmark::ThreadPool& pool);
+}  // namespace kpv
+
+#endif  // EXAMPLES_FIXTURES_PRIMITIVES_COMMON_H_
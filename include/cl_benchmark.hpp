@@ -2,9 +2,15 @@
 #define KPV_CL_BENCHMARK_H_
 
 #include "detail/command_line_processor.hpp"
+#include "detail/devices/device_group.hpp"
+#include "detail/devices/host_device.hpp"
 #include "detail/fixture_register_macros.hpp"
 #include "detail/fixture_runner.hpp"
+#include "detail/fixtures/simulated_fixture.hpp"
+#include "detail/partitioning/work_partitioner.hpp"
 #include "detail/run_settings.hpp"
+#include "detail/threading/run_in_parallel.hpp"
+#include "detail/threading/thread_pool.hpp"
 #include "nlohmann/json.hpp"
 
 #endif  // KPV_CL_BENCHMARK_H_
@@ -0,0 +1,311 @@
+#ifndef KPV_CHECKPOINT_H_
+#define KPV_CHECKPOINT_H_
+
+#include <boost/log/trivial.hpp>
+#include <cstdint>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "detail/data/seed.hpp"
+#include "detail/duration.hpp"
+#include "detail/fixtures/fixture_id.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Checkpoint file that allows to resume an interrupted run.
+File is in JSON Lines format: the first line is a header with a seed, every other line contains
+full results of one finished fixture (including every iteration), so a resumed run builds
+exactly the same report as an uninterrupted one. A line is appended as soon as a fixture is
+finished, incomplete last line (e.g. after power loss) is ignored.
+Fixtures are identified by family name, device unique name and algorithm.
+*/
+class Checkpoint {
+public:
+    /*
+    Start a new checkpoint file or, if resume is true, load an existing one.
+    When resuming, seed is replaced by the one stored in a file, so all fixtures use same data.
+    */
+    Checkpoint(const std::string& file_name, bool resume, uint64_t& seed) : file_name_(file_name) {
+        if (resume && Load(seed)) {
+            return;
+        }
+        if (resume) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Checkpoint file " << file_name_ << " cannot be read, starting from scratch";
+        }
+        std::ofstream file(file_name_, std::ios_base::trunc);
+        WriteHeader(file, seed);
+    }
+
+    std::size_t completed_count() const { return completed_.size(); }
+
+    bool IsFinished(const FixtureId& fixture_id) const {
+        return completed_.count(MakeKey(fixture_id)) > 0;
+    }
+
+    /*
+    If fixture is already finished, fill its result and steps of its family and return true
+    */
+    bool Restore(
+        const FixtureId& fixture_id, FixtureFamilyResult& ff_result,
+        FixtureResult& fixture_result) const {
+        auto iter = completed_.find(MakeKey(fixture_id));
+        if (iter == completed_.end()) {
+            return false;
+        }
+        const nlohmann::json& data = iter->second;
+        // Step IDs of a family may differ from the ones stored in a file
+        std::vector<int> step_ids;
+        for (const nlohmann::json& step : data.at("steps")) {
+            step_ids.push_back(ff_result.steps.Intern(step.get<std::string>()));
+        }
+        fixture_result = FixtureResult();
+        fixture_result.queue_count = data.value("queueCount", 1);
+        fixture_result.launch_count = data.value("launchCount", 1);
+        if (data.count("timerResolution") > 0) {
+            fixture_result.timer_resolution = data.at("timerResolution").get<Duration>();
+        }
+        if (data.count("batchedSteps") > 0) {
+            for (const nlohmann::json& step : data.at("batchedSteps")) {
+                fixture_result.batched_steps.insert(step_ids.at(step.get<std::size_t>()));
+            }
+        }
+        if (data.count("hostIterationTime") > 0) {
+            fixture_result.host_iteration_time = data.at("hostIterationTime").get<Duration>();
+        }
+        if (data.count("failureReason") > 0) {
+            fixture_result.failure_reason = data.at("failureReason").get<std::string>();
+        }
+        if (data.count("accuracy") > 0) {
+            ResultAccuracy accuracy;
+            accuracy.max_relative_error = data.at("accuracy").at("maxRelativeError").get<double>();
+            accuracy.mean_relative_error =
+                data.at("accuracy").at("meanRelativeError").get<double>();
+            fixture_result.accuracy = accuracy;
+        }
+        if (data.count("workAmount") > 0) {
+            const nlohmann::json& work = data.at("workAmount");
+            WorkAmount work_amount;
+            work_amount.flops = work.at("flops").get<double>();
+            work_amount.bytes = work.at("bytes").get<double>();
+            work_amount.precision = work.at("precision").get<std::string>() == "double"
+                                        ? WorkAmount::Precision::kDouble
+                                        : WorkAmount::Precision::kSingle;
+            work_amount.step = work.at("step").get<std::string>();
+            fixture_result.work_amount = work_amount;
+        }
+        if (data.count("hostAllocation") > 0) {
+            fixture_result.host_allocation =
+                data.at("hostAllocation").get<HostAllocationStrategy>();
+        }
+        if (data.count("drift") > 0) {
+            fixture_result.drift = data.at("drift").get<DriftAnalysis>();
+        }
+        if (data.count("sensorsBefore") > 0) {
+            fixture_result.sensors_before = data.at("sensorsBefore").get<HostSensorReading>();
+            fixture_result.sensors_after = data.at("sensorsAfter").get<HostSensorReading>();
+        }
+        if (data.count("lifecycle") > 0) {
+            fixture_result.lifecycle =
+                data.at("lifecycle").get<std::map<std::string, Duration>>();
+        }
+        if (data.count("coldIterations") > 0) {
+            RestoreIterations(data.at("coldIterations"), step_ids, fixture_result.cold_samples);
+            fixture_result.cold_cache = data.value("coldCache", false);
+        }
+        if (data.count("statistics") > 0) {
+            std::vector<std::pair<int, StreamingStatistics>> statistics;
+            const nlohmann::json& steps = data.at("statistics");
+            for (std::size_t i = 0; i < step_ids.size(); ++i) {
+                if (!steps.at(i).is_null()) {
+                    statistics.emplace_back(step_ids[i], steps.at(i).get<StreamingStatistics>());
+                }
+            }
+            fixture_result.samples.RestoreStatistics(
+                data.at("iterationCount").get<std::size_t>(), statistics);
+            return true;
+        }
+        RestoreIterations(data.at("iterations"), step_ids, fixture_result.samples);
+        return true;
+    }
+
+    void Add(
+        const FixtureId& fixture_id, const FixtureFamilyResult& ff_result,
+        const FixtureResult& fixture_result) {
+        const std::vector<std::string>& steps = ff_result.steps.names();
+        const IterationSamples& samples = fixture_result.samples;
+        nlohmann::json data = {
+            {"family", fixture_id.family_name()},
+            {"device", fixture_id.device()->UniqueName()},
+            {"algorithm", fixture_id.algorithm()},
+            {"queueCount", fixture_result.queue_count},
+            {"launchCount", fixture_result.launch_count},
+            {"steps", steps}};
+        if (fixture_result.timer_resolution) {
+            data["timerResolution"] = fixture_result.timer_resolution.value();
+        }
+        if (!fixture_result.batched_steps.empty()) {
+            // Indices in the list of steps, as iterations are stored
+            data["batchedSteps"] = fixture_result.batched_steps;
+        }
+        if (samples.streaming()) {
+            // Only statistics are known, separate iterations are not stored
+            nlohmann::json statistics = nlohmann::json::array();
+            for (std::size_t step_id = 0; step_id < steps.size(); ++step_id) {
+                if (step_id < samples.step_count() &&
+                    samples.statistics(static_cast<int>(step_id)).count() > 0) {
+                    statistics.push_back(samples.statistics(static_cast<int>(step_id)));
+                } else {
+                    statistics.push_back(nullptr);
+                }
+            }
+            data["iterationCount"] = samples.iteration_count();
+            data["statistics"] = std::move(statistics);
+        } else {
+            data["iterations"] = SerializeIterations(samples, steps.size());
+        }
+        if (!fixture_result.lifecycle.empty()) {
+            data["lifecycle"] = fixture_result.lifecycle;
+        }
+        if (fixture_result.host_iteration_time) {
+            data["hostIterationTime"] = fixture_result.host_iteration_time.value();
+        }
+        if (fixture_result.accuracy) {
+            data["accuracy"] = {
+                {"maxRelativeError", fixture_result.accuracy->max_relative_error},
+                {"meanRelativeError", fixture_result.accuracy->mean_relative_error}};
+        }
+        if (fixture_result.work_amount) {
+            const WorkAmount& work = fixture_result.work_amount.value();
+            data["workAmount"] = {
+                {"flops", work.flops},
+                {"bytes", work.bytes},
+                {"precision",
+                 work.precision == WorkAmount::Precision::kDouble ? "double" : "single"},
+                {"step", work.step}};
+        }
+        if (fixture_result.host_allocation) {
+            data["hostAllocation"] = fixture_result.host_allocation.value();
+        }
+        if (fixture_result.drift) {
+            data["drift"] = fixture_result.drift.value();
+        }
+        if (fixture_result.sensors_before && fixture_result.sensors_after) {
+            data["sensorsBefore"] = fixture_result.sensors_before.value();
+            data["sensorsAfter"] = fixture_result.sensors_after.value();
+        }
+        if (!fixture_result.cold_samples.empty()) {
+            data["coldIterations"] = SerializeIterations(fixture_result.cold_samples, steps.size());
+            data["coldCache"] = fixture_result.cold_cache;
+        }
+        if (fixture_result.failure_reason) {
+            data["failureReason"] = fixture_result.failure_reason.value();
+        }
+
+        std::ofstream file(file_name_, std::ios_base::app);
+        file << data << std::endl;
+        if (!file) {
+            throw std::runtime_error("Cannot write to checkpoint file " + file_name_);
+        }
+        completed_[MakeKey(fixture_id)] = std::move(data);
+    }
+
+private:
+    typedef std::tuple<std::string, std::string, std::string> Key;
+
+    std::string file_name_;
+    std::map<Key, nlohmann::json> completed_;
+
+    static nlohmann::json SerializeIterations(
+        const IterationSamples& samples, std::size_t step_count) {
+        nlohmann::json iterations = nlohmann::json::array();
+        for (std::size_t i = 0; i < samples.iteration_count(); ++i) {
+            nlohmann::json durations = nlohmann::json::array();
+            for (std::size_t step_id = 0; step_id < step_count; ++step_id) {
+                if (samples.Has(static_cast<int>(step_id), i)) {
+                    durations.push_back(
+                        samples.Get(static_cast<int>(step_id), i).duration().count());
+                } else {
+                    durations.push_back(nullptr);
+                }
+            }
+            iterations.push_back(std::move(durations));
+        }
+        return iterations;
+    }
+
+    static void RestoreIterations(
+        const nlohmann::json& iterations, const std::vector<int>& step_ids,
+        IterationSamples& samples) {
+        samples.Reserve(iterations.size());
+        for (const nlohmann::json& iteration : iterations) {
+            samples.AddIteration();
+            for (std::size_t i = 0; i < step_ids.size(); ++i) {
+                if (!iteration.at(i).is_null()) {
+                    Duration::InternalType duration{iteration.at(i).get<double>()};
+                    samples.Record(step_ids[i], Duration{duration});
+                }
+            }
+        }
+    }
+
+    static Key MakeKey(const FixtureId& fixture_id) {
+        return Key{
+            fixture_id.family_name(), fixture_id.device()->UniqueName(), fixture_id.algorithm()};
+    }
+
+    void WriteHeader(std::ofstream& file, uint64_t seed) {
+        file << nlohmann::json{{"formatVersion", "0.1.0"}, {"seed", SeedToJson(seed)}} << std::endl;
+        if (!file) {
+            throw std::runtime_error("Cannot write to checkpoint file " + file_name_);
+        }
+    }
+
+    bool Load(uint64_t& seed) {
+        std::ifstream file(file_name_);
+        std::string line;
+        if (!file || !std::getline(file, line)) {
+            return false;
+        }
+        try {
+            nlohmann::json header = nlohmann::json::parse(line);
+            seed = SeedFromJson(header.at("seed"));
+        } catch (std::exception& e) {
+            BOOST_LOG_TRIVIAL(warning) << "Checkpoint file header is incorrect: " << e.what();
+            return false;
+        }
+        while (std::getline(file, line)) {
+            try {
+                nlohmann::json data = nlohmann::json::parse(line);
+                Key key{
+                    data.at("family").get<std::string>(), data.at("device").get<std::string>(),
+                    data.at("algorithm").get<std::string>()};
+                completed_[key] = std::move(data);
+            } catch (std::exception& e) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Skipping incorrect checkpoint file line: " << e.what();
+            }
+        }
+        // Rewrite file without incorrect lines, so new results are not appended to a broken one
+        std::ofstream out(file_name_, std::ios_base::trunc);
+        WriteHeader(out, seed);
+        for (const auto& p : completed_) {
+            out << p.second << std::endl;
+        }
+        if (!out) {
+            throw std::runtime_error("Cannot write to checkpoint file " + file_name_);
+        }
+        return true;
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_CHECKPOINT_H_
@@ -7,7 +7,10 @@
 #include <boost/log/trivial.hpp>
 #include <boost/program_options.hpp>
 #include <boost/tokenizer.hpp>
+#include <random>
 
+#include "detail/data/seed.hpp"
+#include "detail/environment/thread_affinity.hpp"
 #include "detail/fixture_runner.hpp"
 
 namespace kpv {
@@ -21,8 +24,6 @@ public:
 
         static const char* const kDefaultOutputFileName = "output.json";
         static const char* const kDefaultTargetTime = "100ms";
-        static const std::unordered_map<std::string /* suffix */, double /* multiplier */>
-            kTimeMultipliers = {{"ns", 1e-9}, {"mcs", 1e-6}, {"ms", 1e-3}, {"s", 1}};
         static const int kDefaultMinIterations = 1;
         /*
         Picked mostly randomly, IMO should be something like 1e9 (may be somebody wants
@@ -37,6 +38,19 @@ public:
         std::string target_time;
         std::string additional_params;
         std::string devices;
+        std::string pinned_cpus;
+        int host_threads = 0;
+        std::size_t host_chunk_size = 0;
+        std::string shard;
+        std::string total_budget;
+        std::vector<std::string> simulated_devices;
+        std::string merge_file_list;
+        std::string batch_launches;
+        std::string build_variants;
+        std::string daemon_interval;
+        std::string seed;
+        std::string drift_action = "flag";
+        double drift_threshold = 5.0;
 
         boost::program_options::options_description desc("Allowed options");
         // clang-format off
@@ -65,6 +79,57 @@ public:
             ("cpu,c", "run fixtures on OpenCL CPU devices")
             ("gpu,g", "run fixtures on OpenCL GPU devices")
             ("other-devices", "run fixtures on OpenCL accelerators and other devices")
+            ("simulated-device", po::value<std::vector<std::string>>(&simulated_devices)->composing(),
+                "add a simulated device with given duration distribution: fixed:mean, normal:mean[:deviation], heavy:mean[:shape] or drift:mean[:step] (example: normal:10mcs:0.05). May be given several times")
+            ("seed", po::value<std::string>(&seed),
+                "seed used to generate input data, pass a value from previous report to reproduce it. Random by default")
+            ("checkpoint-file", po::value<std::string>(&settings.checkpoint_file_name),
+                "write results of every finished fixture to this file, so an interrupted run can be resumed")
+            ("resume", "resume a run using a checkpoint file given by --checkpoint-file, finished fixtures are not run again")
+            ("pin-cpus", po::value<std::string>(&pinned_cpus),
+                "pin runner and host worker threads to given logical CPUs (examples: 2, 0,2,4-7)")
+            ("host-threads", po::value<int>(&host_threads),
+                "number of threads of the host device. Default value is a number of hardware threads")
+            ("host-chunk-size", po::value<std::size_t>(&host_chunk_size),
+                "number of indices that a host thread takes at once in parallel loops. Chosen from a loop size by default")
+            ("compute-unit-sweep", "split OpenCL CPU devices into sub-devices with 1, 2, 4... compute units and report speedup and parallel efficiency of every size")
+            ("thread-sweep", "run host fixtures with 1, 2, 4... threads up to --host-threads and report speedup and parallel efficiency of every thread count")
+            ("shard", po::value<std::string>(&shard),
+                "run only a part of fixtures, e.g. 2/4 runs the second of four parts. Every part must be started with the same options")
+            ("merge", po::value<std::string>(&merge_file_list),
+                "merge reports of several shards (file names separated by a comma) into a file given by --output-file")
+            ("total-budget", po::value<std::string>(&total_budget),
+                "split this time between all fixtures instead of using target time of every fixture (examples: 90s, 30min, 2h). Mutually exclusive with -i and -t options")
+            ("estimates-from", po::value<std::string>(&settings.estimates_file_name),
+                "report of a previous run used to estimate fixture costs when a total budget is planned")
+            ("dry-run", "print a plan of a run with a total budget and exit")
+            ("batch-launches", po::value<std::string>(&batch_launches)->implicit_value("auto"),
+                "launch kernels of fixtures that support batching this number of times in a row and report duration of one launch. Number is chosen from profiling timer resolution if it is auto or omitted")
+            ("cold-iterations", po::value<int>(&settings.cold_iterations),
+                "number of first iterations of every fixture that are reported separately as a cold series. Default value is 1")
+            ("cold-cache", "flush caches before every cold iteration")
+            ("build-variants", po::value<std::string>(&build_variants),
+                "comma-separated build option variants benchmarked as separate algorithms of fixtures that support them: fast-relaxed-math, mad-enable, unsafe-math, finite-math, no-signed-zeros, all, or raw options starting with -")
+            ("compile-threads", po::value<int>(&settings.compile_threads),
+                "number of background threads that build OpenCL programs of next fixtures while the current one runs, 0 builds programs when fixtures are initialized. Default value is 2")
+            ("characterize", "measure peak performance of every selected OpenCL device and store it in a file given by --device-profiles")
+            ("device-profiles", po::value<std::string>(&settings.device_profiles_file_name)->default_value("device_profiles.json"),
+                "file with device profiles written by --characterize, results of fixtures are compared with profiles of their devices")
+            ("streaming-statistics", "keep only statistics of durations instead of every sample, so memory does not grow with a number of iterations")
+            ("drift-action", po::value<std::string>(&drift_action),
+                "what is done when iteration durations of a fixture shift in the middle of a run (e.g. thermal throttling): flag reports it, discard removes iterations after the shift, rerun measures them again. Default value is flag")
+            ("drift-threshold", po::value<double>(&drift_threshold),
+                "smallest shift of mean iteration duration in percent that is reported as drift. Default value is 5")
+            ("daemon", po::value<std::string>(&daemon_interval),
+                "keep running selected fixtures every given interval (examples: 30s, 5min) and export their rolling statistics with --metrics-port or --metrics-file. Report of the first cycle is written to --output-file")
+            ("daemon-cycles", po::value<int>(&settings.daemon_cycles),
+                "exit after this number of daemon cycles. Daemon runs until it is killed by default")
+            ("metrics-port", po::value<int>(&settings.metrics_port),
+                "serve metrics in Prometheus text format at http://127.0.0.1:port/metrics in daemon mode (Linux only)")
+            ("metrics-file", po::value<std::string>(&settings.metrics_file_name),
+                "write metrics in Prometheus text format to this file after every daemon cycle, e.g. for a textfile collector of node_exporter")
+            ("metrics-window", po::value<int>(&settings.metrics_window),
+                "number of last runs of every fixture in rolling statistics of metrics. Default value is 10")
             ;
         // clang-format on
 
@@ -109,6 +174,17 @@ public:
                 << "Two or more mutually exclusive options related to iteration number is given.";
             return false;
         }
+        if (vm.count("total-budget") > 0 &&
+            (vm.count("iterations") > 0 || vm.count("target-time") > 0)) {
+            BOOST_LOG_TRIVIAL(fatal)
+                << "Total budget cannot be combined with fixed number of iterations or target time";
+            return false;
+        }
+        if ((vm.count("dry-run") > 0 || vm.count("estimates-from") > 0) &&
+            vm.count("total-budget") == 0) {
+            BOOST_LOG_TRIVIAL(fatal) << "Dry run and cost estimates need a total budget";
+            return false;
+        }
         if (vm.count("iterations") > 0) {
             settings.min_iterations = iterations;
             settings.max_iterations = iterations;
@@ -119,21 +195,66 @@ public:
                 target_time = kDefaultTargetTime;
             }
             try {
-                size_t index = 0;
-                double val = std::stod(target_time, &index);
-                double multiplier = kTimeMultipliers.at(target_time.substr(index));
-                settings.target_execution_time =
-                    Duration(std::chrono::duration<double>(val * multiplier));
+                settings.target_execution_time = ParseDuration(target_time);
             } catch (std::exception&) {
                 BOOST_LOG_TRIVIAL(fatal) << "Incorrect format of target execution time";
                 return false;
             }
         }
+        if (vm.count("total-budget") > 0) {
+            try {
+                settings.total_budget = ParseDuration(total_budget);
+            } catch (std::exception&) {
+                BOOST_LOG_TRIVIAL(fatal) << "Incorrect format of total budget";
+                return false;
+            }
+            if (!(settings.total_budget > Duration())) {
+                BOOST_LOG_TRIVIAL(fatal) << "Total budget must be positive";
+                return false;
+            }
+            settings.dry_run = vm.count("dry-run") > 0;
+        }
+
+        settings.streaming_statistics = vm.count("streaming-statistics") > 0;
+        if (settings.cold_iterations < 1) {
+            BOOST_LOG_TRIVIAL(fatal) << "Number of cold iterations must be positive";
+            return false;
+        }
+        settings.cold_cache = vm.count("cold-cache") > 0;
+        if (settings.compile_threads < 0) {
+            BOOST_LOG_TRIVIAL(fatal) << "Number of compile threads must not be negative";
+            return false;
+        }
+        if (vm.count("build-variants") > 0) {
+            try {
+                settings.build_variants = ParseBuildVariants(build_variants);
+            } catch (std::exception& e) {
+                BOOST_LOG_TRIVIAL(fatal) << e.what();
+                return false;
+            }
+        }
+        if (vm.count("batch-launches") > 0) {
+            if (batch_launches == "auto") {
+                settings.launch_count = 0;
+            } else {
+                try {
+                    settings.launch_count = std::stoi(batch_launches);
+                } catch (std::exception&) {
+                    settings.launch_count = -1;
+                }
+                if (settings.launch_count < 1) {
+                    BOOST_LOG_TRIVIAL(fatal) << "Number of batch launches must be auto or positive";
+                    return false;
+                }
+            }
+        }
 
         const bool list = vm.count("list") > 0;
         const bool run_all_except = vm.count("run-all-except") > 0;
         const bool run_only = vm.count("run-only") > 0;
-        if ((list && run_all_except) || (run_all_except && run_only) || (list && run_only)) {
+        const bool merge = vm.count("merge") > 0;
+        const bool characterize = vm.count("characterize") > 0;
+        if (list + run_all_except + run_only + merge + characterize > 1) {
             BOOST_LOG_TRIVIAL(fatal) << "More than one operation command is given";
             return false;
         }
@@ -145,6 +266,10 @@ public:
             settings.operation = RunSettings::kRunAllExcept;
         } else if (run_only) {
             settings.operation = RunSettings::kRunOnly;
+        } else if (merge) {
+            settings.operation = RunSettings::kMerge;
+        } else if (characterize) {
+            settings.operation = RunSettings::kCharacterize;
         }
 
         boost::char_separator<char> comma(",");
@@ -152,6 +277,10 @@ public:
         std::copy(
             category_tokenizer.begin(), category_tokenizer.end(),
             std::back_inserter(settings.category_list));
+        boost::tokenizer<boost::char_separator<char> > merge_tokenizer(merge_file_list, comma);
+        std::copy(
+            merge_tokenizer.begin(), merge_tokenizer.end(),
+            std::back_inserter(settings.merge_file_names));
 
         log::severity_level min_severity = (vm.count("verbose") > 0) ? log::trace : log::info;
         boost::log::core::get()->set_filter(log::severity >= min_severity);
@@ -159,7 +288,7 @@ public:
         // If no device options are given, enable all of them. Otherwise disable all and then go
         // type by type
         if ((vm.count("cpu") > 0) || (vm.count("gpu") > 0) || (vm.count("host") > 0) ||
-            (vm.count("other-devices") > 0)) {
+            (vm.count("other-devices") > 0) || (vm.count("simulated-device") > 0)) {
             // Disable all devices by default
             settings.device_config = DeviceConfiguration(false);
             if (vm.count("cpu") > 0) {
@@ -175,6 +304,105 @@ public:
                 settings.device_config.other_opencl_devices = true;
             }
         }
+        try {
+            for (const std::string& spec : simulated_devices) {
+                settings.device_config.simulated_devices.push_back(DurationDistribution::Parse(
+                    spec, settings.device_config.simulated_devices.size()));
+            }
+        } catch (std::exception& e) {
+            BOOST_LOG_TRIVIAL(fatal) << e.what();
+            return false;
+        }
+
+        try {
+            settings.pinned_cpus = ParseCpuList(pinned_cpus);
+        } catch (std::exception& e) {
+            BOOST_LOG_TRIVIAL(fatal) << "Incorrect format of CPU list: " << e.what();
+            return false;
+        }
+        if (vm.count("host-threads") > 0 && host_threads < 1) {
+            BOOST_LOG_TRIVIAL(fatal) << "Number of host threads must be positive";
+            return false;
+        }
+        if (vm.count("host-chunk-size") > 0 && host_chunk_size == 0) {
+            BOOST_LOG_TRIVIAL(fatal) << "Host chunk size must be positive";
+            return false;
+        }
+        settings.device_config.host_threads = host_threads;
+        settings.device_config.host_chunk_size = host_chunk_size;
+        settings.device_config.host_thread_sweep = vm.count("thread-sweep") > 0;
+        settings.device_config.host_pinned_cpus = settings.pinned_cpus;
+        settings.device_config.compute_unit_sweep = vm.count("compute-unit-sweep") > 0;
+
+        if (vm.count("shard") > 0) {
+            try {
+                settings.shard = RunShard::Parse(shard);
+            } catch (std::exception& e) {
+                BOOST_LOG_TRIVIAL(fatal) << e.what() << ", expected format is i/N";
+                return false;
+            }
+        }
+
+        if (vm.count("resume") > 0) {
+            if (settings.checkpoint_file_name.empty()) {
+                BOOST_LOG_TRIVIAL(fatal) << "Checkpoint file is needed to resume a run";
+                return false;
+            }
+            settings.resume = true;
+        }
+
+        try {
+            settings.drift_action = DriftActionFromName(drift_action);
+        } catch (std::exception& e) {
+            BOOST_LOG_TRIVIAL(fatal) << e.what();
+            return false;
+        }
+        if (!(drift_threshold > 0.0)) {
+            BOOST_LOG_TRIVIAL(fatal) << "Drift threshold must be positive";
+            return false;
+        }
+        settings.drift_threshold = drift_threshold / 100.0;
+
+        if (vm.count("daemon") > 0) {
+            try {
+                settings.daemon_interval = ParseDuration(daemon_interval);
+            } catch (std::exception&) {
+                BOOST_LOG_TRIVIAL(fatal) << "Incorrect format of daemon interval";
+                return false;
+            }
+            if (!(settings.daemon_interval > Duration())) {
+                BOOST_LOG_TRIVIAL(fatal) << "Daemon interval must be positive";
+                return false;
+            }
+            // Every cycle runs all selected fixtures again, so run-once features don't apply
+            if (!settings.checkpoint_file_name.empty() || vm.count("total-budget") > 0) {
+                BOOST_LOG_TRIVIAL(fatal)
+                    << "Daemon mode cannot be combined with a checkpoint file or a total budget";
+                return false;
+            }
+            if (settings.daemon_cycles < 0 || settings.metrics_window < 1 ||
+                settings.metrics_port < 0 || settings.metrics_port > 65535) {
+                BOOST_LOG_TRIVIAL(fatal) << "Incorrect daemon cycles, metrics window or port";
+                return false;
+            }
+        } else if (
+            vm.count("daemon-cycles") > 0 || vm.count("metrics-port") > 0 ||
+            vm.count("metrics-file") > 0 || vm.count("metrics-window") > 0) {
+            BOOST_LOG_TRIVIAL(fatal) << "Metrics options are used in daemon mode only";
+            return false;
+        }
+
+        if (vm.count("seed") == 0) {
+            std::random_device random_dev;
+            settings.seed = (static_cast<uint64_t>(random_dev()) << 32) | random_dev();
+        } else {
+            try {
+                settings.seed = SeedFromString(seed);
+            } catch (std::exception& e) {
+                BOOST_LOG_TRIVIAL(fatal) << e.what();
+                return false;
+            }
+        }
 
         settings.additional_params = additional_params;
         return true;
@@ -0,0 +1,283 @@
+#ifndef KPV_COMPILATION_PROGRAM_CACHE_H_
+#define KPV_COMPILATION_PROGRAM_CACHE_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include "boost/compute.hpp"
+#include "detail/duration.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Everything needed to build an OpenCL program. Programs with equal context, source and options
+are built once.
+*/
+struct ProgramSource {
+    boost::compute::context context;
+    std::string source;
+    std::string options;
+};
+
+/*
+Build a program, build log is written to the log on a build failure
+*/
+inline boost::compute::program BuildProgram(const ProgramSource& program_source) {
+    // Taken from boost::compute::program::create_with_source() so we have build log
+    // left in case of errors
+    const char* source_string = program_source.source.c_str();
+    cl_int error = 0;
+    cl_program program_ =
+        clCreateProgramWithSource(program_source.context, 1, &source_string, 0, &error);
+    if (!program_) {
+        throw boost::compute::opencl_error(error);
+    }
+    boost::compute::program program(program_, false);
+    try {
+        program.build(program_source.options);
+        return program;
+    } catch (boost::compute::opencl_error& error) {
+        if (error.error_code() == CL_BUILD_PROGRAM_FAILURE) {
+            BOOST_LOG_TRIVIAL(error) << "OpenCL program build failure: " << program.build_log();
+        }
+        throw;
+    }
+}
+
+/*
+In-memory cache of built programs. Programs of next fixtures may be built in background with
+Prefetch() while a current fixture runs, Get() waits for a build to finish or builds a program
+on a calling thread if its build is not started yet. A build error is rethrown by every Get()
+of the same program. Build time of every program is kept, wherever it was built.
+With zero threads nothing is built in background, but programs are still cached.
+*/
+class ProgramCache {
+public:
+    using Builder = std::function<boost::compute::program(const ProgramSource&)>;
+
+    explicit ProgramCache(int thread_count = 0, Builder builder = BuildProgram)
+        : builder_(std::move(builder)) {
+        for (int i = 0; i < thread_count; ++i) {
+            threads_.emplace_back([this]() { WorkerLoop(); });
+        }
+    }
+
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    ~ProgramCache() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+            // Queued builds are dropped, nobody can wait for them anymore
+            queue_.clear();
+        }
+        condition_.notify_all();
+        for (std::thread& t : threads_) {
+            t.join();
+        }
+    }
+
+    /*
+    Start building a program in background unless it is already built or queued
+    */
+    void Prefetch(const ProgramSource& program_source) {
+        if (threads_.empty()) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (entries_.count(MakeKey(program_source)) > 0) {
+                return;
+            }
+            queue_.push_back(AddEntry(program_source));
+        }
+        condition_.notify_one();
+    }
+
+    boost::compute::program Get(const ProgramSource& program_source) {
+        std::shared_ptr<Task> task;
+        std::shared_future<boost::compute::program> result;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            auto iter = entries_.find(MakeKey(program_source));
+            if (iter == entries_.end()) {
+                task = AddEntry(program_source);
+                iter = entries_.find(MakeKey(program_source));
+            } else {
+                // Build that is not started yet is made here instead of waiting for a worker
+                auto queued = std::find(queue_.begin(), queue_.end(), iter->second.task);
+                if (queued != queue_.end()) {
+                    task = *queued;
+                    queue_.erase(queued);
+                }
+            }
+            result = iter->second.program;
+        }
+        if (task) {
+            (*task)();
+        }
+        return result.get();
+    }
+
+    /*
+    Wait until all prefetched programs are built. Background builds compete for host CPUs, so
+    they should not run during measurements that use them.
+    */
+    void WaitForPrefetches() {
+        std::unique_lock<std::mutex> lock(mutex_);
+        idle_condition_.wait(lock, [this]() { return queue_.empty() && running_builds_ == 0; });
+    }
+
+    /*
+    Wall clock time of a finished build of a program (failed builds too). It is returned only
+    once, so a build is accounted to the first user of a program and not to every fixture that
+    takes the program from the cache later.
+    */
+    boost::optional<Duration> TakeBuildDuration(const ProgramSource& program_source) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = entries_.find(MakeKey(program_source));
+        if (iter == entries_.end() || iter->second.build_duration_taken) {
+            return boost::none;
+        }
+        iter->second.build_duration_taken = iter->second.build_duration.is_initialized();
+        return iter->second.build_duration;
+    }
+
+    // Number of programs that are built, being built or queued
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return entries_.size();
+    }
+
+    int thread_count() const { return static_cast<int>(threads_.size()); }
+
+private:
+    using Task = std::packaged_task<boost::compute::program()>;
+    using Key = std::tuple<cl_context, std::string, std::string>;
+
+    struct Entry {
+        std::shared_future<boost::compute::program> program;
+        std::shared_ptr<Task> task;
+        boost::optional<Duration> build_duration;  // Set when a build is finished
+        bool build_duration_taken = false;
+    };
+
+    Builder builder_;
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::condition_variable idle_condition_;  // Notified when a background build is finished
+    std::map<Key, Entry> entries_;
+    std::deque<std::shared_ptr<Task>> queue_;  // Builds that are not started yet
+    int running_builds_ = 0;                   // Builds of background threads
+    bool stopping_ = false;
+    std::vector<std::thread> threads_;
+
+    static Key MakeKey(const ProgramSource& program_source) {
+        return Key(program_source.context.get(), program_source.source, program_source.options);
+    }
+
+    // Must be called with the lock being held
+    std::shared_ptr<Task> AddEntry(const ProgramSource& program_source) {
+        // Task owns a copy of the source, so the context is retained until a build is done
+        auto task = std::make_shared<Task>([this, program_source]() {
+            const auto start = std::chrono::steady_clock::now();
+            try {
+                boost::compute::program program = builder_(program_source);
+                SetBuildDuration(program_source, start);
+                return program;
+            } catch (...) {
+                SetBuildDuration(program_source, start);
+                throw;
+            }
+        });
+        entries_.emplace(
+            MakeKey(program_source), Entry{task->get_future().share(), task, boost::none, false});
+        return task;
+    }
+
+    void WorkerLoop() {
+        while (true) {
+            std::shared_ptr<Task> task;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                condition_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+                if (stopping_) {
+                    return;
+                }
+                task = queue_.front();
+                queue_.pop_front();
+                ++running_builds_;
+            }
+            (*task)();
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --running_builds_;
+            }
+            idle_condition_.notify_all();
+        }
+    }
+
+    void SetBuildDuration(
+        const ProgramSource& program_source, std::chrono::steady_clock::time_point start) {
+        const Duration duration(std::chrono::steady_clock::now() - start);
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.at(MakeKey(program_source)).build_duration = duration;
+    }
+};
+
+/*
+Programs of fixtures in the order they are run. Builds of programs of a few next fixtures are
+started when a fixture starts, so a device doesn't wait for compilation between fixtures.
+*/
+class CompilePipeline {
+public:
+    CompilePipeline(const std::shared_ptr<ProgramCache>& cache, std::size_t lookahead)
+        : cache_(cache), lookahead_(lookahead) {}
+
+    // Add the next fixture in run order, fixtures that are not run have no programs
+    void AddFixture(std::vector<ProgramSource> programs) {
+        fixtures_.push_back(std::move(programs));
+    }
+
+    /*
+    Called when the next fixture in run order starts, before its Initialize()
+    */
+    void StartFixture() {
+        const std::size_t end = std::min(current_ + lookahead_ + 1, fixtures_.size());
+        for (; prefetched_ < end; ++prefetched_) {
+            for (const ProgramSource& program_source : fixtures_[prefetched_]) {
+                cache_->Prefetch(program_source);
+            }
+            // Sources are not needed anymore
+            fixtures_[prefetched_].clear();
+        }
+        ++current_;
+    }
+
+private:
+    std::shared_ptr<ProgramCache> cache_;
+    std::size_t lookahead_;
+    std::vector<std::vector<ProgramSource>> fixtures_;
+    std::size_t current_ = 0;     // Index of a fixture that starts next
+    std::size_t prefetched_ = 0;  // Fixtures before it have their builds started
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_COMPILATION_PROGRAM_CACHE_H_
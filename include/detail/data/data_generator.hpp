@@ -0,0 +1,151 @@
+#ifndef KPV_DATA_DATA_GENERATOR_H_
+#define KPV_DATA_DATA_GENERATOR_H_
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "detail/threading/run_in_parallel.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Deterministic generator of fixture input data.
+Uses counter-based random numbers: value of every element depends only on seed, stream name
+and element index, so data are identical for any number of threads and any order in which
+buffers are filled. The same seed reproduces a run exactly.
+Stream name separates unrelated data (e.g. different fixture families or different buffers of
+the same fixture). Fixtures that want identical data on every device should use the same stream
+name on all of them.
+*/
+class DataGenerator {
+public:
+    DataGenerator(
+        uint64_t seed, const std::vector<int>& pinned_cpus = std::vector<int>(),
+        unsigned thread_count = 0)
+        : seed_(seed), pinned_cpus_(pinned_cpus), thread_count_(thread_count) {
+        if (thread_count_ == 0) {
+            thread_count_ = pinned_cpus_.empty() ? std::thread::hardware_concurrency()
+                                                 : static_cast<unsigned>(pinned_cpus_.size());
+        }
+        thread_count_ = std::max(thread_count_, 1u);
+    }
+
+    uint64_t seed() const { return seed_; }
+
+    /*
+    Fill range with uniformly distributed floating point values in [min_val, max_val) range.
+    */
+    template <typename T>
+    void FillUniformReal(
+        T* data, std::size_t count, T min_val, T max_val, const std::string& stream_name) const {
+        static_assert(std::is_floating_point<T>::value, "Floating point type is expected.");
+        if (!(min_val <= max_val)) {
+            throw std::invalid_argument("Minimum value is bigger than maximum one.");
+        }
+        const uint64_t key = StreamKey(stream_name);
+        const double min_double = min_val;
+        const double range = static_cast<double>(max_val) - min_double;
+        ParallelFor(count, [=](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                // 53 upper bits give a uniform value in [0, 1)
+                double unit = (Value(key, i) >> 11) * (1.0 / 9007199254740992.0);
+                data[i] = static_cast<T>(min_double + unit * range);
+            }
+        });
+    }
+
+    template <typename T>
+    void FillUniformReal(
+        std::vector<T>& data, T min_val, T max_val, const std::string& stream_name) const {
+        FillUniformReal(data.data(), data.size(), min_val, max_val, stream_name);
+    }
+
+    /*
+    Fill range with uniformly distributed integer values in [min_val, max_val] range.
+    Modulo reduction is used, its bias is negligible for ranges much smaller than 2^64.
+    */
+    template <typename T>
+    void FillUniformInt(
+        T* data, std::size_t count, T min_val, T max_val, const std::string& stream_name) const {
+        static_assert(std::is_integral<T>::value, "Integer type is expected.");
+        if (!(min_val <= max_val)) {
+            throw std::invalid_argument("Minimum value is bigger than maximum one.");
+        }
+        const uint64_t key = StreamKey(stream_name);
+        // Range size minus one, so full 64-bit range does not overflow
+        const uint64_t range_minus_one =
+            static_cast<uint64_t>(max_val) - static_cast<uint64_t>(min_val);
+        ParallelFor(count, [=](std::size_t begin, std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                uint64_t val = Value(key, i);
+                if (range_minus_one != std::numeric_limits<uint64_t>::max()) {
+                    val %= range_minus_one + 1;
+                }
+                data[i] = static_cast<T>(static_cast<uint64_t>(min_val) + val);
+            }
+        });
+    }
+
+    template <typename T>
+    void FillUniformInt(
+        std::vector<T>& data, T min_val, T max_val, const std::string& stream_name) const {
+        FillUniformInt(data.data(), data.size(), min_val, max_val, stream_name);
+    }
+
+private:
+    // Ranges smaller than this are filled on a calling thread, threads are too expensive for them
+    static const std::size_t kMinElementsPerThread = 1 << 16;
+
+    uint64_t seed_;
+    std::vector<int> pinned_cpus_;
+    unsigned thread_count_;
+
+    // SplitMix64 finalizer, see http://xorshift.di.unimi.it/splitmix64.c
+    static uint64_t Mix(uint64_t z) {
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+        return z ^ (z >> 31);
+    }
+
+    static uint64_t Value(uint64_t key, std::size_t index) {
+        return Mix(key + (static_cast<uint64_t>(index) + 1) * 0x9e3779b97f4a7c15ull);
+    }
+
+    // std::hash is not guaranteed to be the same on all platforms, so FNV-1a is used instead
+    uint64_t StreamKey(const std::string& stream_name) const {
+        uint64_t hash = 0xcbf29ce484222325ull;
+        for (char c : stream_name) {
+            hash ^= static_cast<unsigned char>(c);
+            hash *= 0x100000001b3ull;
+        }
+        return Mix(seed_ ^ Mix(hash));
+    }
+
+    template <typename F>
+    void ParallelFor(std::size_t count, F func) const {
+        std::size_t thread_count = std::min<std::size_t>(
+            thread_count_, std::max<std::size_t>(count / kMinElementsPerThread, 1));
+        if (thread_count <= 1) {
+            func(0, count);
+            return;
+        }
+        std::size_t chunk = (count + thread_count - 1) / thread_count;
+        RunInParallel(
+            thread_count,
+            [&func, chunk, count](std::size_t index) {
+                std::size_t begin = std::min(index * chunk, count);
+                func(begin, std::min(begin + chunk, count));
+            },
+            pinned_cpus_);
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DATA_DATA_GENERATOR_H_
@@ -0,0 +1,66 @@
+#ifndef KPV_DATA_DATASET_CACHE_H_
+#define KPV_DATA_DATASET_CACHE_H_
+
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <typeindex>
+#include <unordered_map>
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Storage of immutable fixture datasets (input data, expected results) shared by all fixtures
+of one fixture family.
+Runner creates a new cache for every fixture family and destroys it after a family is finished,
+so datasets are created once per family, every device is measured using the same data and
+memory is released as soon as possible.
+Key should contain all parameters that affect the dataset (e.g. element count and data type).
+*/
+class DatasetCache {
+public:
+    /*
+    Return dataset stored with a given key, create it using factory if it doesn't exist.
+    Factory must return a value of type T. It is called with internal lock being held, so it must
+    not access the same cache.
+    */
+    template <typename T, typename Factory>
+    std::shared_ptr<const T> GetOrCreate(const std::string& key, Factory factory) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto iter = datasets_.find(key);
+        if (iter != datasets_.end()) {
+            if (iter->second.type != std::type_index(typeid(T))) {
+                throw std::logic_error(
+                    "Dataset \"" + key + "\" is already stored with a different type.");
+            }
+            return std::static_pointer_cast<const T>(iter->second.data);
+        }
+        std::shared_ptr<const T> dataset = std::make_shared<T>(factory());
+        datasets_.emplace(key, Entry{std::type_index(typeid(T)), dataset});
+        return dataset;
+    }
+
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return datasets_.size();
+    }
+
+    void Clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        datasets_.clear();
+    }
+
+private:
+    struct Entry {
+        std::type_index type;
+        std::shared_ptr<const void> data;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, Entry> datasets_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DATA_DATASET_CACHE_H_
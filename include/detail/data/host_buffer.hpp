@@ -0,0 +1,229 @@
+#ifndef KPV_DATA_HOST_BUFFER_H_
+#define KPV_DATA_HOST_BUFFER_H_
+
+#include <algorithm>
+#include <boost/align/aligned_alloc.hpp>
+#include <boost/log/trivial.hpp>
+#include <cstddef>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+
+#include "boost/compute.hpp"
+#include "nlohmann/json.hpp"
+
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+How memory of a HostBuffer is allocated. Fixtures that use host buffers report it, so a
+difference between strategies (e.g. zero-copy on CPU devices) can be seen in a report.
+*/
+struct HostAllocationStrategy {
+    enum class HugePages {
+        kNone,
+        kTransparent,  // Transparent huge pages are requested with madvise(), Linux only
+        kExplicit      // Memory is taken from reserved huge pages (MAP_HUGETLB), Linux only
+    };
+
+    static const std::size_t kCacheLineSize = 64;
+    static const std::size_t kPageSize = 4096;
+    static const std::size_t kHugePageSize = 2 * 1024 * 1024;
+
+    std::size_t alignment = kCacheLineSize;  // Power of two
+    HugePages huge_pages = HugePages::kNone;
+    // Device buffers created with HostBuffer::CreateDeviceBuffer() use host memory directly
+    // (CL_MEM_USE_HOST_PTR), so CPU devices may skip copies
+    bool use_host_ptr = false;
+};
+
+inline const char* HugePagesName(HostAllocationStrategy::HugePages huge_pages) {
+    switch (huge_pages) {
+    case HostAllocationStrategy::HugePages::kNone:
+        return "none";
+    case HostAllocationStrategy::HugePages::kTransparent:
+        return "transparent";
+    case HostAllocationStrategy::HugePages::kExplicit:
+        return "explicit";
+    }
+    throw std::invalid_argument("Unknown huge pages kind.");
+}
+
+inline HostAllocationStrategy::HugePages HugePagesFromName(const std::string& name) {
+    for (auto huge_pages :
+         {HostAllocationStrategy::HugePages::kNone, HostAllocationStrategy::HugePages::kTransparent,
+          HostAllocationStrategy::HugePages::kExplicit}) {
+        if (name == HugePagesName(huge_pages)) {
+            return huge_pages;
+        }
+    }
+    throw std::invalid_argument("Unknown huge pages kind: " + name);
+}
+
+inline void to_json(nlohmann::json& j, const HostAllocationStrategy& s) {
+    j = nlohmann::json::object({{"alignment", s.alignment},
+                                {"hugePages", HugePagesName(s.huge_pages)},
+                                {"useHostPtr", s.use_host_ptr}});
+}
+
+inline void from_json(const nlohmann::json& j, HostAllocationStrategy& s) {
+    s.alignment = j.at("alignment").get<std::size_t>();
+    s.huge_pages = HugePagesFromName(j.at("hugePages").get<std::string>());
+    s.use_host_ptr = j.at("useHostPtr").get<bool>();
+}
+
+/*
+Host memory for input and output data of a fixture with a given alignment and optional huge
+pages. Huge pages are used only for buffers of at least one huge page, if they cannot be
+allocated a buffer falls back to regular pages, strategy() returns what was actually used.
+Elements are value-initialized, so pages are touched before a fixture is run.
+*/
+template <typename T>
+class HostBuffer {
+    static_assert(std::is_trivially_copyable<T>::value, "HostBuffer holds plain data only");
+
+public:
+    HostBuffer() = default;
+
+    HostBuffer(std::size_t size, const HostAllocationStrategy& strategy)
+        : size_(size), strategy_(strategy) {
+        if (strategy_.alignment == 0 || (strategy_.alignment & (strategy_.alignment - 1)) != 0 ||
+            strategy_.alignment < alignof(T)) {
+            throw std::invalid_argument(
+                "Alignment of a host buffer must be a power of two that suits its elements.");
+        }
+        Allocate();
+        std::fill_n(data_, size_, T());
+    }
+
+    HostBuffer(const HostBuffer&) = delete;
+    HostBuffer& operator=(const HostBuffer&) = delete;
+
+    HostBuffer(HostBuffer&& other) noexcept { Swap(other); }
+
+    HostBuffer& operator=(HostBuffer&& other) noexcept {
+        HostBuffer(std::move(other)).Swap(*this);
+        return *this;
+    }
+
+    ~HostBuffer() noexcept { Release(); }
+
+    T* data() { return data_; }
+    const T* data() const { return data_; }
+    std::size_t size() const { return size_; }
+    T* begin() { return data_; }
+    T* end() { return data_ + size_; }
+    const T* begin() const { return data_; }
+    const T* end() const { return data_ + size_; }
+    T& operator[](std::size_t index) { return data_[index]; }
+    const T& operator[](std::size_t index) const { return data_[index]; }
+
+    const HostAllocationStrategy& strategy() const { return strategy_; }
+
+    /*
+    Device buffer of the same size. With HostAllocationStrategy::use_host_ptr it is backed by
+    this buffer, which must outlive it, otherwise it is a separate device allocation.
+    */
+    boost::compute::buffer CreateDeviceBuffer(
+        const boost::compute::context& context,
+        cl_mem_flags flags = boost::compute::buffer::read_write) {
+        if (strategy_.use_host_ptr) {
+            return boost::compute::buffer(
+                context, size_ * sizeof(T), flags | CL_MEM_USE_HOST_PTR, data_);
+        }
+        return boost::compute::buffer(context, size_ * sizeof(T), flags);
+    }
+
+private:
+    T* data_ = nullptr;
+    std::size_t size_ = 0;
+    std::size_t mapped_bytes_ = 0;  // Non-zero if memory is mapped with mmap()
+    HostAllocationStrategy strategy_;
+
+    void Allocate() {
+        const std::size_t bytes = std::max<std::size_t>(size_ * sizeof(T), 1);
+        const std::size_t huge_page_size = HostAllocationStrategy::kHugePageSize;
+        if (bytes < huge_page_size) {
+            strategy_.huge_pages = HostAllocationStrategy::HugePages::kNone;
+        }
+#if defined(__linux__)
+        // Whole huge pages are allocated, so the end of a buffer doesn't share a page
+        const std::size_t huge_bytes =
+            (bytes + huge_page_size - 1) / huge_page_size * huge_page_size;
+        if (strategy_.huge_pages == HostAllocationStrategy::HugePages::kExplicit) {
+            void* memory = mmap(
+                nullptr, huge_bytes, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (memory != MAP_FAILED) {
+                data_ = static_cast<T*>(memory);
+                mapped_bytes_ = huge_bytes;
+                strategy_.alignment = std::max(strategy_.alignment, huge_page_size);
+                return;
+            }
+            BOOST_LOG_TRIVIAL(warning) << "Cannot allocate " << huge_bytes
+                                       << " bytes of reserved huge pages, transparent huge "
+                                          "pages are used instead";
+            strategy_.huge_pages = HostAllocationStrategy::HugePages::kTransparent;
+        }
+        if (strategy_.huge_pages == HostAllocationStrategy::HugePages::kTransparent) {
+            strategy_.alignment = std::max(strategy_.alignment, huge_page_size);
+            AllocateAligned(huge_bytes);
+            if (madvise(data_, huge_bytes, MADV_HUGEPAGE) != 0) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Transparent huge pages are not available, regular pages are used";
+                strategy_.huge_pages = HostAllocationStrategy::HugePages::kNone;
+            }
+            return;
+        }
+#else
+        if (strategy_.huge_pages != HostAllocationStrategy::HugePages::kNone) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Huge pages are not supported on this platform, regular pages are used";
+            strategy_.huge_pages = HostAllocationStrategy::HugePages::kNone;
+        }
+#endif
+        AllocateAligned(bytes);
+    }
+
+    void AllocateAligned(std::size_t bytes) {
+        // Size is rounded up, so the last element doesn't share an aligned block with other data
+        const std::size_t rounded_bytes =
+            (bytes + strategy_.alignment - 1) / strategy_.alignment * strategy_.alignment;
+        data_ = static_cast<T*>(
+            boost::alignment::aligned_alloc(strategy_.alignment, rounded_bytes));
+        if (data_ == nullptr) {
+            throw std::bad_alloc();
+        }
+    }
+
+    void Release() noexcept {
+        if (data_ == nullptr) {
+            return;
+        }
+#if defined(__linux__)
+        if (mapped_bytes_ > 0) {
+            munmap(data_, mapped_bytes_);
+            data_ = nullptr;
+            return;
+        }
+#endif
+        boost::alignment::aligned_free(data_);
+        data_ = nullptr;
+    }
+
+    void Swap(HostBuffer& other) noexcept {
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+        std::swap(mapped_bytes_, other.mapped_bytes_);
+        std::swap(strategy_, other.strategy_);
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DATA_HOST_BUFFER_H_
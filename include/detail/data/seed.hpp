@@ -0,0 +1,48 @@
+#ifndef KPV_DATA_SEED_H_
+#define KPV_DATA_SEED_H_
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Seeds are written to reports and checkpoints as decimal strings: most JSON readers store numbers
+as doubles, which lose precision above 2^53, so a seed copied from a report would not reproduce
+a run.
+*/
+inline nlohmann::json SeedToJson(uint64_t seed) { return std::to_string(seed); }
+
+/*
+Parse a seed given as a decimal number, optionally in double quotes as it is written in a report
+*/
+inline uint64_t SeedFromString(const std::string& text) {
+    std::string digits = text;
+    if (digits.size() >= 2 && digits.front() == '"' && digits.back() == '"') {
+        digits = digits.substr(1, digits.size() - 2);
+    }
+    // std::stoull silently accepts a sign and trailing characters
+    if (digits.empty() || digits.find_first_not_of("0123456789") != std::string::npos) {
+        throw std::invalid_argument("Incorrect seed: " + text);
+    }
+    try {
+        return std::stoull(digits);
+    } catch (std::out_of_range&) {
+        throw std::invalid_argument("Seed is out of range: " + text);
+    }
+}
+
+// Accepts numbers too, they were written by earlier versions
+inline uint64_t SeedFromJson(const nlohmann::json& j) {
+    if (j.is_string()) {
+        return SeedFromString(j.get<std::string>());
+    }
+    return j.get<uint64_t>();
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DATA_SEED_H_
@@ -0,0 +1,92 @@
+#ifndef KPV_DEVICES_DEVICE_GROUP_H_
+#define KPV_DEVICES_DEVICE_GROUP_H_
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "detail/devices/device_interface.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Several devices that execute one workload together.
+Fixture that is created for a device group splits its work between member devices, so
+results of such fixture can be compared with results of every member device alone. A group of
+a single device is such a baseline: it is measured by the same host code as a group of several
+devices.
+Devices may belong to different platforms, so group doesn't belong to any platform.
+*/
+class DeviceGroup : public DeviceInterface {
+public:
+    explicit DeviceGroup(const std::vector<std::shared_ptr<DeviceInterface>>& devices)
+        : devices_(devices) {
+        if (devices_.empty()) {
+            throw std::invalid_argument("Device group cannot be empty.");
+        }
+    }
+
+    std::string Name() override { return JoinMembers(&DeviceInterface::Name); }
+
+    std::vector<std::string> Extensions() override {
+        // Only extensions that are supported by all members are available
+        std::vector<std::string> result = devices_.front()->Extensions();
+        std::sort(result.begin(), result.end());
+        for (auto iter = devices_.cbegin() + 1; iter != devices_.cend(); ++iter) {
+            std::vector<std::string> member_extensions = (*iter)->Extensions();
+            std::sort(member_extensions.begin(), member_extensions.end());
+            std::vector<std::string> intersection;
+            std::set_intersection(
+                result.cbegin(), result.cend(), member_extensions.cbegin(),
+                member_extensions.cend(), std::back_inserter(intersection));
+            result.swap(intersection);
+        }
+        return result;
+    }
+
+    std::string UniqueName() override { return JoinMembers(&DeviceInterface::UniqueName); }
+
+    std::string DriverVersion() override { return JoinMembers(&DeviceInterface::DriverVersion); }
+
+    std::weak_ptr<PlatformInterface> platform() override {
+        return std::weak_ptr<PlatformInterface>();
+    }
+
+    const std::vector<std::shared_ptr<DeviceInterface>>& devices() const { return devices_; }
+
+    // Get members of a given device type, e.g. OpenClDevice. Throws if any member has other type
+    template <typename T>
+    std::vector<std::shared_ptr<T>> DevicesAs() const {
+        std::vector<std::shared_ptr<T>> result;
+        for (const auto& device : devices_) {
+            auto casted = std::dynamic_pointer_cast<T>(device);
+            if (!casted) {
+                throw std::invalid_argument(
+                    "Device \"" + device->Name() + "\" in a device group has unexpected type.");
+            }
+            result.push_back(casted);
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::shared_ptr<DeviceInterface>> devices_;
+
+    std::string JoinMembers(std::string (DeviceInterface::*getter)()) {
+        std::string result;
+        for (const auto& device : devices_) {
+            if (!result.empty()) {
+                result += " + ";
+            }
+            result += ((*device).*getter)();
+        }
+        return result;
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DEVICES_DEVICE_GROUP_H_
@@ -14,6 +14,7 @@ public:
     virtual std::string Name() = 0;
     virtual std::vector<std::string> Extensions() = 0;
     virtual std::string UniqueName() = 0;
+    virtual std::string DriverVersion() = 0;
     virtual std::weak_ptr<PlatformInterface> platform() = 0;
     virtual ~DeviceInterface() noexcept {}
 };
@@ -0,0 +1,110 @@
+#ifndef KPV_DEVICES_HOST_DEVICE_H_
+#define KPV_DEVICES_HOST_DEVICE_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "detail/devices/device_interface.hpp"
+#include "detail/devices/platform_interface.hpp"
+#include "detail/run_settings.hpp"
+#include "detail/threading/thread_pool.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Host processor that executes fixtures natively, without OpenCL. Fixtures of this device are
+measured with a host clock, so they can be compared with OpenCL implementations of the same work.
+Fixtures run parallel loops on thread_pool() of a device. Devices of a thread sweep differ only
+by a number of threads, it is a part of their names.
+*/
+class HostDevice : public DeviceInterface {
+public:
+    // thread_count is 0 for all hardware threads
+    explicit HostDevice(
+        const std::weak_ptr<PlatformInterface>& platform, int thread_count = 0,
+        std::size_t chunk_size = 0, const std::vector<int>& pinned_cpus = std::vector<int>(),
+        bool sweep = false)
+        : platform_(platform),
+          thread_count_(thread_count > 0 ? thread_count : HardwareThreadCount()),
+          chunk_size_(chunk_size),
+          pinned_cpus_(pinned_cpus),
+          sweep_(sweep) {}
+
+    std::string Name() override {
+        if (sweep_) {
+            return "Host CPU, " + std::to_string(thread_count_) +
+                   (thread_count_ == 1 ? " thread" : " threads");
+        }
+        return "Host CPU";
+    }
+
+    std::vector<std::string> Extensions() override { return std::vector<std::string>(); }
+
+    std::string UniqueName() override { return Name(); }
+
+    std::string DriverVersion() override { return "native"; }
+
+    std::weak_ptr<PlatformInterface> platform() override { return platform_; }
+
+    int thread_count() const { return thread_count_; }
+
+    // Threads are started on first use, so devices of a sweep don't keep idle threads until then
+    ThreadPool& thread_pool() {
+        if (!thread_pool_) {
+            thread_pool_ = std::make_unique<ThreadPool>(thread_count_, chunk_size_, pinned_cpus_);
+        }
+        return *thread_pool_;
+    }
+
+    // Number of hardware threads, at least one
+    static int HardwareThreadCount() {
+        return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+    }
+
+private:
+    std::weak_ptr<PlatformInterface> platform_;
+    const int thread_count_;
+    const std::size_t chunk_size_;
+    const std::vector<int> pinned_cpus_;
+    const bool sweep_;
+    std::unique_ptr<ThreadPool> thread_pool_;
+};
+
+class HostPlatform : public PlatformInterface, public std::enable_shared_from_this<HostPlatform> {
+public:
+    // Sweep adds devices with 1, 2, 4... threads up to a configured thread count
+    void PopulateDeviceList(const DeviceConfiguration& config = DeviceConfiguration(true)) {
+        // Device needs a weak pointer to platform, so this cannot be done in a constructor
+        const int thread_count =
+            config.host_threads > 0 ? config.host_threads : HostDevice::HardwareThreadCount();
+        std::vector<int> thread_counts;
+        if (config.host_thread_sweep) {
+            for (int count = 1; count < thread_count; count *= 2) {
+                thread_counts.push_back(count);
+            }
+        }
+        thread_counts.push_back(thread_count);
+        for (int count : thread_counts) {
+            devices_.push_back(std::make_shared<HostDevice>(
+                shared_from_this(), count, config.host_chunk_size, config.host_pinned_cpus,
+                config.host_thread_sweep));
+        }
+    }
+
+    std::string Name() override { return "Host platform"; }
+
+    std::vector<std::shared_ptr<DeviceInterface>> GetDevices() override {
+        return std::vector<std::shared_ptr<DeviceInterface>>(devices_.cbegin(), devices_.cend());
+    }
+
+private:
+    std::vector<std::shared_ptr<HostDevice>> devices_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DEVICES_HOST_DEVICE_H_
@@ -2,30 +2,71 @@
 #define KPV_DEVICES_OPENCL_DEVICE_H_
 
 #include <boost/compute.hpp>
+#include <deque>
+#include <string>
 
 #include "detail/devices/device_interface.hpp"
+#include "detail/duration.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
 class OpenClDevice : public DeviceInterface {
 public:
+    // parent_name is a name of a device this one is a sub-device of, empty for whole devices
     OpenClDevice(
-        const boost::compute::device& compute_device, std::weak_ptr<PlatformInterface> platform)
+        const boost::compute::device& compute_device, std::weak_ptr<PlatformInterface> platform,
+        const std::string& parent_name = std::string())
         : device_(compute_device),
           context_(compute_device),
-          queue_(context_, compute_device, boost::compute::command_queue::enable_profiling),
-          platform_(platform) {}
+          platform_(platform),
+          parent_name_(parent_name) {
+        queues_.emplace_back(
+            context_, compute_device, boost::compute::command_queue::enable_profiling);
+    }
+
+    // Sub-devices have the same name as their parent, so a number of compute units is added
+    virtual std::string Name() override {
+        if (parent_name_.empty()) {
+            return device_.name();
+        }
+        const int units = compute_units();
+        return device_.name() + ", " + std::to_string(units) +
+               (units == 1 ? " compute unit" : " compute units");
+    }
 
-    virtual std::string Name() override { return device_.name(); }
+    // Name of a whole device, the same for a device and all its sub-devices
+    std::string RootName() { return parent_name_.empty() ? Name() : parent_name_; }
+
+    int compute_units() { return static_cast<int>(device_.compute_units()); }
 
     boost::compute::context& GetContext() { return context_; }
 
-    boost::compute::command_queue& GetQueue() { return queue_; }
+    boost::compute::command_queue& GetQueue() { return queues_.front(); }
+
+    /*
+    Get command queue with a given index, queue 0 is the same as GetQueue().
+    Additional queues are created on demand, all of them have profiling enabled.
+    Not thread-safe, so request all needed queues before submitting work from several threads.
+    */
+    boost::compute::command_queue& GetQueue(std::size_t index) {
+        while (queues_.size() <= index) {
+            queues_.emplace_back(
+                context_, device_, boost::compute::command_queue::enable_profiling);
+        }
+        return queues_[index];
+    }
 
     boost::compute::device& device() { return device_; }
 
+    Duration ProfilingTimerResolution() {
+        return Duration(std::chrono::nanoseconds(
+            device_.get_info<std::size_t>(CL_DEVICE_PROFILING_TIMER_RESOLUTION)));
+    }
+
     std::vector<std::string> Extensions() override { return device_.extensions(); }
 
+    std::string DriverVersion() override { return device_.driver_version(); }
+
     std::string UniqueName() override {
         // TODO make sure it is unique
         return Name();
@@ -36,8 +77,9 @@ public:
 private:
     boost::compute::device device_;
     boost::compute::context context_;
-    boost::compute::command_queue queue_;
+    std::deque<boost::compute::command_queue> queues_;  // Deque keeps references valid
     std::weak_ptr<PlatformInterface> platform_;
+    std::string parent_name_;
 };
 }  // namespace cl_benchmark
 }  // namespace kpv
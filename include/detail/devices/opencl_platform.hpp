@@ -1,6 +1,8 @@
 #ifndef KPV_OPENCL_PLATFORM_H_
 #define KPV_OPENCL_PLATFORM_H_
 
+#include <boost/log/trivial.hpp>
+
 #include "boost/compute.hpp"
 #include "detail/devices/opencl_device.hpp"
 #include "detail/devices/platform_interface.hpp"
@@ -39,6 +41,9 @@ public:
 
         devices_.reserve(devices.size());
         for (boost::compute::device& device : devices) {
+            if (device_config.compute_unit_sweep && (device.type() & CL_DEVICE_TYPE_CPU) != 0) {
+                AddPartitions(device);
+            }
             devices_.push_back(std::make_shared<OpenClDevice>(device, shared_from_this()));
         }
     }
@@ -49,9 +54,48 @@ public:
         return std::vector<std::shared_ptr<DeviceInterface>>(devices_.cbegin(), devices_.cend());
     }
 
+    /*
+    Sub-devices of a compute unit sweep. They share compute units with their root device, so they
+    are not returned by GetDevices(): only fixtures of a sweep run on them, they are not calibrated
+    or profiled and must not be put in a device group together with their root device.
+    */
+    std::vector<std::shared_ptr<DeviceInterface>> GetSubDevices() {
+        return std::vector<std::shared_ptr<DeviceInterface>>(
+            sub_devices_.cbegin(), sub_devices_.cend());
+    }
+
 private:
     boost::compute::platform opencl_platform_;
     std::vector<std::shared_ptr<OpenClDevice>> devices_;
+    std::vector<std::shared_ptr<OpenClDevice>> sub_devices_;
+
+    /*
+    Add sub-devices with 1, 2, 4... compute units of a device for a compute unit sweep, the whole
+    device is the last point of it. A device is partitioned equally and only the first sub-device
+    is kept, others are released.
+    */
+    void AddPartitions(const boost::compute::device& device) {
+#if defined(BOOST_COMPUTE_CL_VERSION_1_2)
+        const int compute_units = static_cast<int>(device.compute_units());
+        for (int count = 1; count < compute_units; count *= 2) {
+            try {
+                std::vector<boost::compute::device> parts = device.partition_equally(count);
+                if (!parts.empty()) {
+                    sub_devices_.push_back(std::make_shared<OpenClDevice>(
+                        parts.front(), shared_from_this(), device.name()));
+                }
+            } catch (boost::compute::opencl_error& e) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Cannot split \"" << device.name() << "\" into sub-devices with " << count
+                    << " compute units, compute unit sweep stops: " << e.what();
+                return;
+            }
+        }
+#else
+        BOOST_LOG_TRIVIAL(warning) << "Sub-devices of \"" << device.name()
+                                   << "\" need OpenCL 1.2, compute unit sweep is skipped";
+#endif
+    }
 
     template <typename T>
     void ConcatVectors(T& v1, const T& v2) {
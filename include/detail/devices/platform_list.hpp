@@ -2,11 +2,14 @@
 #define KPV_DEVICES_PLATFORM_LIST_H_
 
 #include <boost/compute.hpp>
+#include <boost/log/trivial.hpp>
 #include <memory>
 #include <vector>
 
+#include "detail/devices/host_device.hpp"
 #include "detail/devices/opencl_platform.hpp"
 #include "detail/devices/platform_interface.hpp"
+#include "detail/devices/simulated_device.hpp"
 #include "detail/run_settings.hpp"
 
 namespace kpv {
@@ -14,8 +17,16 @@ namespace cl_benchmark {
 class PlatformList {
 public:
     PlatformList(const DeviceConfiguration& device_config) {
-        std::vector<boost::compute::platform> opencl_platforms =
-            boost::compute::system::platforms();
+        std::vector<boost::compute::platform> opencl_platforms;
+        // OpenCL runtime is not touched if only simulated devices are used
+        if (device_config.cpu_opencl_devices || device_config.gpu_opencl_devices ||
+            device_config.other_opencl_devices) {
+            try {
+                opencl_platforms = boost::compute::system::platforms();
+            } catch (boost::compute::opencl_error& e) {
+                BOOST_LOG_TRIVIAL(warning) << "Cannot get OpenCL platforms: " << e.what();
+            }
+        }
         opencl_platforms_.reserve(opencl_platforms.size());
         for (boost::compute::platform& platform : opencl_platforms) {
             auto ptr = std::make_shared<OpenClPlatform>(platform);
@@ -23,18 +34,41 @@ public:
             all_platforms_.push_back(ptr);
             opencl_platforms_.push_back(ptr);
         }
-        // TODO add host platform
+        if (!device_config.simulated_devices.empty()) {
+            auto ptr = std::make_shared<SimulatedPlatform>();
+            ptr->PopulateDeviceList(device_config.simulated_devices);
+            all_platforms_.push_back(ptr);
+            simulated_platforms_.push_back(ptr);
+        }
+        if (device_config.host_device) {
+            auto ptr = std::make_shared<HostPlatform>();
+            ptr->PopulateDeviceList(device_config);
+            all_platforms_.push_back(ptr);
+            host_platforms_.push_back(ptr);
+        }
     }
 
     std::vector<std::shared_ptr<PlatformInterface>> OpenClPlatforms() const {
         return opencl_platforms_;
     }
 
+    std::vector<std::shared_ptr<PlatformInterface>> SimulatedPlatforms() const {
+        return simulated_platforms_;
+    }
+
+    // Empty or a single platform with the host processor, it has several devices in a thread
+    // sweep
+    std::vector<std::shared_ptr<PlatformInterface>> HostPlatforms() const {
+        return host_platforms_;
+    }
+
     std::vector<std::shared_ptr<PlatformInterface>> AllPlatforms() const { return all_platforms_; }
 
 private:
     std::vector<std::shared_ptr<PlatformInterface>> all_platforms_;
     std::vector<std::shared_ptr<PlatformInterface>> opencl_platforms_;
+    std::vector<std::shared_ptr<PlatformInterface>> simulated_platforms_;
+    std::vector<std::shared_ptr<PlatformInterface>> host_platforms_;
 };
 }  // namespace cl_benchmark
 }  // namespace kpv
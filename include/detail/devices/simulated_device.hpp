@@ -0,0 +1,71 @@
+#ifndef KPV_DEVICES_SIMULATED_DEVICE_H_
+#define KPV_DEVICES_SIMULATED_DEVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "detail/devices/device_interface.hpp"
+#include "detail/devices/platform_interface.hpp"
+#include "detail/simulation/duration_distribution.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Device that executes nothing, durations of its operations are taken from a distribution.
+It is used to benchmark the harness itself: runner overhead, statistics and iteration control
+can be checked on a machine without OpenCL runtime.
+*/
+class SimulatedDevice : public DeviceInterface {
+public:
+    SimulatedDevice(
+        int index, const DurationDistribution& distribution,
+        const std::weak_ptr<PlatformInterface>& platform)
+        : index_(index), distribution_(distribution), platform_(platform) {}
+
+    std::string Name() override {
+        return "Simulated device " + std::to_string(index_) + " (" +
+               distribution_.Description() + ")";
+    }
+
+    std::vector<std::string> Extensions() override { return std::vector<std::string>(); }
+
+    std::string UniqueName() override { return Name(); }
+
+    std::string DriverVersion() override { return "simulated"; }
+
+    std::weak_ptr<PlatformInterface> platform() override { return platform_; }
+
+    // Duration of the next simulated operation
+    Duration NextDuration() { return distribution_.Next(); }
+
+private:
+    int index_;
+    DurationDistribution distribution_;
+    std::weak_ptr<PlatformInterface> platform_;
+};
+
+class SimulatedPlatform : public PlatformInterface,
+                          public std::enable_shared_from_this<SimulatedPlatform> {
+public:
+    void PopulateDeviceList(const std::vector<DurationDistribution>& distributions) {
+        // Devices need a weak pointer to platform, so this cannot be done in a constructor
+        for (const DurationDistribution& distribution : distributions) {
+            devices_.push_back(std::make_shared<SimulatedDevice>(
+                static_cast<int>(devices_.size()) + 1, distribution, shared_from_this()));
+        }
+    }
+
+    std::string Name() override { return "Simulated platform"; }
+
+    std::vector<std::shared_ptr<DeviceInterface>> GetDevices() override {
+        return std::vector<std::shared_ptr<DeviceInterface>>(devices_.cbegin(), devices_.cend());
+    }
+
+private:
+    std::vector<std::shared_ptr<SimulatedDevice>> devices_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_DEVICES_SIMULATED_DEVICE_H_
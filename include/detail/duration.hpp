@@ -2,7 +2,9 @@
 #define KPV_DURATION_H_
 
 #include <chrono>
+#include <stdexcept>
 #include <string>
+#include <unordered_map>
 
 #include "nlohmann/json.hpp"
 
@@ -121,6 +123,23 @@ private:
     InternalType duration_;
 };
 
+/*
+Parse duration with a unit suffix, e.g. 100ms, 1.5ns, 9s, 30min
+*/
+inline Duration ParseDuration(const std::string& str) {
+    static const std::unordered_map<std::string /* suffix */, double /* multiplier */>
+        kTimeMultipliers = {{"ns", 1e-9}, {"mcs", 1e-6}, {"ms", 1e-3},
+                            {"s", 1},     {"min", 60},   {"h", 3600}};
+    try {
+        size_t index = 0;
+        double val = std::stod(str, &index);
+        double multiplier = kTimeMultipliers.at(str.substr(index));
+        return Duration(std::chrono::duration<double>(val * multiplier));
+    } catch (std::exception&) {
+        throw std::invalid_argument("Incorrect duration \"" + str + "\"");
+    }
+}
+
 inline void to_json(nlohmann::json& j, const kpv::cl_benchmark::Duration& p) {
     j = nlohmann::json::object({{"durationDoubleNs", p.duration().count()}});
 }
@@ -0,0 +1,42 @@
+#ifndef KPV_ENVIRONMENT_CACHE_FLUSHER_H_
+#define KPV_ENVIRONMENT_CACHE_FLUSHER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Evicts data of a fixture from host CPU caches by reading and writing a buffer that is larger
+than a last level cache. Used for cold-cache iterations.
+*/
+class CacheFlusher {
+public:
+    // 64 MiB is larger than last level cache of most desktop and server CPUs
+    static const std::size_t kDefaultSize = 64 * 1024 * 1024;
+
+    explicit CacheFlusher(std::size_t size = kDefaultSize)
+        : buffer_(size / sizeof(uint64_t) + 1, 0) {}
+
+    void Flush() {
+        // Every cache line is read and modified, the sum is stored so the loop is not removed
+        static const std::size_t kStep = 64 / sizeof(uint64_t);
+        uint64_t sum = 0;
+        for (std::size_t i = 0; i < buffer_.size(); i += kStep) {
+            sum += buffer_[i];
+            buffer_[i] = sum;
+        }
+        checksum_ = sum;
+    }
+
+    std::size_t size() const { return buffer_.size() * sizeof(uint64_t); }
+
+private:
+    std::vector<uint64_t> buffer_;
+    volatile uint64_t checksum_ = 0;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_CACHE_FLUSHER_H_
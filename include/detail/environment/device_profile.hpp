@@ -0,0 +1,268 @@
+#ifndef KPV_ENVIRONMENT_DEVICE_PROFILE_H_
+#define KPV_ENVIRONMENT_DEVICE_PROFILE_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "boost/compute.hpp"
+#include "detail/compilation/program_cache.hpp"
+#include "detail/devices/opencl_device.hpp"
+#include "detail/duration.hpp"
+#include "detail/environment/roofline_ceilings.hpp"
+#include "detail/environment/utc_time.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Peak performance of a device measured by a characterization pass. Results of fixtures are
+compared with it, so numbers of different machines can be read against a common reference.
+Profile depends on a driver, so it is identified by a device name and a driver version.
+*/
+struct DeviceProfile {
+    std::string device_name;
+    std::string driver_version;
+    std::string measurement_time;  // UTC, ISO 8601
+    RooflineCeilings ceilings;     // Global memory bandwidth and arithmetic throughput
+    double local_gbytes_per_second = 0.0;
+    Duration launch_latency;  // Host time from enqueueing an empty kernel until it is finished
+    double host_to_device_gbytes_per_second = 0.0;
+    double device_to_host_gbytes_per_second = 0.0;
+
+    static DeviceProfile Measure(OpenClDevice& device) {
+        DeviceProfile result;
+        result.device_name = device.Name();
+        result.driver_version = device.DriverVersion();
+        result.measurement_time = CurrentUtcTimeString();
+        result.ceilings = RooflineCeilings::Measure(device);
+        result.local_gbytes_per_second = MeasureLocalBandwidth(device);
+        result.launch_latency = MeasureLaunchLatency(device);
+        MeasureTransferRates(device, result);
+        return result;
+    }
+
+    void Log() const {
+        BOOST_LOG_TRIVIAL(info)
+            << "Profile of \"" << device_name << "\" (driver " << driver_version
+            << "): global memory " << ceilings.gbytes_per_second << " GB/s, local memory "
+            << local_gbytes_per_second << " GB/s, " << ceilings.single_gflops
+            << " single precision GFLOP/s, "
+            << (ceilings.double_gflops ? std::to_string(ceilings.double_gflops.value()) : "no")
+            << " double precision GFLOP/s, launch latency "
+            << launch_latency.duration().count() << " ns, host to device "
+            << host_to_device_gbytes_per_second << " GB/s, device to host "
+            << device_to_host_gbytes_per_second << " GB/s";
+    }
+
+private:
+    static constexpr std::size_t kTransferBufferSize = 64 * 1024 * 1024;
+    // Every work-item reads kLocalIterations vectors of 4 floats from local memory
+    static constexpr int kLocalIterations = 1024;
+    static constexpr std::size_t kLocalItemsPerUnit = 2048;
+    static constexpr std::size_t kMaxLocalSize = 256;
+    static constexpr int kLatencySampleCount = 101;
+
+    static const char* ProgramCode() {
+        return R"(
+// Local size is a power of two, so a mask replaces a modulo. Index changes every iteration, so
+// reads can't be hoisted out of the loop
+__kernel void LocalBandwidth(__global float* output, __local float4* scratch)
+{
+    const uint local_id = get_local_id(0);
+    const uint mask = get_local_size(0) - 1;
+    scratch[local_id] = (float4)(local_id);
+    barrier(CLK_LOCAL_MEM_FENCE);
+    float4 sum = 0;
+    for (uint i = 0; i < LOCAL_ITERATIONS; ++i) {
+        sum += scratch[(local_id + i) & mask];
+    }
+    output[get_global_id(0)] = sum.x + sum.y + sum.z + sum.w;
+}
+
+__kernel void Empty(__global float* output)
+{
+}
+)";
+    }
+
+    static boost::compute::kernel CreateKernel(OpenClDevice& device, const char* name) {
+        ProgramSource program_source;
+        program_source.context = device.GetContext();
+        program_source.source = ProgramCode();
+        program_source.options = "-DLOCAL_ITERATIONS=" + std::to_string(kLocalIterations);
+        return BuildProgram(program_source).create_kernel(name);
+    }
+
+    static double MeasureLocalBandwidth(OpenClDevice& device) {
+        boost::compute::kernel kernel = CreateKernel(device, "LocalBandwidth");
+        const std::size_t max_group_size = kernel.get_work_group_info<std::size_t>(
+            device.device(), CL_KERNEL_WORK_GROUP_SIZE);
+        std::size_t local_size = 1;
+        while (local_size * 2 <= std::min<std::size_t>(max_group_size, kMaxLocalSize)) {
+            local_size *= 2;
+        }
+        const std::size_t compute_units =
+            std::max<std::size_t>(device.device().compute_units(), 1);
+        const std::size_t global_size = compute_units * kLocalItemsPerUnit;
+        boost::compute::buffer output(device.GetContext(), global_size * sizeof(cl_float));
+        kernel.set_arg(0, output);
+        kernel.set_arg(1, boost::compute::local_buffer<cl_float4>(local_size));
+        const Duration duration =
+            BestKernelLaunch(device.GetQueue(), kernel, global_size, local_size);
+        const double bytes = static_cast<double>(global_size) * kLocalIterations *
+                             sizeof(cl_float4);
+        return bytes / duration.AsSeconds() / 1e9;
+    }
+
+    // Median of host round trips, since a single slow one is usually an interruption
+    static Duration MeasureLaunchLatency(OpenClDevice& device) {
+        boost::compute::kernel kernel = CreateKernel(device, "Empty");
+        boost::compute::buffer output(device.GetContext(), sizeof(cl_float));
+        kernel.set_arg(0, output);
+        boost::compute::command_queue& queue = device.GetQueue();
+        queue.enqueue_1d_range_kernel(kernel, 0, 1, 0).wait();
+        std::vector<Duration> samples;
+        for (int i = 0; i < kLatencySampleCount; ++i) {
+            const auto start = std::chrono::steady_clock::now();
+            queue.enqueue_1d_range_kernel(kernel, 0, 1, 0).wait();
+            samples.push_back(Duration(std::chrono::steady_clock::now() - start));
+        }
+        std::nth_element(samples.begin(), samples.begin() + samples.size() / 2, samples.end());
+        return samples[samples.size() / 2];
+    }
+
+    // Fastest of several blocking copies of a large buffer, measured with a profiling timer
+    static void MeasureTransferRates(OpenClDevice& device, DeviceProfile& profile) {
+        static const int kCopyCount = 5;
+        const std::size_t max_allocation = static_cast<std::size_t>(
+            device.device().get_info<cl_ulong>(CL_DEVICE_MAX_MEM_ALLOC_SIZE));
+        const std::size_t buffer_size = kTransferBufferSize;
+        const std::size_t size = std::min(buffer_size, max_allocation);
+        std::vector<char> host_data(size, 1);
+        boost::compute::buffer buffer(device.GetContext(), size);
+        boost::compute::command_queue& queue = device.GetQueue();
+        Duration best_write = Duration::Max();
+        Duration best_read = Duration::Max();
+        // The first copy of every direction is a warm-up
+        for (int i = 0; i <= kCopyCount; ++i) {
+            boost::compute::event write =
+                queue.enqueue_write_buffer_async(buffer, 0, size, host_data.data());
+            write.wait();
+            boost::compute::event read =
+                queue.enqueue_read_buffer_async(buffer, 0, size, host_data.data());
+            read.wait();
+            if (i > 0) {
+                best_write =
+                    std::min(best_write, Duration{write.duration<Duration::InternalType>()});
+                best_read = std::min(best_read, Duration{read.duration<Duration::InternalType>()});
+            }
+        }
+        profile.host_to_device_gbytes_per_second = size / best_write.AsSeconds() / 1e9;
+        profile.device_to_host_gbytes_per_second = size / best_read.AsSeconds() / 1e9;
+    }
+};
+
+inline void to_json(nlohmann::json& j, const DeviceProfile& p) {
+    j = nlohmann::json::object(
+        {{"device", p.device_name},
+         {"driverVersion", p.driver_version},
+         {"measurementTime", p.measurement_time},
+         {"globalGbytesPerSecond", p.ceilings.gbytes_per_second},
+         {"localGbytesPerSecond", p.local_gbytes_per_second},
+         {"singleGflops", p.ceilings.single_gflops},
+         {"launchLatency", p.launch_latency},
+         {"hostToDeviceGbytesPerSecond", p.host_to_device_gbytes_per_second},
+         {"deviceToHostGbytesPerSecond", p.device_to_host_gbytes_per_second}});
+    if (p.ceilings.double_gflops) {
+        j["doubleGflops"] = p.ceilings.double_gflops.value();
+    }
+}
+
+inline void from_json(const nlohmann::json& j, DeviceProfile& p) {
+    p.device_name = j.at("device").get<std::string>();
+    p.driver_version = j.at("driverVersion").get<std::string>();
+    p.measurement_time = j.value("measurementTime", std::string());
+    p.ceilings.gbytes_per_second = j.at("globalGbytesPerSecond").get<double>();
+    p.ceilings.single_gflops = j.at("singleGflops").get<double>();
+    p.ceilings.double_gflops = boost::none;
+    if (j.count("doubleGflops") > 0) {
+        p.ceilings.double_gflops = j.at("doubleGflops").get<double>();
+    }
+    p.local_gbytes_per_second = j.at("localGbytesPerSecond").get<double>();
+    p.launch_latency = j.at("launchLatency").get<Duration>();
+    p.host_to_device_gbytes_per_second = j.at("hostToDeviceGbytesPerSecond").get<double>();
+    p.device_to_host_gbytes_per_second = j.at("deviceToHostGbytesPerSecond").get<double>();
+}
+
+/*
+File with profiles of all characterized devices, a profile of a device with the same name and
+driver version is replaced when it is measured again. Missing file is the same as an empty one.
+*/
+class DeviceProfileStore {
+public:
+    explicit DeviceProfileStore(const std::string& file_name) : file_name_(file_name) {
+        std::ifstream file(file_name_);
+        if (!file) {
+            return;
+        }
+        try {
+            nlohmann::json tree;
+            file >> tree;
+            for (const nlohmann::json& data : tree.at("profiles")) {
+                Add(data.get<DeviceProfile>());
+            }
+        } catch (std::exception& e) {
+            profiles_.clear();
+            BOOST_LOG_TRIVIAL(warning) << "Device profile file " << file_name_
+                                       << " cannot be read, profiles are ignored: " << e.what();
+        }
+    }
+
+    boost::optional<DeviceProfile> Find(
+        const std::string& device_name, const std::string& driver_version) const {
+        auto iter = profiles_.find(Key(device_name, driver_version));
+        if (iter == profiles_.end()) {
+            return boost::none;
+        }
+        return iter->second;
+    }
+
+    void Add(const DeviceProfile& profile) {
+        profiles_[Key(profile.device_name, profile.driver_version)] = profile;
+    }
+
+    void Save() const {
+        nlohmann::json tree = {
+            {"formatVersion", "0.1.0"}, {"profiles", nlohmann::json::array()}};
+        for (const auto& p : profiles_) {
+            tree["profiles"].push_back(p.second);
+        }
+        std::ofstream file(file_name_);
+        file << std::setw(4) << tree << std::endl;
+        if (!file) {
+            throw std::runtime_error("Cannot write device profile file " + file_name_);
+        }
+    }
+
+    std::size_t size() const { return profiles_.size(); }
+
+private:
+    using Key = std::pair<std::string /* device name */, std::string /* driver version */>;
+
+    std::string file_name_;
+    std::map<Key, DeviceProfile> profiles_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_DEVICE_PROFILE_H_
@@ -0,0 +1,164 @@
+#ifndef KPV_ENVIRONMENT_HOST_ENVIRONMENT_H_
+#define KPV_ENVIRONMENT_HOST_ENVIRONMENT_H_
+
+#include <algorithm>
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "detail/environment/thread_affinity.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Information about host system that affects benchmark results and their stability.
+Collected once before running fixtures and stored in a report, so results from different
+machines (or from the same machine in a different state) can be compared.
+Most of the values are available on Linux only, they are left empty on other systems.
+*/
+struct HostEnvironment {
+    std::string cpu_model;
+    std::string kernel_version;
+    std::vector<std::string> frequency_governors;  // Unique governors of all online CPUs
+    boost::optional<bool> turbo_enabled;
+    boost::optional<bool> smt_enabled;
+    std::vector<double> load_average;  // 1, 5 and 15 minutes
+    std::vector<int> pinned_cpus;
+
+    static HostEnvironment Collect() {
+        HostEnvironment result;
+        result.cpu_model = ReadCpuModel();
+        result.kernel_version = ReadFirstLine("/proc/sys/kernel/osrelease").value_or("");
+        result.frequency_governors = ReadGovernors();
+        result.turbo_enabled = ReadTurboStatus();
+        boost::optional<std::string> smt = ReadFirstLine("/sys/devices/system/cpu/smt/active");
+        if (smt) {
+            result.smt_enabled = (smt.value() == "1");
+        }
+        boost::optional<std::string> load = ReadFirstLine("/proc/loadavg");
+        if (load) {
+            std::istringstream stream(load.value());
+            double val = 0.0;
+            for (int i = 0; i < 3 && (stream >> val); ++i) {
+                result.load_average.push_back(val);
+            }
+        }
+        return result;
+    }
+
+    /*
+    Write warnings about system settings that are known to increase run-to-run variance.
+    */
+    void LogWarnings() const {
+        for (const std::string& governor : frequency_governors) {
+            if (governor != "performance") {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "CPU frequency governor is \"" << governor
+                    << "\" instead of \"performance\", results may be unstable";
+            }
+        }
+        if (turbo_enabled && turbo_enabled.value()) {
+            BOOST_LOG_TRIVIAL(warning) << "CPU turbo boost is enabled, results may be unstable";
+        }
+        if (smt_enabled && smt_enabled.value()) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Simultaneous multithreading (SMT) is enabled, results may be unstable";
+        }
+        if (!load_average.empty() && load_average.front() >= 1.0) {
+            BOOST_LOG_TRIVIAL(warning) << "System load average is " << load_average.front()
+                                       << ", other processes may affect results";
+        }
+    }
+
+private:
+    static boost::optional<std::string> ReadFirstLine(const std::string& file_name) {
+        std::ifstream file(file_name);
+        std::string line;
+        if (!file || !std::getline(file, line)) {
+            return boost::none;
+        }
+        boost::algorithm::trim(line);
+        return line;
+    }
+
+    static std::string ReadCpuModel() {
+        std::ifstream file("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(file, line)) {
+            if (boost::algorithm::starts_with(line, "model name")) {
+                std::size_t pos = line.find(':');
+                if (pos != std::string::npos) {
+                    std::string model = line.substr(pos + 1);
+                    boost::algorithm::trim(model);
+                    return model;
+                }
+            }
+        }
+        return std::string();
+    }
+
+    static std::vector<std::string> ReadGovernors() {
+        std::vector<std::string> result;
+        boost::optional<std::string> online = ReadFirstLine("/sys/devices/system/cpu/online");
+        if (!online) {
+            return result;
+        }
+        std::vector<int> cpus;
+        try {
+            cpus = ParseCpuList(online.value());
+        } catch (std::exception&) {
+            return result;
+        }
+        for (int cpu : cpus) {
+            boost::optional<std::string> governor = ReadFirstLine(
+                "/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                "/cpufreq/scaling_governor");
+            if (governor &&
+                std::find(result.cbegin(), result.cend(), governor.value()) == result.cend()) {
+                result.push_back(governor.value());
+            }
+        }
+        return result;
+    }
+
+    static boost::optional<bool> ReadTurboStatus() {
+        // intel_pstate driver reports inverted value
+        boost::optional<std::string> no_turbo =
+            ReadFirstLine("/sys/devices/system/cpu/intel_pstate/no_turbo");
+        if (no_turbo) {
+            return no_turbo.value() == "0";
+        }
+        // acpi-cpufreq and others
+        boost::optional<std::string> cpufreq_boost =
+            ReadFirstLine("/sys/devices/system/cpu/cpufreq/boost");
+        if (cpufreq_boost) {
+            return cpufreq_boost.value() == "1";
+        }
+        return boost::none;
+    }
+};
+
+inline void to_json(nlohmann::json& j, const HostEnvironment& e) {
+    j = nlohmann::json::object(
+        {{"cpuModel", e.cpu_model},
+         {"kernelVersion", e.kernel_version},
+         {"frequencyGovernors", e.frequency_governors},
+         {"loadAverage", e.load_average},
+         {"pinnedCpus", e.pinned_cpus}});
+    if (e.turbo_enabled) {
+        j["turboEnabled"] = e.turbo_enabled.value();
+    }
+    if (e.smt_enabled) {
+        j["smtEnabled"] = e.smt_enabled.value();
+    }
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_HOST_ENVIRONMENT_H_
@@ -0,0 +1,146 @@
+#ifndef KPV_ENVIRONMENT_HOST_SENSORS_H_
+#define KPV_ENVIRONMENT_HOST_SENSORS_H_
+
+#include <algorithm>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/optional.hpp>
+#include <fstream>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "detail/environment/thread_affinity.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+CPU frequency and temperatures of a host at one moment
+*/
+struct HostSensorReading {
+    boost::optional<double> mean_frequency_mhz;  // Over watched CPUs
+    boost::optional<double> min_frequency_mhz;
+    std::map<std::string, double> temperatures;  // Hottest zone of every type, Celsius
+};
+
+inline void to_json(nlohmann::json& j, const HostSensorReading& r) {
+    j = nlohmann::json::object();
+    if (r.mean_frequency_mhz) {
+        j["meanFrequencyMhz"] = r.mean_frequency_mhz.value();
+    }
+    if (r.min_frequency_mhz) {
+        j["minFrequencyMhz"] = r.min_frequency_mhz.value();
+    }
+    if (!r.temperatures.empty()) {
+        j["temperatures"] = r.temperatures;
+    }
+}
+
+inline void from_json(const nlohmann::json& j, HostSensorReading& r) {
+    r = HostSensorReading();
+    if (j.count("meanFrequencyMhz") > 0) {
+        r.mean_frequency_mhz = j.at("meanFrequencyMhz").get<double>();
+    }
+    if (j.count("minFrequencyMhz") > 0) {
+        r.min_frequency_mhz = j.at("minFrequencyMhz").get<double>();
+    }
+    if (j.count("temperatures") > 0) {
+        r.temperatures = j.at("temperatures").get<std::map<std::string, double>>();
+    }
+}
+
+/*
+Current CPU frequency (cpufreq) and thermal zones from /sys. Files are found once, so a reading
+is a few small file reads that can be taken right before and after a timed loop. Frequency is
+read for CPUs a runner is pinned to, or for all online CPUs. Sensors are available on Linux only,
+on other systems Read() returns nothing.
+*/
+class HostSensors {
+public:
+    static HostSensors Discover(const std::vector<int>& pinned_cpus) {
+        HostSensors result;
+        std::vector<int> cpus = pinned_cpus;
+        if (cpus.empty()) {
+            std::ifstream online("/sys/devices/system/cpu/online");
+            std::string line;
+            if (std::getline(online, line)) {
+                try {
+                    cpus = ParseCpuList(line);
+                } catch (std::exception&) {
+                    cpus.clear();
+                }
+            }
+        }
+        for (int cpu : cpus) {
+            std::string file_name = "/sys/devices/system/cpu/cpu" + std::to_string(cpu) +
+                                    "/cpufreq/scaling_cur_freq";
+            if (ReadNumber(file_name)) {
+                result.frequency_files_.push_back(file_name);
+            }
+        }
+        // Zones are numbered without gaps
+        for (int zone = 0;; ++zone) {
+            const std::string directory = "/sys/class/thermal/thermal_zone" + std::to_string(zone);
+            std::ifstream type_file(directory + "/type");
+            std::string type;
+            if (!type_file || !std::getline(type_file, type)) {
+                break;
+            }
+            boost::algorithm::trim(type);
+            if (ReadNumber(directory + "/temp")) {
+                result.temperature_files_.emplace_back(type, directory + "/temp");
+            }
+        }
+        return result;
+    }
+
+    bool empty() const { return frequency_files_.empty() && temperature_files_.empty(); }
+
+    boost::optional<HostSensorReading> Read() const {
+        if (empty()) {
+            return boost::none;
+        }
+        HostSensorReading result;
+        double sum = 0.0;
+        int count = 0;
+        for (const std::string& file_name : frequency_files_) {
+            boost::optional<double> khz = ReadNumber(file_name);
+            if (khz) {
+                const double mhz = khz.value() / 1000.0;
+                sum += mhz;
+                ++count;
+                result.min_frequency_mhz = std::min(result.min_frequency_mhz.value_or(mhz), mhz);
+            }
+        }
+        if (count > 0) {
+            result.mean_frequency_mhz = sum / count;
+        }
+        for (const auto& zone : temperature_files_) {
+            boost::optional<double> millidegrees = ReadNumber(zone.second);
+            if (millidegrees) {
+                const double celsius = millidegrees.value() / 1000.0;
+                auto iter = result.temperatures.emplace(zone.first, celsius).first;
+                iter->second = std::max(iter->second, celsius);
+            }
+        }
+        return result;
+    }
+
+private:
+    std::vector<std::string> frequency_files_;
+    std::vector<std::pair<std::string /* type */, std::string /* file */>> temperature_files_;
+
+    static boost::optional<double> ReadNumber(const std::string& file_name) {
+        std::ifstream file(file_name);
+        double value = 0.0;
+        if (!file || !(file >> value)) {
+            return boost::none;
+        }
+        return value;
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_HOST_SENSORS_H_
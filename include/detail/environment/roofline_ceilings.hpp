@@ -0,0 +1,187 @@
+#ifndef KPV_ENVIRONMENT_ROOFLINE_CEILINGS_H_
+#define KPV_ENVIRONMENT_ROOFLINE_CEILINGS_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "boost/compute.hpp"
+#include "detail/compilation/program_cache.hpp"
+#include "detail/devices/opencl_device.hpp"
+#include "detail/duration.hpp"
+#include "detail/fixtures/fixture.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Duration of the fastest of several launches of a kernel measured with a profiling timer, the
+first launch is a warm-up. Local size is chosen by an implementation if it is zero.
+*/
+inline Duration BestKernelLaunch(
+    boost::compute::command_queue& queue, boost::compute::kernel& kernel, std::size_t global_size,
+    std::size_t local_size = 0) {
+    static const int kLaunchCount = 5;
+    queue.enqueue_1d_range_kernel(kernel, 0, global_size, local_size).wait();
+    Duration best = Duration::Max();
+    for (int i = 0; i < kLaunchCount; ++i) {
+        boost::compute::event event =
+            queue.enqueue_1d_range_kernel(kernel, 0, global_size, local_size);
+        event.wait();
+        best = std::min(best, Duration{event.duration<Duration::InternalType>()});
+    }
+    return best;
+}
+
+/*
+Measured global memory bandwidth and arithmetic throughput of a device. They are the two
+ceilings of a roofline model: a kernel with arithmetic intensity I (flops per byte) can't be
+faster than min(peak flops, bandwidth * I).
+*/
+struct RooflineCeilings {
+    double gbytes_per_second = 0.0;
+    double single_gflops = 0.0;
+    boost::optional<double> double_gflops;  // Known for devices with cl_khr_fp64 only
+
+    boost::optional<double> PeakGflops(WorkAmount::Precision precision) const {
+        if (precision == WorkAmount::Precision::kDouble) {
+            return double_gflops;
+        }
+        return single_gflops;
+    }
+
+    /*
+    Bandwidth is measured with a copy kernel over buffers much larger than device caches,
+    throughput with a kernel of independent chains of multiply-add operations. Every kernel is
+    launched once for warm-up and then several times, the fastest launch is used.
+    */
+    static RooflineCeilings Measure(OpenClDevice& device) {
+        std::vector<std::string> extensions = device.Extensions();
+        const bool has_fp64 =
+            std::find(extensions.cbegin(), extensions.cend(), "cl_khr_fp64") != extensions.cend();
+
+        RooflineCeilings result;
+        result.gbytes_per_second = MeasureBandwidth(device);
+        result.single_gflops = MeasureThroughput(device, "float");
+        if (has_fp64) {
+            result.double_gflops = MeasureThroughput(device, "double");
+        }
+        BOOST_LOG_TRIVIAL(info) << "Roofline ceilings of \"" << device.UniqueName() << "\": "
+                                << result.gbytes_per_second << " GB/s, " << result.single_gflops
+                                << " single precision GFLOP/s";
+        return result;
+    }
+
+private:
+    static constexpr std::size_t kBandwidthBufferSize = 64 * 1024 * 1024;
+    // Work-items per compute unit and chain length of a throughput kernel. Every iteration
+    // makes kChainCount multiply-adds, i.e. 2 * kChainCount flops
+    static constexpr std::size_t kThroughputItemsPerUnit = 2048;
+    static constexpr int kThroughputIterations = 256;
+    static constexpr int kChainCount = 8;
+
+    static const char* ProgramCode() {
+        return R"(
+__kernel void CopyBandwidth(__global const float4* input, __global float4* output)
+{
+    const size_t id = get_global_id(0);
+    output[id] = input[id];
+}
+
+// Chains are independent, so a device may overlap their latencies. Sum is written, so the
+// compiler can't remove calculations
+__kernel void MadThroughput(__global T* output, T multiplier, T addend)
+{
+    T a0 = (T)get_global_id(0);
+    T a1 = a0 + 1;
+    T a2 = a0 + 2;
+    T a3 = a0 + 3;
+    T a4 = a0 + 4;
+    T a5 = a0 + 5;
+    T a6 = a0 + 6;
+    T a7 = a0 + 7;
+    for (int i = 0; i < ITERATIONS; ++i) {
+        a0 = mad(a0, multiplier, addend);
+        a1 = mad(a1, multiplier, addend);
+        a2 = mad(a2, multiplier, addend);
+        a3 = mad(a3, multiplier, addend);
+        a4 = mad(a4, multiplier, addend);
+        a5 = mad(a5, multiplier, addend);
+        a6 = mad(a6, multiplier, addend);
+        a7 = mad(a7, multiplier, addend);
+    }
+    output[get_global_id(0)] = a0 + a1 + a2 + a3 + a4 + a5 + a6 + a7;
+}
+)";
+    }
+
+    static boost::compute::program BuildMeasurementProgram(
+        OpenClDevice& device, const std::string& type_name) {
+        ProgramSource program_source;
+        program_source.context = device.GetContext();
+        program_source.source = ProgramCode();
+        if (type_name == "double") {
+            program_source.source = "#pragma OPENCL EXTENSION cl_khr_fp64 : enable\n" +
+                                    program_source.source;
+        }
+        program_source.options = "-DT=" + type_name +
+                                 " -DITERATIONS=" + std::to_string(kThroughputIterations);
+        return BuildProgram(program_source);
+    }
+
+    static double MeasureBandwidth(OpenClDevice& device) {
+        boost::compute::program program = BuildMeasurementProgram(device, "float");
+        boost::compute::kernel kernel = program.create_kernel("CopyBandwidth");
+        const std::size_t max_allocation = static_cast<std::size_t>(
+            device.device().get_info<cl_ulong>(CL_DEVICE_MAX_MEM_ALLOC_SIZE));
+        const std::size_t buffer_size = kBandwidthBufferSize;
+        const std::size_t element_size = 4 * sizeof(cl_float);
+        const std::size_t element_count = std::min(buffer_size, max_allocation) / element_size;
+        boost::compute::buffer input(device.GetContext(), element_count * element_size);
+        boost::compute::buffer output(device.GetContext(), element_count * element_size);
+        kernel.set_arg(0, input);
+        kernel.set_arg(1, output);
+        const Duration duration = BestKernelLaunch(device.GetQueue(), kernel, element_count);
+        // Every element is read once and written once
+        return 2.0 * element_count * element_size / duration.AsSeconds() / 1e9;
+    }
+
+    static double MeasureThroughput(OpenClDevice& device, const std::string& type_name) {
+        boost::compute::program program = BuildMeasurementProgram(device, type_name);
+        boost::compute::kernel kernel = program.create_kernel("MadThroughput");
+        const std::size_t compute_units =
+            std::max<std::size_t>(device.device().compute_units(), 1);
+        const std::size_t global_size = compute_units * kThroughputItemsPerUnit;
+        const std::size_t value_size =
+            type_name == "double" ? sizeof(cl_double) : sizeof(cl_float);
+        boost::compute::buffer output(device.GetContext(), global_size * value_size);
+        kernel.set_arg(0, output);
+        // Values converge to addend / (1 - multiplier), so they never overflow
+        if (type_name == "double") {
+            kernel.set_arg(1, cl_double(0.999));
+            kernel.set_arg(2, cl_double(0.001));
+        } else {
+            kernel.set_arg(1, cl_float(0.999f));
+            kernel.set_arg(2, cl_float(0.001f));
+        }
+        const Duration duration = BestKernelLaunch(device.GetQueue(), kernel, global_size);
+        const double flops =
+            2.0 * kChainCount * kThroughputIterations * static_cast<double>(global_size);
+        return flops / duration.AsSeconds() / 1e9;
+    }
+};
+
+inline void to_json(nlohmann::json& j, const RooflineCeilings& c) {
+    j = nlohmann::json::object(
+        {{"gbytesPerSecond", c.gbytes_per_second}, {"singleGflops", c.single_gflops}});
+    if (c.double_gflops) {
+        j["doubleGflops"] = c.double_gflops.value();
+    }
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_ROOFLINE_CEILINGS_H_
@@ -0,0 +1,116 @@
+#ifndef KPV_ENVIRONMENT_THREAD_AFFINITY_H_
+#define KPV_ENVIRONMENT_THREAD_AFFINITY_H_
+
+#include <algorithm>
+#include <boost/algorithm/string/trim.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/tokenizer.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__linux__)
+#include <pthread.h>
+#include <sched.h>
+#elif defined(_WIN32)
+#include <windows.h>
+#endif
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Parse a list of CPU indices in Linux "cpulist" format, e.g. "0,2,4-7".
+Same format is used by /sys/devices/system/cpu/online, so it is used to parse it as well.
+Result is sorted and has no duplicates.
+*/
+inline std::vector<int> ParseCpuList(const std::string& cpu_list) {
+    std::vector<int> result;
+    boost::char_separator<char> comma(",");
+    boost::tokenizer<boost::char_separator<char>> tokenizer(cpu_list, comma);
+    for (std::string token : tokenizer) {
+        boost::algorithm::trim(token);
+        if (token.empty()) {
+            continue;
+        }
+        try {
+            std::size_t dash_pos = token.find('-');
+            std::size_t index = 0;
+            if (dash_pos == std::string::npos) {
+                int cpu = std::stoi(token, &index);
+                if (index != token.size() || cpu < 0) {
+                    throw std::invalid_argument("");
+                }
+                result.push_back(cpu);
+            } else {
+                std::string first_str = token.substr(0, dash_pos);
+                std::string last_str = token.substr(dash_pos + 1);
+                int first = std::stoi(first_str, &index);
+                if (index != first_str.size()) {
+                    throw std::invalid_argument("");
+                }
+                int last = std::stoi(last_str, &index);
+                if (index != last_str.size() || first < 0 || last < first) {
+                    throw std::invalid_argument("");
+                }
+                for (int cpu = first; cpu <= last; ++cpu) {
+                    result.push_back(cpu);
+                }
+            }
+        } catch (std::exception&) {
+            throw std::invalid_argument("Incorrect CPU list item \"" + token + "\"");
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+/*
+Pin calling thread to given set of logical CPUs. Empty list means no pinning.
+Returns true if affinity was changed successfully.
+Runner calls it for its own thread, host worker threads should call it as well so they
+share the same CPU set.
+*/
+inline bool PinCurrentThread(const std::vector<int>& cpus) {
+    if (cpus.empty()) {
+        return false;
+    }
+#if defined(__linux__)
+    cpu_set_t cpu_set;
+    CPU_ZERO(&cpu_set);
+    for (int cpu : cpus) {
+        if (cpu >= CPU_SETSIZE) {
+            BOOST_LOG_TRIVIAL(warning) << "CPU index " << cpu << " is too big, ignoring it";
+            continue;
+        }
+        CPU_SET(cpu, &cpu_set);
+    }
+    int error = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set), &cpu_set);
+    if (error != 0) {
+        BOOST_LOG_TRIVIAL(warning) << "Cannot set thread affinity, error code " << error;
+        return false;
+    }
+    return true;
+#elif defined(_WIN32)
+    DWORD_PTR mask = 0;
+    for (int cpu : cpus) {
+        if (cpu >= static_cast<int>(sizeof(DWORD_PTR) * 8)) {
+            BOOST_LOG_TRIVIAL(warning) << "CPU index " << cpu << " is too big, ignoring it";
+            continue;
+        }
+        mask |= DWORD_PTR(1) << cpu;
+    }
+    if (SetThreadAffinityMask(GetCurrentThread(), mask) == 0) {
+        BOOST_LOG_TRIVIAL(warning) << "Cannot set thread affinity, error code " << GetLastError();
+        return false;
+    }
+    return true;
+#else
+    BOOST_LOG_TRIVIAL(warning) << "Thread pinning is not supported on this platform";
+    return false;
+#endif
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_THREAD_AFFINITY_H_
@@ -0,0 +1,218 @@
+#ifndef KPV_ENVIRONMENT_TIMER_CALIBRATION_H_
+#define KPV_ENVIRONMENT_TIMER_CALIBRATION_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "boost/compute.hpp"
+#include "detail/devices/device_group.hpp"
+#include "detail/devices/host_device.hpp"
+#include "detail/devices/opencl_device.hpp"
+#include "detail/devices/platform_list.hpp"
+#include "detail/duration.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Properties of std::chrono::steady_clock, that is used for all host measurements
+*/
+struct HostClockInfo {
+    Duration read_overhead;  // Average duration of one clock read
+    Duration resolution;     // Smallest observed difference between two reads
+};
+
+/*
+Properties of a profiling timer of a device. Offset and drift relate device timestamps to
+steady_clock of a host: device_time = host_time + offset + drift * (host_time - reference_time).
+Known for OpenCL devices only.
+*/
+struct DeviceClockInfo {
+    Duration resolution;
+    boost::optional<double> offset;  // Nanoseconds at reference time
+    boost::optional<double> drift;   // Relative rate difference, e.g. 1e-6 is 1 ppm
+    double reference_time = 0.0;     // Host steady_clock time, nanoseconds
+};
+
+/*
+Calibration of host and device timers made once before running fixtures
+*/
+struct TimerCalibration {
+    HostClockInfo host;
+    std::map<std::string /* unique device name */, DeviceClockInfo> devices;
+
+    static TimerCalibration Collect(const PlatformList& platform_list) {
+        TimerCalibration result;
+        result.host = MeasureHostClock();
+        for (auto& platform : platform_list.OpenClPlatforms()) {
+            for (auto& device : platform->GetDevices()) {
+                auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device);
+                if (opencl_device) {
+                    result.devices.emplace(
+                        opencl_device->UniqueName(), MeasureOpenClClock(*opencl_device));
+                }
+            }
+        }
+        return result;
+    }
+
+    /*
+    Resolution of a timer used to measure fixtures of a device. Device groups and the host
+    device are measured on a host. Simulated devices have no timer.
+    */
+    boost::optional<Duration> Resolution(const std::shared_ptr<DeviceInterface>& device) const {
+        if (std::dynamic_pointer_cast<DeviceGroup>(device) ||
+            std::dynamic_pointer_cast<HostDevice>(device)) {
+            return host.resolution;
+        }
+        auto iter = devices.find(device->UniqueName());
+        if (iter != devices.end()) {
+            return iter->second.resolution;
+        }
+        return boost::none;
+    }
+
+    void Log() const {
+        BOOST_LOG_TRIVIAL(info) << "Host clock resolution is "
+                                << host.resolution.duration().count() << " ns, read takes "
+                                << host.read_overhead.duration().count() << " ns";
+        for (const auto& p : devices) {
+            BOOST_LOG_TRIVIAL(info) << "Profiling timer resolution of \"" << p.first << "\" is "
+                                    << p.second.resolution.duration().count() << " ns";
+            if (p.second.drift) {
+                BOOST_LOG_TRIVIAL(info) << "Profiling timer of \"" << p.first << "\" drifts by "
+                                        << p.second.drift.value() * 1e6
+                                        << " ppm relative to host clock";
+            }
+        }
+    }
+
+private:
+    static HostClockInfo MeasureHostClock() {
+        static const int kReadCount = 100000;
+        const auto start = std::chrono::steady_clock::now();
+        auto previous = start;
+        auto resolution = std::chrono::steady_clock::duration::max();
+        for (int i = 0; i < kReadCount; ++i) {
+            auto now = std::chrono::steady_clock::now();
+            if (now != previous) {
+                resolution = std::min(resolution, now - previous);
+                previous = now;
+            }
+        }
+        const auto end = std::chrono::steady_clock::now();
+
+        HostClockInfo result;
+        result.read_overhead = Duration(end - start) / kReadCount;
+        if (resolution == std::chrono::steady_clock::duration::max()) {
+            // Clock did not change at all, only its nominal period is known
+            resolution = std::chrono::steady_clock::duration(1);
+        }
+        result.resolution = Duration(resolution);
+        return result;
+    }
+
+    /*
+    Offset is sampled several times with tiny writes: device timestamp of a command being queued
+    is compared with the middle of a host interval around the enqueue call. Drift is a slope of
+    a least squares line through the samples, so it is rough for a short calibration.
+    */
+    static DeviceClockInfo MeasureOpenClClock(OpenClDevice& device) {
+        static const int kSampleCount = 16;
+        static const std::chrono::milliseconds kSampleInterval(5);
+
+        DeviceClockInfo result;
+        result.resolution = device.ProfilingTimerResolution();
+        try {
+            boost::compute::command_queue& queue = device.GetQueue();
+            boost::compute::buffer buffer(device.GetContext(), sizeof(cl_int));
+            cl_int value = 0;
+            boost::optional<int64_t> base_offset;
+            std::vector<double> host_times;
+            std::vector<double> offsets;
+            for (int i = 0; i < kSampleCount; ++i) {
+                const auto before = std::chrono::steady_clock::now();
+                boost::compute::event event =
+                    queue.enqueue_write_buffer_async(buffer, 0, sizeof(value), &value);
+                const auto after = std::chrono::steady_clock::now();
+                event.wait();
+                const int64_t host_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                              (before + (after - before) / 2).time_since_epoch())
+                                              .count();
+                const int64_t device_time = static_cast<int64_t>(
+                    event.get_profiling_info<cl_ulong>(CL_PROFILING_COMMAND_QUEUED));
+                // Offsets are taken relative to the first one in integers, since timestamps are
+                // too large for double precision
+                if (!base_offset) {
+                    base_offset = device_time - host_time;
+                }
+                host_times.push_back(static_cast<double>(host_time));
+                offsets.push_back(static_cast<double>(device_time - host_time - *base_offset));
+                std::this_thread::sleep_for(kSampleInterval);
+            }
+            FitLine(host_times, offsets, result);
+            *result.offset += static_cast<double>(*base_offset);
+        } catch (boost::compute::opencl_error& e) {
+            BOOST_LOG_TRIVIAL(warning) << "Cannot calibrate profiling timer of \""
+                                       << device.UniqueName() << "\": " << e.what();
+        }
+        return result;
+    }
+
+    static void FitLine(
+        const std::vector<double>& host_times, const std::vector<double>& offsets,
+        DeviceClockInfo& result) {
+        const double n = static_cast<double>(host_times.size());
+        double mean_time = 0.0;
+        double mean_offset = 0.0;
+        for (std::size_t i = 0; i < host_times.size(); ++i) {
+            mean_time += host_times[i] / n;
+            mean_offset += offsets[i] / n;
+        }
+        double covariance = 0.0;
+        double variance = 0.0;
+        for (std::size_t i = 0; i < host_times.size(); ++i) {
+            covariance += (host_times[i] - mean_time) * (offsets[i] - mean_offset);
+            variance += (host_times[i] - mean_time) * (host_times[i] - mean_time);
+        }
+        result.reference_time = mean_time;
+        result.offset = mean_offset;
+        if (variance > 0.0) {
+            result.drift = covariance / variance;
+        }
+    }
+};
+
+inline void to_json(nlohmann::json& j, const HostClockInfo& c) {
+    j = nlohmann::json::object({{"readOverhead", c.read_overhead}, {"resolution", c.resolution}});
+}
+
+inline void to_json(nlohmann::json& j, const DeviceClockInfo& c) {
+    j = nlohmann::json::object({{"resolution", c.resolution}});
+    if (c.offset) {
+        j["offsetNs"] = c.offset.value();
+        j["referenceHostTimeNs"] = c.reference_time;
+    }
+    if (c.drift) {
+        j["drift"] = c.drift.value();
+    }
+}
+
+inline void to_json(nlohmann::json& j, const TimerCalibration& c) {
+    j = nlohmann::json::object({{"host", c.host}, {"devices", nlohmann::json::object()}});
+    for (const auto& p : c.devices) {
+        j["devices"][p.first] = p.second;
+    }
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_TIMER_CALIBRATION_H_
@@ -0,0 +1,28 @@
+#ifndef KPV_ENVIRONMENT_UTC_TIME_H_
+#define KPV_ENVIRONMENT_UTC_TIME_H_
+
+#include <ctime>
+#include <string>
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Current UTC time in ISO 8601 format, e.g. 2020-01-31T12:00:00Z. Conversion doesn't use a shared
+static buffer of gmtime, so it is safe to call from several threads.
+*/
+inline std::string CurrentUtcTimeString() {
+    const time_t now = time(nullptr);
+    struct tm tstruct = {};
+#if defined(_WIN32)
+    gmtime_s(&tstruct, &now);
+#else
+    gmtime_r(&now, &tstruct);
+#endif
+    char buf[80];
+    strftime(buf, sizeof(buf), "%FT%TZ", &tstruct);
+    return buf;
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_ENVIRONMENT_UTC_TIME_H_
@@ -2,17 +2,39 @@
 #define KPV_EVENTS_EVENT_LIST_H_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "boost/compute.hpp"
+#include "detail/events/host_event.hpp"
 #include "detail/events/opencl_event.hpp"
+#include "detail/events/opencl_event_batch.hpp"
+#include "detail/events/opencl_event_span.hpp"
+#include "detail/events/simulated_event.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
+/*
+Name of a step. String literal (or any other C string that outlives the event list) is not copied,
+std::string is copied, so fixtures that use literals don't allocate memory for step names.
+*/
+class StepName {
+public:
+    StepName(const char* name) : name_(name) {}
+
+    StepName(std::string name) : owned_name_(std::move(name)) {}
+
+    const char* c_str() const { return name_ != nullptr ? name_ : owned_name_.c_str(); }
+
+private:
+    const char* name_ = nullptr;
+    std::string owned_name_;
+};
+
 class EventList {
 public:
     struct EventInfo {
-        std::string step_name;
+        StepName step_name;
         std::unique_ptr<EventInterface> ev;
     };
 
@@ -23,22 +45,49 @@ public:
     typedef std::vector<EventInfo>::iterator iterator;
     typedef std::vector<EventInfo>::reverse_iterator reverse_iterator;
 
-    void AddOpenClEvent(const std::string& step_name, boost::compute::event& e) {
-        events_.push_back({step_name, std::make_unique<OpenClEvent>(e)});
+    void AddOpenClEvent(StepName step_name, boost::compute::event& e) {
+        events_.push_back({std::move(step_name), std::make_unique<OpenClEvent>(e)});
     }
 
     template <typename T>
-    void AddOpenClEvent(const std::string& step_name, boost::compute::future<T>& e) {
-        AddOpenClEvent(step_name, e.get_event());
+    void AddOpenClEvent(StepName step_name, boost::compute::future<T>& e) {
+        AddOpenClEvent(std::move(step_name), e.get_event());
     }
 
-    void AddOpenClEvent(const std::string& step_name, boost::compute::event&& e) {
-        events_.push_back({step_name, std::make_unique<OpenClEvent>(e)});
+    void AddOpenClEvent(StepName step_name, boost::compute::event&& e) {
+        events_.push_back({std::move(step_name), std::make_unique<OpenClEvent>(e)});
     }
 
     template <typename T>
-    void AddOpenClEvent(const std::string& step_name, boost::compute::future<T>&& e) {
-        AddOpenClEvent(step_name, e.get_event());
+    void AddOpenClEvent(StepName step_name, boost::compute::future<T>&& e) {
+        AddOpenClEvent(std::move(step_name), e.get_event());
+    }
+
+    /*
+    Add a single step that covers several concurrent OpenCL events of one device
+    */
+    void AddOpenClEventSpan(
+        StepName step_name, const std::vector<boost::compute::event>& events) {
+        events_.push_back({std::move(step_name), std::make_unique<OpenClEventSpan>(events)});
+    }
+
+    /*
+    Add a step of launch_count back-to-back launches of one kernel, first and last are events of
+    the first and the last launch. Duration of the step is a duration of one launch.
+    */
+    void AddOpenClEventBatch(
+        StepName step_name, const boost::compute::event& first, const boost::compute::event& last,
+        int launch_count) {
+        events_.push_back(
+            {std::move(step_name), std::make_unique<OpenClEventBatch>(first, last, launch_count)});
+    }
+
+    void AddHostEvent(StepName step_name, const Duration& duration) {
+        events_.push_back({std::move(step_name), std::make_unique<HostEvent>(duration)});
+    }
+
+    void AddSimulatedEvent(StepName step_name, SimulatedDevice& device) {
+        events_.push_back({std::move(step_name), std::make_unique<SimulatedEvent>(device)});
     }
 
     const_iterator cbegin() const { return events_.cbegin(); }
@@ -0,0 +1,27 @@
+#ifndef KPV_EVENTS_HOST_EVENT_H_
+#define KPV_EVENTS_HOST_EVENT_H_
+
+#include "detail/duration.hpp"
+#include "detail/events/event_interface.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Event of an operation that is measured on a host, e.g. wall clock time of work
+submitted to several devices at once. Operation is already completed when event is created.
+*/
+class HostEvent : public EventInterface {
+public:
+    explicit HostEvent(const Duration& duration) : duration_(duration) {}
+
+    virtual Duration GetDuration() override { return duration_; }
+
+    virtual void Wait() override {}
+
+private:
+    Duration duration_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_EVENTS_HOST_EVENT_H_
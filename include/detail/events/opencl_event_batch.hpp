@@ -0,0 +1,70 @@
+#ifndef KPV_EVENTS_OPENCL_EVENT_BATCH_H_
+#define KPV_EVENTS_OPENCL_EVENT_BATCH_H_
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+#include "boost/compute.hpp"
+#include "detail/events/event_interface.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Several launches of the same kernel enqueued back-to-back to one in-order queue. Duration is
+measured from the start of the first launch to the end of the last one and divided by a number
+of launches, so kernels shorter than the profiling timer resolution can be measured. Gaps between
+launches are included, so it is an amortized duration of one launch.
+*/
+class OpenClEventBatch : public EventInterface {
+public:
+    OpenClEventBatch(
+        const boost::compute::event& first, const boost::compute::event& last, int launch_count)
+        : first_(first), last_(last), launch_count_(launch_count) {
+        if (launch_count_ < 1) {
+            throw std::invalid_argument("OpenCL event batch must have at least one launch.");
+        }
+    }
+
+    virtual Duration GetDuration() override {
+        cl_ulong start = first_.get_profiling_info<cl_ulong>(CL_PROFILING_COMMAND_START);
+        cl_ulong end = last_.get_profiling_info<cl_ulong>(CL_PROFILING_COMMAND_END);
+        return Duration{std::chrono::nanoseconds(end > start ? end - start : 0)} / launch_count_;
+    }
+
+    virtual void Wait() override {
+        last_.wait();
+        first_.wait();
+    }
+
+    int launch_count() const { return launch_count_; }
+
+private:
+    boost::compute::event first_;
+    boost::compute::event last_;
+    int launch_count_;
+};
+
+/*
+Number of launches needed for a batch to be much longer than a profiling timer resolution.
+launch_duration is a duration of one launch measured with launch_count launches. A batch shorter
+than the resolution may be measured as zero, so in this case duration of a launch is taken as
+resolution / launch_count, that is its upper bound.
+*/
+inline int RequiredLaunchCount(Duration resolution, Duration launch_duration, int launch_count) {
+    static const int kMaxLaunchCount = 4096;
+    // Quantization error of a batch is below 1% of its duration
+    static const double kResolutionMultiple = 100.0;
+    const double resolution_ns = resolution.duration().count();
+    if (!(resolution_ns > 0.0)) {
+        return 1;
+    }
+    double launch_ns = std::max(launch_duration.duration().count(), resolution_ns / launch_count);
+    double result = std::ceil(kResolutionMultiple * resolution_ns / launch_ns);
+    return static_cast<int>(std::max<double>(1, std::min<double>(result, kMaxLaunchCount)));
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_EVENTS_OPENCL_EVENT_BATCH_H_
@@ -0,0 +1,51 @@
+#ifndef KPV_EVENTS_OPENCL_EVENT_SPAN_H_
+#define KPV_EVENTS_OPENCL_EVENT_SPAN_H_
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "boost/compute.hpp"
+#include "detail/events/event_interface.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Group of OpenCL events that may be executed concurrently (e.g. on several command queues of
+one device). Duration is measured from the earliest start to the latest end, so overlapped
+execution is not counted twice. All events must belong to the same device, since profiling
+timers of different devices are not synchronized.
+*/
+class OpenClEventSpan : public EventInterface {
+public:
+    explicit OpenClEventSpan(const std::vector<boost::compute::event>& events) : events_(events) {
+        if (events_.empty()) {
+            throw std::invalid_argument("OpenCL event span cannot be empty.");
+        }
+    }
+
+    virtual Duration GetDuration() override {
+        cl_ulong start = std::numeric_limits<cl_ulong>::max();
+        cl_ulong end = 0;
+        for (const boost::compute::event& e : events_) {
+            start = std::min(start, e.get_profiling_info<cl_ulong>(CL_PROFILING_COMMAND_START));
+            end = std::max(end, e.get_profiling_info<cl_ulong>(CL_PROFILING_COMMAND_END));
+        }
+        return Duration{std::chrono::nanoseconds(end > start ? end - start : 0)};
+    }
+
+    virtual void Wait() override {
+        for (boost::compute::event& e : events_) {
+            e.wait();
+        }
+    }
+
+private:
+    std::vector<boost::compute::event> events_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_EVENTS_OPENCL_EVENT_SPAN_H_
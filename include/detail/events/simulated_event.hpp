@@ -0,0 +1,27 @@
+#ifndef KPV_EVENTS_SIMULATED_EVENT_H_
+#define KPV_EVENTS_SIMULATED_EVENT_H_
+
+#include "detail/devices/simulated_device.hpp"
+#include "detail/events/event_interface.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Event of an operation on a simulated device. Operation is completed immediately, so all time
+a runner measures on a host is overhead of a harness and a fixture.
+*/
+class SimulatedEvent : public EventInterface {
+public:
+    explicit SimulatedEvent(SimulatedDevice& device) : duration_(device.NextDuration()) {}
+
+    virtual Duration GetDuration() override { return duration_; }
+
+    virtual void Wait() override {}
+
+private:
+    Duration duration_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_EVENTS_SIMULATED_EVENT_H_
@@ -4,19 +4,38 @@
 #include <algorithm>
 #include <boost/algorithm/clamp.hpp>
 #include <boost/log/trivial.hpp>
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <thread>
 #include <unordered_set>
 #include <vector>
 
+#include "detail/checkpoint.hpp"
+#include "detail/compilation/program_cache.hpp"
 #include "detail/devices/opencl_device.hpp"
 #include "detail/devices/platform_list.hpp"
 #include "detail/duration.hpp"
+#include "detail/environment/cache_flusher.hpp"
+#include "detail/environment/device_profile.hpp"
+#include "detail/environment/host_environment.hpp"
+#include "detail/environment/host_sensors.hpp"
+#include "detail/environment/roofline_ceilings.hpp"
+#include "detail/environment/thread_affinity.hpp"
 #include "detail/fixture_registry.hpp"
 #include "detail/fixtures/fixture.hpp"
 #include "detail/fixtures/fixture_family.hpp"
+#include "detail/metrics/metrics_registry.hpp"
+#include "detail/metrics/metrics_server.hpp"
+#include "detail/partitioning/run_shard.hpp"
 #include "detail/reporters/json_benchmark_reporter.hpp"
+#include "detail/reporters/report_merger.hpp"
 #include "detail/run_settings.hpp"
+#include "detail/scheduling/budget_scheduler.hpp"
+#include "detail/statistics/drift_detector.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
@@ -26,9 +45,30 @@ public:
     void Run(RunSettings settings) {  // TODO force Run to be executable one time only?
         BOOST_LOG_TRIVIAL(info) << "Welcome to OpenCL benchmark.";
 
-        if (!((settings.min_iterations >= 1) && (settings.max_iterations >= 1))) {
+        if (!((settings.min_iterations >= 1) && (settings.max_iterations >= 1) &&
+              (settings.cold_iterations >= 1))) {
             throw std::invalid_argument(
-                "Minimum or maximum number of iterations is incorrect (less than 1).");
+                "Minimum, maximum or cold number of iterations is incorrect (less than 1).");
+        }
+
+        if (settings.daemon_interval > Duration() &&
+            (!settings.checkpoint_file_name.empty() || settings.total_budget > Duration())) {
+            throw std::invalid_argument(
+                "Daemon mode cannot be combined with a checkpoint file or a total budget.");
+        }
+
+        if (settings.operation == RunSettings::kMerge) {
+            BOOST_LOG_TRIVIAL(info) << "Merging " << settings.merge_file_names.size()
+                                    << " reports into " << settings.output_file_name;
+            MergeReportFiles(settings.merge_file_names, settings.output_file_name);
+            BOOST_LOG_TRIVIAL(info) << "Done";
+            return;
+        }
+
+        if (settings.operation == RunSettings::kCharacterize) {
+            CharacterizeDevices(settings);
+            BOOST_LOG_TRIVIAL(info) << "Done";
+            return;
         }
 
         std::shared_ptr<FixtureRegistry> fixture_registry = FixtureRegistry::instance().lock();
@@ -74,15 +114,164 @@ public:
             return;
         }
 
+        HostEnvironment host_environment = HostEnvironment::Collect();
+        if (PinCurrentThread(settings.pinned_cpus)) {
+            host_environment.pinned_cpus = settings.pinned_cpus;
+            BOOST_LOG_TRIVIAL(info)
+                << "Runner thread is pinned to CPUs " << VectorToString(settings.pinned_cpus);
+        }
+        host_environment.LogWarnings();
+        const HostSensors host_sensors = HostSensors::Discover(settings.pinned_cpus);
+
+        std::unique_ptr<Checkpoint> checkpoint;
+        // Dry run must not overwrite a checkpoint of a previous run
+        if (!settings.checkpoint_file_name.empty() && (settings.resume || !settings.dry_run)) {
+            checkpoint = std::make_unique<Checkpoint>(
+                settings.checkpoint_file_name, settings.resume, settings.seed);
+            if (settings.resume) {
+                BOOST_LOG_TRIVIAL(info) << "Resuming a run, " << checkpoint->completed_count()
+                                        << " fixtures are already finished";
+            }
+        }
+
+        BOOST_LOG_TRIVIAL(info) << "Input data seed is " << settings.seed;
+        InitializationParams init_params(DataGenerator(settings.seed, settings.pinned_cpus));
+        init_params.additional_params = settings.additional_params;
+
         JsonBenchmarkReporter reporter(settings.output_file_name);
         PlatformList platform_list(settings.device_config);
-        reporter.Initialize(platform_list);
+        reporter.Initialize(platform_list, host_environment, settings.seed);
+        if (settings.shard.enabled()) {
+            reporter.SetShard(settings.shard);
+            BOOST_LOG_TRIVIAL(info) << "Running shard " << settings.shard.ToString();
+        }
+        std::unique_ptr<CacheFlusher> cache_flusher;
+        if (settings.cold_cache) {
+            cache_flusher = std::make_unique<CacheFlusher>();
+        }
+
+        TimerCalibration timer_calibration = TimerCalibration::Collect(platform_list);
+        timer_calibration.Log();
+        reporter.SetTimerCalibration(timer_calibration);
+
+        // Ceilings are known from device profiles or measured once per device when its first
+        // fixture declares a work amount
+        std::unordered_set<std::shared_ptr<DeviceInterface>> ceilings_measured;
+        UseDeviceProfiles(settings, platform_list, reporter, ceilings_measured);
 
         BOOST_LOG_TRIVIAL(info) << "We have " << categories_to_run.size()
                                 << " fixture categories to run";
 
-        int family_index = 1;  // Used for logging only
-        for (auto& p : *fixture_registry) {
+        // Build all families at once, so a time budget can be split between all fixtures of a run.
+        // Fixtures allocate their resources in Initialize(), so it is cheap
+        std::vector<std::pair<int /* registration index */, FixtureFamily>> fixture_families =
+            CreateFixtureFamilies(*fixture_registry, categories_to_run, platform_list, settings);
+
+        std::unique_ptr<BudgetScheduler> scheduler;
+        if (settings.total_budget > Duration()) {
+            scheduler = std::make_unique<BudgetScheduler>(
+                settings.total_budget, settings.min_iterations, settings.max_iterations);
+            std::unordered_map<std::string, FixtureCostEstimate> estimates;
+            if (!settings.estimates_file_name.empty()) {
+                estimates = LoadCostEstimates(settings.estimates_file_name);
+            }
+            for (const auto& family_data : fixture_families) {
+                for (const auto& fixture_data : family_data.second.fixtures) {
+                    if (checkpoint && checkpoint->IsFinished(fixture_data.first)) {
+                        continue;
+                    }
+                    std::string key = ScheduleKey(
+                        family_data.second.name, fixture_data.first.Serialize());
+                    auto estimate = estimates.find(key);
+                    scheduler->AddFixture(
+                        key, estimate == estimates.end() ? FixtureCostEstimate()
+                                                         : estimate->second);
+                }
+            }
+            scheduler->LogPlan();
+        }
+        if (settings.dry_run) {
+            BOOST_LOG_TRIVIAL(info) << "Dry run is finished, fixtures were not run";
+            return;
+        }
+
+        // Endpoint is started before the first cycle, so a scraper sees a daemon at once
+        std::unique_ptr<MetricsRegistry> metrics;
+        std::unique_ptr<MetricsServer> metrics_server;
+        if (settings.daemon_interval > Duration()) {
+            metrics = std::make_unique<MetricsRegistry>(settings.metrics_window);
+            if (settings.metrics_port > 0) {
+                metrics_server = std::make_unique<MetricsServer>(settings.metrics_port);
+            }
+            if (settings.metrics_port == 0 && settings.metrics_file_name.empty()) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Daemon exports no metrics, use --metrics-port or --metrics-file";
+            }
+        }
+
+        init_params.program_cache = std::make_shared<ProgramCache>(settings.compile_threads);
+        RunState state{settings,         init_params,         reporter,
+                       checkpoint.get(), scheduler.get(),     cache_flusher.get(),
+                       host_sensors,     ceilings_measured};
+        auto cycle_start = std::chrono::steady_clock::now();
+        RunFixtureFamilies(fixture_families, state, [&](const FixtureFamilyResult& ff_result) {
+            reporter.AddFixtureFamilyResults(ff_result);
+            if (metrics) {
+                metrics->AddFixtureFamilyResults(ff_result);
+            }
+        });
+        reporter.Flush();
+
+        // Devices, compiled programs and roofline ceilings of the first cycle are reused, so
+        // later cycles pay only for input data and fixture runs. Their results go to metrics only
+        while (metrics) {
+            PublishMetrics(*metrics, settings, metrics_server.get());
+            if (settings.daemon_cycles > 0 &&
+                metrics->cycle_count() >= static_cast<std::uint64_t>(settings.daemon_cycles)) {
+                break;
+            }
+            const auto next_start =
+                cycle_start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                                  settings.daemon_interval.duration());
+            if (std::chrono::steady_clock::now() > next_start) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Daemon cycle took longer than its interval, the next one starts at once";
+            } else {
+                std::this_thread::sleep_until(next_start);
+            }
+            cycle_start = std::chrono::steady_clock::now();
+            fixture_families = CreateFixtureFamilies(
+                *fixture_registry, categories_to_run, platform_list, settings);
+            RunFixtureFamilies(fixture_families, state, [&](const FixtureFamilyResult& ff_result) {
+                metrics->AddFixtureFamilyResults(ff_result);
+            });
+        }
+
+        BOOST_LOG_TRIVIAL(info) << "Done";
+    }
+
+private:
+    // State of a run shared by all fixtures, pointers are null if a feature is not used
+    struct RunState {
+        const RunSettings& settings;
+        InitializationParams& init_params;
+        JsonBenchmarkReporter& reporter;
+        Checkpoint* checkpoint;
+        BudgetScheduler* scheduler;
+        CacheFlusher* cache_flusher;
+        const HostSensors& host_sensors;
+        std::unordered_set<std::shared_ptr<DeviceInterface>>& ceilings_measured;
+    };
+
+    std::vector<std::pair<int /* registration index */, FixtureFamily>> CreateFixtureFamilies(
+        FixtureRegistry& fixture_registry, const std::unordered_set<std::string>& categories_to_run,
+        PlatformList& platform_list, const RunSettings& settings) {
+        // Assigner counts families, a new one makes every daemon cycle select the same families
+        ShardAssigner shard_assigner(settings.shard);
+        std::vector<std::pair<int, FixtureFamily>> fixture_families;
+        int registration_index = -1;
+        for (auto& p : fixture_registry) {
+            ++registration_index;
             if (categories_to_run.count(p.first) == 0) {
                 // This fixture is in exclude list, skip it
                 BOOST_LOG_TRIVIAL(info) << "Skipping category " << p.first;
@@ -90,33 +279,82 @@ public:
             }
 
             FixtureFamily fixture_family = p.second(platform_list);
+            ExpandBuildVariants(fixture_family, settings.build_variants);
+            if (settings.shard.enabled()) {
+                shard_assigner.SelectFixtures(fixture_family);
+                if (fixture_family.fixtures.empty()) {
+                    BOOST_LOG_TRIVIAL(info) << "Fixture family \"" << fixture_family.name
+                                            << "\" is run by other shards";
+                    continue;
+                }
+            }
+            fixture_families.emplace_back(registration_index, std::move(fixture_family));
+        }
+        return fixture_families;
+    }
+
+    /*
+    Run fixtures of all families in order, family_finished is called with results of every family
+    */
+    void RunFixtureFamilies(
+        std::vector<std::pair<int, FixtureFamily>>& fixture_families, RunState& state,
+        const std::function<void(const FixtureFamilyResult&)>& family_finished) {
+        // Programs are built in background a few fixtures ahead, so a device doesn't wait for
+        // compilation between fixtures. Programs are taken from the cache in Initialize(), that is
+        // not measured
+        static const std::size_t kCompileLookahead = 4;
+        CompilePipeline compile_pipeline(state.init_params.program_cache, kCompileLookahead);
+        for (const auto& family_data : fixture_families) {
+            for (const auto& fixture_data : family_data.second.fixtures) {
+                std::vector<ProgramSource> programs;
+                if (state.settings.compile_threads > 0 &&
+                    !(state.checkpoint && state.checkpoint->IsFinished(fixture_data.first)) &&
+                    MissingExtensions(*fixture_data.second, fixture_data.first).empty()) {
+                    programs = fixture_data.second->GetProgramSources();
+                }
+                compile_pipeline.AddFixture(std::move(programs));
+            }
+        }
+
+        int family_index = 1;  // Used for logging only
+        for (auto& family_data : fixture_families) {
+            FixtureFamily& fixture_family = family_data.second;
             std::string fixture_name = fixture_family.name;
             FixtureFamilyResult ff_result;  // Short for "fixture family result"
             ff_result.name = fixture_family.name;
             ff_result.element_count = fixture_family.element_count;
+            ff_result.registration_index = family_data.first;
+            ff_result.build_variants = fixture_family.build_variants;
 
             BOOST_LOG_TRIVIAL(info) << "Starting fixture family \"" << fixture_name << "\"";
 
+            // Datasets are shared only inside a family, new cache releases previous ones
+            state.init_params.dataset_cache = std::make_shared<DatasetCache>();
+
             for (auto& fixture_data : fixture_family.fixtures) {
                 const FixtureId& fixture_id = fixture_data.first;
                 std::shared_ptr<Fixture>& fixture = fixture_data.second;
                 FixtureResult fixture_result;
+                compile_pipeline.StartFixture();
+
+                if (state.checkpoint &&
+                    state.checkpoint->Restore(fixture_id, ff_result, fixture_result)) {
+                    BOOST_LOG_TRIVIAL(info)
+                        << "Run on device \"" << fixture_id.device()->Name()
+                        << "\" was finished before, using results from checkpoint file";
+                    fixture.reset();
+                    ff_result.benchmark.insert(std::make_pair(fixture_id, fixture_result));
+                    continue;
+                }
 
                 BOOST_LOG_TRIVIAL(info)
                     << "Starting run on device \"" << fixture_id.device()->Name() << "\"";
+                const std::string schedule_key = ScheduleKey(fixture_name, fixture_id.Serialize());
+                const auto fixture_start = std::chrono::steady_clock::now();
 
                 try {
-                    std::vector<std::string> required_extensions = fixture->GetRequiredExtensions();
-                    std::sort(required_extensions.begin(), required_extensions.end());
-
-                    std::vector<std::string> have_extensions = fixture_id.device()->Extensions();
-                    std::sort(have_extensions.begin(), have_extensions.end());
-
-                    std::vector<std::string> missed_extensions;
-                    std::set_difference(
-                        required_extensions.cbegin(), required_extensions.cend(),
-                        have_extensions.cbegin(), have_extensions.cend(),
-                        std::back_inserter(missed_extensions));
+                    std::vector<std::string> missed_extensions =
+                        MissingExtensions(*fixture, fixture_id);
                     if (!missed_extensions.empty()) {
                         fixture_result.failure_reason = "Required extension(s) are not available";
                         // Destroy fixture to release some memory sooner
@@ -128,50 +366,135 @@ public:
                             << VectorToString(missed_extensions);
 
                         ff_result.benchmark.insert(std::make_pair(fixture_id, fixture_result));
+                        if (state.scheduler) {
+                            state.scheduler->FixtureFinished(schedule_key, Duration(), 0);
+                        }
 
                         continue;
                     }
 
-                    fixture->Initialize();  // TODO move higher when fixture is constructed, may be
-                                            // disable altogether?
+                    fixture_result.queue_count = fixture->QueueCount();
+                    if (state.settings.streaming_statistics) {
+                        fixture_result.samples =
+                            IterationSamples(IterationSamples::Storage::kStreaming);
+                    }
+                    // TODO move higher when fixture is constructed, may be disable altogether?
+                    TimePhase("initialize", fixture_result, [&]() {
+                        fixture->Initialize(state.init_params);
+                    });
+                    RecordBuildTime(*fixture, *state.init_params.program_cache, fixture_result);
+                    fixture_result.work_amount = fixture->GetWorkAmount();
+                    fixture_result.host_allocation = fixture->GetHostAllocation();
+                    if (fixture_result.work_amount &&
+                        state.ceilings_measured.insert(fixture_id.device()).second) {
+                        MeasureRooflineCeilings(fixture_id.device(), state.reporter);
+                    }
 
-                    // Warm-up for one iteration to get estimation of execution time
                     RuntimeParams params;
-                    params.additional_params = settings.additional_params;
+                    params.additional_params = state.settings.additional_params;
+                    const bool batching =
+                        state.settings.launch_count != 1 && fixture->SupportsBatching();
+                    if (batching) {
+                        auto opencl_device =
+                            std::dynamic_pointer_cast<OpenClDevice>(fixture_id.device());
+                        if (opencl_device) {
+                            fixture_result.timer_resolution =
+                                opencl_device->ProfilingTimerResolution();
+                        }
+                        if (state.settings.launch_count > 0) {
+                            params.launch_count = state.settings.launch_count;
+                        }
+                    }
 
-                    EventList warmup_ev_list = fixture->Execute(params);
-                    IterationInfo warmup_result =
-                        AddIteration(warmup_ev_list, ff_result, fixture_result);
+                    // Step IDs of events of the previous iteration, used to find IDs without
+                    // string lookups
+                    std::vector<int> step_hints;
 
-                    Duration total_operation_duration = std::accumulate(
-                        warmup_result.durations.cbegin(), warmup_result.durations.cend(),
-                        Duration(), [](Duration val, const std::pair<std::string, Duration>& p) {
-                            return val + p.second;
-                        });
+                    // Background builds of next fixtures would take CPUs from a fixture that is
+                    // timed on a host or runs on a CPU. Nothing new is prefetched until the next
+                    // fixture starts
+                    if (UsesHostCpus(fixture_id.device())) {
+                        state.init_params.program_cache->WaitForPrefetches();
+                    }
+
+                    // First iterations include one-time costs (lazy compilation, page faults,
+                    // cache warming), they are reported separately as a cold series. The last
+                    // of them is used to estimate execution time. They run before a launch count
+                    // is calibrated, so calibration doesn't warm a fixture up before them
+                    EventList cold_ev_list;
+                    for (int i = 0; i < state.settings.cold_iterations; ++i) {
+                        if (state.cache_flusher) {
+                            fixture->PrepareColdIteration();
+                            state.cache_flusher->Flush();
+                        }
+                        cold_ev_list = fixture->Execute(params);
+                        AddIteration(
+                            cold_ev_list, ff_result, fixture_result.cold_samples, step_hints);
+                    }
+                    fixture_result.cold_cache = state.cache_flusher != nullptr;
+
+                    if (batching) {
+                        fixture_result.batched_steps = BatchedSteps(cold_ev_list, ff_result);
+                        if (state.settings.launch_count == 0 && fixture_result.timer_resolution) {
+                            params.launch_count = CalibrateLaunchCount(
+                                *fixture, params, fixture_result.timer_resolution.value(),
+                                cold_ev_list);
+                        }
+                        fixture_result.launch_count = params.launch_count;
+                    }
+
+                    // Samples of batched steps are durations of one launch, but all of them are
+                    // executed every iteration
+                    Duration total_operation_duration =
+                        params.launch_count > 1
+                            ? BatchedIterationDuration(cold_ev_list, params.launch_count)
+                            : fixture_result.cold_samples.IterationTotal(
+                                  fixture_result.cold_samples.iteration_count() - 1);
                     int iteration_count =
-                        boost::algorithm::clamp<int>(
-                            settings.target_execution_time / total_operation_duration,
-                            settings.min_iterations, settings.max_iterations) -
-                        1;
-                    if (!(iteration_count >= 0)) {
+                        state.scheduler
+                            ? state.scheduler->PlanIterations(
+                                  schedule_key, total_operation_duration)
+                            : boost::algorithm::clamp<int>(
+                                  state.settings.target_execution_time / total_operation_duration,
+                                  state.settings.min_iterations, state.settings.max_iterations);
+                    if (!(iteration_count >= 1)) {
                         throw std::logic_error(
-                            "Estimated number of iterations is incorrect (less than 0).");
+                            "Estimated number of iterations is incorrect (less than 1).");
                     }
 
-                    if (settings.verify_results) {
-                        fixture->VerifyResults();
+                    if (state.settings.verify_results) {
+                        TimePhase("verifyResults", fixture_result, [&]() {
+                            fixture->VerifyResults();
+                        });
+                        fixture_result.accuracy = fixture->GetResultAccuracy();
                     }
 
-                    if (settings.store_results) {
-                        fixture->StoreResults();
+                    if (state.settings.store_results) {
+                        TimePhase("storeResults", fixture_result, [&]() {
+                            fixture->StoreResults();
+                        });
                     }
 
+                    // Recording samples in the timed loop must not allocate memory
+                    fixture_result.samples.Reserve(iteration_count);
+                    fixture_result.sensors_before = state.host_sensors.Read();
+                    const auto iterations_start = std::chrono::steady_clock::now();
                     for (int i = 0; i < iteration_count; ++i) {
                         EventList ev_list = fixture->Execute(params);
-                        AddIteration(ev_list, ff_result, fixture_result);
+                        AddIteration(ev_list, ff_result, fixture_result.samples, step_hints);
+                    }
+                    fixture_result.host_iteration_time =
+                        Duration(std::chrono::steady_clock::now() - iterations_start) /
+                        iteration_count;
+                    fixture_result.sensors_after = state.host_sensors.Read();
+                    // Only the last iteration is kept in streaming mode
+                    if (!fixture_result.samples.streaming()) {
+                        fixture_result.drift = HandleDrift(
+                            *fixture, params, state.settings, ff_result, fixture_result,
+                            step_hints);
                     }
 
-                    fixture->Finalize();
+                    TimePhase("finalize", fixture_result, [&]() { fixture->Finalize(); });
                 } catch (boost::compute::opencl_error& e) {
                     BOOST_LOG_TRIVIAL(error) << "OpenCL error occured: " << e.what();
                     fixture_result.failure_reason = e.what();
@@ -181,26 +504,211 @@ public:
                 }
 
                 // Destroy fixture to release some memory sooner
-                fixture.reset();
+                TimePhase("destroy", fixture_result, [&]() { fixture.reset(); });
+
+                const Duration fixture_time(std::chrono::steady_clock::now() - fixture_start);
+                fixture_result.lifecycle["total"] = fixture_time;
+                if (state.scheduler) {
+                    state.scheduler->FixtureFinished(
+                        schedule_key, fixture_time,
+                        static_cast<int>(fixture_result.samples.iteration_count()));
+                }
 
                 BOOST_LOG_TRIVIAL(info)
                     << "Finished run on device \"" << fixture_id.device()->Name() << "\"";
 
                 ff_result.benchmark.insert(std::make_pair(fixture_id, fixture_result));
+                if (state.checkpoint) {
+                    state.checkpoint->Add(fixture_id, ff_result, fixture_result);
+                }
             }
 
-            reporter.AddFixtureFamilyResults(ff_result);
+            state.init_params.dataset_cache.reset();
+            family_finished(ff_result);
 
             BOOST_LOG_TRIVIAL(info)
                 << "Fixture family \"" << fixture_name << "\" finished successfully.";
             ++family_index;
         }
-        reporter.Flush();
+    }
 
-        BOOST_LOG_TRIVIAL(info) << "Done";
+    /*
+    Find a shift of iteration durations in the middle of a timed loop (e.g. thermal throttling or
+    a frequency change), that would otherwise look like variance. Iterations after it are kept,
+    removed or measured again
+    */
+    boost::optional<DriftAnalysis> HandleDrift(
+        Fixture& fixture, const RuntimeParams& params, const RunSettings& settings,
+        FixtureFamilyResult& ff_result, FixtureResult& fixture_result,
+        std::vector<int>& step_hints) {
+        IterationSamples& samples = fixture_result.samples;
+        boost::optional<ChangePoint> change_point =
+            DetectChangePoint(IterationTotals(samples), settings.drift_threshold);
+        if (!change_point) {
+            return boost::none;
+        }
+        DriftAnalysis drift;
+        drift.change_point = change_point.value();
+        drift.action = settings.drift_action;
+        const std::size_t drifted_count = samples.iteration_count() - change_point->index;
+        BOOST_LOG_TRIVIAL(warning)
+            << "Iteration duration changed by " << change_point->relative_shift * 100.0
+            << "% after iteration " << change_point->index << " of "
+            << samples.iteration_count();
+        if (fixture_result.sensors_before && fixture_result.sensors_after &&
+            fixture_result.sensors_before->mean_frequency_mhz &&
+            fixture_result.sensors_after->mean_frequency_mhz) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Mean CPU frequency was "
+                << fixture_result.sensors_before->mean_frequency_mhz.value()
+                << " MHz before the timed loop and "
+                << fixture_result.sensors_after->mean_frequency_mhz.value() << " MHz after it";
+        }
+        if (drift.action == DriftAction::kDiscard &&
+            change_point->index < static_cast<std::size_t>(settings.min_iterations)) {
+            BOOST_LOG_TRIVIAL(info)
+                << "Drifted iterations are kept, since fewer than the minimum would be left";
+            drift.action = DriftAction::kFlag;
+        }
+        if (drift.action == DriftAction::kFlag) {
+            return drift;
+        }
+
+        samples.Truncate(change_point->index);
+        drift.discarded_iterations = drifted_count;
+        if (drift.action == DriftAction::kRerun) {
+            for (std::size_t i = 0; i < drifted_count; ++i) {
+                EventList ev_list = fixture.Execute(params);
+                AddIteration(ev_list, ff_result, samples, step_hints);
+            }
+            drift.rerun_iterations = drifted_count;
+            drift.persists = static_cast<bool>(
+                DetectChangePoint(IterationTotals(samples), settings.drift_threshold));
+            if (drift.persists) {
+                BOOST_LOG_TRIVIAL(warning) << "Drift is found again after a re-run";
+            }
+        }
+        return drift;
+    }
+
+    static std::vector<double> IterationTotals(const IterationSamples& samples) {
+        std::vector<double> result(samples.iteration_count());
+        for (std::size_t i = 0; i < result.size(); ++i) {
+            result[i] = samples.IterationTotal(i).duration().count();
+        }
+        return result;
+    }
+
+    // Wall clock time of a cycle is exported, so a dashboard can tell a stalled daemon
+    void PublishMetrics(
+        MetricsRegistry& metrics, const RunSettings& settings, MetricsServer* metrics_server) {
+        metrics.CycleFinished(
+            std::chrono::duration<double>(std::chrono::system_clock::now().time_since_epoch())
+                .count());
+        const std::string text = metrics.ToPrometheusText();
+        if (metrics_server) {
+            metrics_server->Publish(text);
+        }
+        if (!settings.metrics_file_name.empty()) {
+            // A daemon keeps running, a file may become writable later
+            try {
+                WriteMetricsFile(settings.metrics_file_name, text);
+            } catch (std::exception& e) {
+                BOOST_LOG_TRIVIAL(error) << e.what();
+            }
+        }
+        BOOST_LOG_TRIVIAL(info) << "Daemon cycle " << metrics.cycle_count() << " is finished";
+    }
+    std::vector<std::string> MissingExtensions(Fixture& fixture, const FixtureId& fixture_id) {
+        std::vector<std::string> required_extensions = fixture.GetRequiredExtensions();
+        std::sort(required_extensions.begin(), required_extensions.end());
+
+        std::vector<std::string> have_extensions = fixture_id.device()->Extensions();
+        std::sort(have_extensions.begin(), have_extensions.end());
+
+        std::vector<std::string> missed_extensions;
+        std::set_difference(
+            required_extensions.cbegin(), required_extensions.cend(), have_extensions.cbegin(),
+            have_extensions.cend(), std::back_inserter(missed_extensions));
+        return missed_extensions;
+    }
+
+    /*
+    Measure peak performance of every OpenCL device and add it to a profile file, profiles of
+    other devices that are already in the file are kept
+    */
+    void CharacterizeDevices(const RunSettings& settings) {
+        PlatformList platform_list(settings.device_config);
+        DeviceProfileStore profiles(settings.device_profiles_file_name);
+        int measured_count = 0;
+        for (auto& platform : platform_list.OpenClPlatforms()) {
+            for (auto& device : platform->GetDevices()) {
+                auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device);
+                if (!opencl_device) {
+                    continue;
+                }
+                BOOST_LOG_TRIVIAL(info) << "Characterizing device \"" << device->Name() << "\"";
+                try {
+                    DeviceProfile profile = DeviceProfile::Measure(*opencl_device);
+                    profile.Log();
+                    profiles.Add(profile);
+                    ++measured_count;
+                } catch (std::exception& e) {
+                    BOOST_LOG_TRIVIAL(error) << "Cannot characterize device \"" << device->Name()
+                                             << "\": " << e.what();
+                }
+            }
+        }
+        profiles.Save();
+        BOOST_LOG_TRIVIAL(info) << "Profiles of " << measured_count << " devices are written to "
+                                << settings.device_profiles_file_name;
+    }
+
+    /*
+    Profiles measured with another driver version are not used, since a driver changes
+    performance as much as hardware does
+    */
+    void UseDeviceProfiles(
+        const RunSettings& settings, const PlatformList& platform_list,
+        JsonBenchmarkReporter& reporter,
+        std::unordered_set<std::shared_ptr<DeviceInterface>>& ceilings_known) {
+        DeviceProfileStore profiles(settings.device_profiles_file_name);
+        for (auto& platform : platform_list.OpenClPlatforms()) {
+            for (auto& device : platform->GetDevices()) {
+                boost::optional<DeviceProfile> profile =
+                    profiles.Find(device->Name(), device->DriverVersion());
+                if (!profile) {
+                    BOOST_LOG_TRIVIAL(info)
+                        << "Device \"" << device->Name() << "\" with driver "
+                        << device->DriverVersion() << " has no profile, run with --characterize "
+                        << "to use its peak performance as a reference";
+                    continue;
+                }
+                reporter.SetDeviceProfile(device->UniqueName(), profile.value());
+                ceilings_known.insert(device);
+            }
+        }
+    }
+
+    /*
+    Ceilings are known for OpenCL devices only, a device without them still gets its throughput
+    reported
+    */
+    void MeasureRooflineCeilings(
+        const std::shared_ptr<DeviceInterface>& device, JsonBenchmarkReporter& reporter) {
+        auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device);
+        if (!opencl_device) {
+            return;
+        }
+        try {
+            reporter.SetRooflineCeilings(
+                opencl_device->UniqueName(), RooflineCeilings::Measure(*opencl_device));
+        } catch (std::exception& e) {
+            BOOST_LOG_TRIVIAL(warning) << "Cannot measure roofline ceilings of \""
+                                       << opencl_device->UniqueName() << "\": " << e.what();
+        }
     }
 
-private:
     template <typename T>
     std::string VectorToString(const std::vector<T>& v, const std::string& delimiter = ", ") {
         std::stringstream result;
@@ -220,6 +728,52 @@ private:
         return result.str();
     }
 
+    /*
+    Total build time of programs of a fixture as "build" lifecycle phase, including builds made in
+    background before Initialize(). Programs that were built for earlier fixtures are not counted,
+    so build time is not repeated when lifecycle phases of a run are added up
+    */
+    void RecordBuildTime(Fixture& fixture, ProgramCache& cache, FixtureResult& fixture_result) {
+        boost::optional<Duration> total;
+        for (const ProgramSource& program_source : fixture.GetProgramSources()) {
+            boost::optional<Duration> duration = cache.TakeBuildDuration(program_source);
+            if (duration) {
+                total = total.value_or(Duration()) + duration.value();
+            }
+        }
+        if (total) {
+            fixture_result.lifecycle["build"] = total.value();
+        }
+    }
+
+    // Fixtures of host, simulated and CPU OpenCL devices are measured on host CPUs or run on them
+    static bool UsesHostCpus(const std::shared_ptr<DeviceInterface>& device) {
+        if (auto group = std::dynamic_pointer_cast<DeviceGroup>(device)) {
+            const auto& members = group->devices();
+            return std::any_of(members.cbegin(), members.cend(), &UsesHostCpus);
+        }
+        if (auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device)) {
+            return (opencl_device->device().type() & CL_DEVICE_TYPE_CPU) != 0;
+        }
+        return std::dynamic_pointer_cast<HostDevice>(device) ||
+               std::dynamic_pointer_cast<SimulatedDevice>(device);
+    }
+
+    /*
+    Measure wall clock time of a fixture lifecycle phase, time of a failed phase is recorded too
+    */
+    template <typename F>
+    void TimePhase(const char* phase, FixtureResult& fixture_result, F&& f) {
+        const auto start = std::chrono::steady_clock::now();
+        try {
+            f();
+        } catch (...) {
+            fixture_result.lifecycle[phase] = Duration(std::chrono::steady_clock::now() - start);
+            throw;
+        }
+        fixture_result.lifecycle[phase] = Duration(std::chrono::steady_clock::now() - start);
+    }
+
     void WaitForEventList(EventList& event_list) {
         // Wait for events in reverse order.
         // In fact waiting for the last one is sufficient for in-order queues,
@@ -229,24 +783,86 @@ private:
         }
     }
 
-    IterationInfo AddIteration(
-        EventList& events, FixtureFamilyResult& ff_result, FixtureResult& fixture_result) {
-        WaitForEventList(events);
-        IterationInfo iter_info;
-        if (ff_result.steps.size() > std::numeric_limits<int>::max()) {
-            throw std::invalid_argument("Fixture family has too many steps");
+    /*
+    Choose number of launches of batched steps, so they take much longer than a profiling timer
+    resolution. The first estimate comes from events of the last cold iteration with a single
+    launch, then a fixture is executed again with growing number of launches, since the first
+    measurement of a short kernel is mostly quantization noise.
+    */
+    int CalibrateLaunchCount(
+        Fixture& fixture, RuntimeParams params, Duration resolution, EventList& cold_events) {
+        static const int kMaxAttempts = 4;
+        int launch_count = 1;
+        EventList events;
+        for (int attempt = 0; attempt < kMaxAttempts; ++attempt) {
+            if (attempt > 0) {
+                params.launch_count = launch_count;
+                events = fixture.Execute(params);
+                WaitForEventList(events);
+            }
+            boost::optional<Duration> shortest_launch;
+            for (auto& ev_info : (attempt == 0 ? cold_events : events)) {
+                if (dynamic_cast<OpenClEventBatch*>(ev_info.ev.get()) != nullptr) {
+                    Duration duration = ev_info.ev->GetDuration();
+                    if (!shortest_launch || duration < shortest_launch.value()) {
+                        shortest_launch = duration;
+                    }
+                }
+            }
+            if (!shortest_launch) {
+                BOOST_LOG_TRIVIAL(warning) << "Fixture supports batching but has no batched steps";
+                return 1;
+            }
+            int needed = RequiredLaunchCount(resolution, shortest_launch.value(), launch_count);
+            if (needed <= launch_count) {
+                break;
+            }
+            launch_count = needed;
+        }
+        BOOST_LOG_TRIVIAL(info) << "Batched steps use " << launch_count
+                                << " launches, profiling timer resolution is "
+                                << resolution.duration().count() << " ns";
+        return launch_count;
+    }
+
+    // IDs of steps that are executed as batches of launches
+    std::set<int> BatchedSteps(EventList& events, FixtureFamilyResult& ff_result) {
+        std::set<int> result;
+        for (auto& ev_info : events) {
+            if (dynamic_cast<OpenClEventBatch*>(ev_info.ev.get()) != nullptr) {
+                result.insert(ff_result.steps.Intern(ev_info.step_name.c_str()));
+            }
         }
+        return result;
+    }
 
+    // Duration of an iteration with launch_count launches of batched steps
+    Duration BatchedIterationDuration(EventList& events, int launch_count) {
+        Duration result;
         for (auto& ev_info : events) {
-            // If step is new, insert a new step info
-            ff_result.steps.emplace(
-                ev_info.step_name, StepInfo{static_cast<int>(ff_result.steps.size())});
+            const bool batch = dynamic_cast<OpenClEventBatch*>(ev_info.ev.get()) != nullptr;
+            result += ev_info.ev->GetDuration() * (batch ? launch_count : 1);
+        }
+        return result;
+    }
+
+    void AddIteration(
+        EventList& events, FixtureFamilyResult& ff_result, IterationSamples& samples,
+        std::vector<int>& step_hints) {
+        WaitForEventList(events);
+        samples.AddIteration();
+        std::size_t index = 0;
+        for (auto& ev_info : events) {
+            if (index == step_hints.size()) {
+                step_hints.push_back(-1);
+            }
+            // If step is new, it is added to a family
+            int step_id = ff_result.steps.Intern(ev_info.step_name.c_str(), step_hints[index]);
+            step_hints[index] = step_id;
+            ++index;
 
-            // Insert iteration duration
-            iter_info.durations.emplace(ev_info.step_name, ev_info.ev->GetDuration());
+            samples.Record(step_id, ev_info.ev->GetDuration());
         }
-        fixture_result.iterations.push_back(iter_info);
-        return iter_info;
     }
 };
 }  // namespace cl_benchmark
@@ -0,0 +1,85 @@
+#ifndef KPV_FIXTURES_BUILD_VARIANT_H_
+#define KPV_FIXTURES_BUILD_VARIANT_H_
+
+#include <boost/algorithm/string/split.hpp>
+#include <boost/algorithm/string/trim.hpp>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "detail/fixtures/fixture_id.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Additional OpenCL program build options that are benchmarked as a separate algorithm of
+every fixture that supports them
+*/
+struct BuildVariant {
+    std::string name;     // Added to an algorithm name of a fixture
+    std::string options;  // Appended to build options of a fixture
+};
+
+/*
+Fixture that was created from another (reference) fixture with additional build options
+*/
+struct BuildVariantInfo {
+    FixtureId reference;
+    BuildVariant variant;
+};
+
+/*
+Build variants known by name
+*/
+inline const std::vector<BuildVariant>& KnownBuildVariants() {
+    static const std::vector<BuildVariant> kVariants = {
+        {"fast-relaxed-math", "-cl-fast-relaxed-math"},
+        {"mad-enable", "-cl-mad-enable"},
+        {"unsafe-math", "-cl-unsafe-math-optimizations"},
+        {"finite-math", "-cl-finite-math-only"},
+        {"no-signed-zeros", "-cl-no-signed-zeros"}};
+    return kVariants;
+}
+
+/*
+Parse a comma-separated list of build variants. Every element is either a name of a known variant,
+"all" for all known variants, or raw build options starting with "-" (e.g. "-cl-denorms-are-zero")
+that are named after themselves.
+*/
+inline std::vector<BuildVariant> ParseBuildVariants(const std::string& str) {
+    std::vector<std::string> tokens;
+    boost::algorithm::split(tokens, str, [](char c) { return c == ','; });
+    std::vector<BuildVariant> result;
+    for (std::string& token : tokens) {
+        boost::algorithm::trim(token);
+        if (token.empty()) {
+            continue;
+        }
+        if (token == "all") {
+            const auto& known = KnownBuildVariants();
+            result.insert(result.end(), known.cbegin(), known.cend());
+            continue;
+        }
+        if (token.front() == '-') {
+            result.push_back(BuildVariant{token, token});
+            continue;
+        }
+        bool found = false;
+        for (const BuildVariant& variant : KnownBuildVariants()) {
+            if (variant.name == token) {
+                result.push_back(variant);
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            throw std::invalid_argument("Unknown build variant \"" + token + "\"");
+        }
+    }
+    return result;
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_FIXTURES_BUILD_VARIANT_H_
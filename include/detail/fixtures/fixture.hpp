@@ -1,12 +1,17 @@
 #ifndef KPV_FIXTURES_FIXTURE_H_
 #define KPV_FIXTURES_FIXTURE_H_
 
+#include <boost/optional.hpp>
 #include <chrono>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
+#include "detail/compilation/program_cache.hpp"
+#include "detail/data/data_generator.hpp"
+#include "detail/data/host_buffer.hpp"
+#include "detail/data/dataset_cache.hpp"
 #include "detail/devices/device_interface.hpp"
 #include "detail/duration.hpp"
 #include "detail/events/event_list.hpp"
@@ -16,6 +21,48 @@ namespace cl_benchmark {
 
 struct RuntimeParams {
     std::string additional_params;
+    // Number of back-to-back kernel launches in a batched step, see Fixture::SupportsBatching()
+    int launch_count = 1;
+};
+
+struct InitializationParams {
+    explicit InitializationParams(const DataGenerator& generator)
+        : data_generator(generator),
+          dataset_cache(std::make_shared<DatasetCache>()),
+          program_cache(std::make_shared<ProgramCache>()) {}
+
+    std::string additional_params;
+    // Use it to generate input data, so they can be reproduced using the same seed
+    DataGenerator data_generator;
+    // Datasets shared by all fixtures of the current fixture family
+    std::shared_ptr<DatasetCache> dataset_cache;
+    // Programs of all fixtures of a run, see Fixture::GetProgramSources()
+    std::shared_ptr<ProgramCache> program_cache;
+};
+
+/*
+Numerical error of fixture results against reference values
+*/
+struct ResultAccuracy {
+    double max_relative_error = 0.0;
+    double mean_relative_error = 0.0;
+};
+
+/*
+Floating point operations and memory traffic of one iteration of a fixture, used to report
+achieved throughput and to place a fixture on a roofline of a device
+*/
+struct WorkAmount {
+    enum class Precision { kSingle, kDouble };
+
+    double flops = 0.0;
+    // Bytes read from and written to global memory. Usually compulsory traffic (every input read
+    // and every output written once), so intensity of kernels with poor reuse is overestimated
+    double bytes = 0.0;
+    Precision precision = Precision::kSingle;
+    // Step that does the work, duration of a whole iteration is used if it is empty. Work of a
+    // batched step is the work of one launch
+    std::string step;
 };
 
 class Fixture {
@@ -26,7 +73,7 @@ public:
     Memory allocations should be done here to avoid excess memory consumption since many
     fixtures may be created at once, but only one of them will be executed at once.
     */
-    virtual void Initialize() {}
+    virtual void Initialize(const InitializationParams& /*params*/) {}
 
     /*
     Get a list of required extensions required by this fixture. Override this if fixture requires
@@ -34,6 +81,13 @@ public:
     */
     virtual std::vector<std::string> GetRequiredExtensions() { return std::vector<std::string>(); }
 
+    /*
+    Optional list of programs that Initialize() gets from InitializationParams::program_cache.
+    Runner builds them in background while previous fixtures run, so it should be cheap and
+    must not allocate device resources.
+    */
+    virtual std::vector<ProgramSource> GetProgramSources() { return std::vector<ProgramSource>(); }
+
     virtual EventList Execute(const RuntimeParams& params) = 0;
 
     /*
@@ -50,6 +104,51 @@ public:
 
     virtual std::string Algorithm() { return std::string(); }
 
+    /*
+    Number of command queues this fixture submits work to concurrently.
+    Used to compare fixtures with the same work split between different number of queues.
+    */
+    virtual int QueueCount() { return 1; }
+
+    /*
+    Return true if Execute() enqueues RuntimeParams::launch_count launches of its kernel and adds
+    them with EventList::AddOpenClEventBatch(). Runner uses more launches for kernels that are
+    too short for a profiling timer of a device.
+    */
+    virtual bool SupportsBatching() { return false; }
+
+    /*
+    Optional method called before every cold iteration when cold-cache runs are requested.
+    Override it to release state that makes next iterations faster, e.g. recreate buffers.
+    Host caches are flushed by the runner.
+    */
+    virtual void PrepareColdIteration() {}
+
+    /*
+    Create a new fixture of the same kind that appends given options to its OpenCL program build
+    options. Return null if a fixture doesn't support build variants.
+    */
+    virtual std::shared_ptr<Fixture> CreateBuildVariant(const std::string& /*build_options*/) {
+        return nullptr;
+    }
+
+    /*
+    Optional numerical error of results found by VerifyResults(). Fixtures that are build variants
+    should report their error instead of failing verification when results are less accurate.
+    */
+    virtual boost::optional<ResultAccuracy> GetResultAccuracy() { return boost::none; }
+
+    /*
+    Optional amount of work made by one iteration, called after Initialize()
+    */
+    virtual boost::optional<WorkAmount> GetWorkAmount() { return boost::none; }
+
+    /*
+    Optional strategy of HostBuffer objects that keep input and output data of a fixture, as
+    returned by HostBuffer::strategy(). Called after Initialize()
+    */
+    virtual boost::optional<HostAllocationStrategy> GetHostAllocation() { return boost::none; }
+
     /*
     Store results of fixture to a persistent storage (e.g. graphic file).
     Every fixture may provide its own method, but it is optional.
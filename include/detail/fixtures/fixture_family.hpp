@@ -4,9 +4,11 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "boost/optional.hpp"
+#include "detail/fixtures/build_variant.hpp"
 #include "detail/fixtures/fixture.hpp"
 #include "detail/fixtures/fixture_id.hpp"
 
@@ -16,7 +18,37 @@ struct FixtureFamily {
     std::string name;
     std::unordered_map<FixtureId, std::shared_ptr<Fixture>> fixtures;
     boost::optional<int32_t> element_count;
+    // Fixtures created by ExpandBuildVariants()
+    std::unordered_map<FixtureId, BuildVariantInfo> build_variants;
 };
+
+/*
+Add a fixture for every build variant of every fixture that supports build options. Algorithm
+of a new fixture is an algorithm of a reference one followed by a variant name.
+*/
+inline void ExpandBuildVariants(
+    FixtureFamily& fixture_family, const std::vector<BuildVariant>& variants) {
+    if (variants.empty()) {
+        return;
+    }
+    std::vector<std::pair<FixtureId, std::shared_ptr<Fixture>>> references(
+        fixture_family.fixtures.cbegin(), fixture_family.fixtures.cend());
+    for (const auto& reference : references) {
+        for (const BuildVariant& variant : variants) {
+            std::shared_ptr<Fixture> fixture =
+                reference.second->CreateBuildVariant(variant.options);
+            if (!fixture) {
+                break;
+            }
+            const std::string& algorithm = reference.first.algorithm();
+            FixtureId id(
+                fixture_family.name, reference.first.device(),
+                algorithm.empty() ? variant.name : algorithm + ", " + variant.name);
+            fixture_family.fixtures.emplace(id, fixture);
+            fixture_family.build_variants.emplace(id, BuildVariantInfo{reference.first, variant});
+        }
+    }
+}
 }  // namespace cl_benchmark
 }  // namespace kpv
 
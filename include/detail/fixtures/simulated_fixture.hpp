@@ -0,0 +1,62 @@
+#ifndef KPV_FIXTURES_SIMULATED_FIXTURE_H_
+#define KPV_FIXTURES_SIMULATED_FIXTURE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "detail/devices/platform_list.hpp"
+#include "detail/devices/simulated_device.hpp"
+#include "detail/fixtures/fixture.hpp"
+#include "detail/fixtures/fixture_family.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Fixture that runs on a simulated device, every iteration consists of given number of steps.
+*/
+class SimulatedFixture : public Fixture {
+public:
+    SimulatedFixture(const std::shared_ptr<SimulatedDevice>& device, int step_count)
+        : device_(device) {
+        for (int i = 0; i < step_count; ++i) {
+            step_names_.push_back("Step " + std::to_string(i + 1));
+        }
+    }
+
+    EventList Execute(const RuntimeParams& /*params*/) override {
+        EventList result;
+        for (const std::string& name : step_names_) {
+            // Names are owned by a fixture, so they are not copied
+            result.AddSimulatedEvent(name.c_str(), *device_);
+        }
+        return result;
+    }
+
+private:
+    std::shared_ptr<SimulatedDevice> device_;
+    std::vector<std::string> step_names_;
+};
+
+/*
+Build a family of simulated fixtures on all simulated devices. Register it to measure overhead
+of the harness (see --simulated-device command line option).
+*/
+inline FixtureFamily CreateSimulatedFixtureFamily(
+    const PlatformList& platform_list, int step_count) {
+    FixtureFamily fixture_family;
+    fixture_family.name = "Simulated, " + std::to_string(step_count) + " step(s)";
+    for (auto& platform : platform_list.SimulatedPlatforms()) {
+        for (auto& device : platform->GetDevices()) {
+            fixture_family.fixtures.emplace(
+                FixtureId(fixture_family.name, device),
+                std::make_shared<SimulatedFixture>(
+                    std::dynamic_pointer_cast<SimulatedDevice>(device), step_count));
+        }
+    }
+    return fixture_family;
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_FIXTURES_SIMULATED_FIXTURE_H_
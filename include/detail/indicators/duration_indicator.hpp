@@ -1,7 +1,9 @@
 #ifndef KPV_INDICATORS_DURATION_INDICATOR_H_
 #define KPV_INDICATORS_DURATION_INDICATOR_H_
 
+#include <algorithm>
 #include <boost/optional.hpp>
+#include <string>
 #include <unordered_map>
 
 #include "detail/duration.hpp"
@@ -12,7 +14,9 @@ namespace kpv {
 namespace cl_benchmark {
 class DurationIndicator : public IndicatorInterface {
 public:
-    explicit DurationIndicator(const FixtureResult& benchmark) { Calculate(benchmark); }
+    DurationIndicator(const FixtureResult& benchmark, const StepList& steps) {
+        Calculate(benchmark, steps);
+    }
 
     void SerializeValue(nlohmann::json& tree) override {
         if (calculated_.iteration_count == 1) {
@@ -29,64 +33,107 @@ public:
                     calculated_.step_min_durations.at(step_data.first);
                 tree["compressedDuration"][step_data.first]["max"] =
                     calculated_.step_max_durations.at(step_data.first);
+                auto spread = calculated_.step_spreads.find(step_data.first);
+                if (spread != calculated_.step_spreads.end()) {
+                    tree["compressedDuration"][step_data.first].update(spread->second);
+                }
             }
         }
     }
 
+    // Average duration of one iteration (sum of all steps)
+    Duration total_duration() const { return calculated_.total_duration; }
+
+    // Average duration of a step, if it is present in results
+    boost::optional<Duration> step_duration(const std::string& step) const {
+        auto iter = calculated_.step_durations.find(step);
+        if (iter == calculated_.step_durations.end()) {
+            return boost::none;
+        }
+        return iter->second;
+    }
+
 private:
     struct FixtureCalculatedData {
         std::unordered_map<std::string, Duration> step_durations;
         std::unordered_map<std::string, Duration> step_min_durations;
         std::unordered_map<std::string, Duration> step_max_durations;
-        std::size_t iteration_count;
+        // Standard deviation and quantiles, known only for streaming statistics
+        std::unordered_map<std::string, nlohmann::json> step_spreads;
+        std::size_t iteration_count = 0;
         // Is not serialized, is just a temporary solution to check if duration is empty
         // TODO check in some better way?
         Duration total_duration;
     };
 
-    void Calculate(const FixtureResult& benchmark) {
-        if (!benchmark.iterations.empty()) {
-            // Calculate duration for every step and total one.
-            Duration total_duration;
-
-            for (auto& iter_results : benchmark.iterations) {
-                for (auto& step_results : iter_results.durations) {
-                    calculated_.step_durations[step_results.first] += step_results.second;
-                    total_duration += step_results.second;
-                    {
-                        auto iter = calculated_.step_min_durations.find(step_results.first);
-                        if (iter == calculated_.step_min_durations.end()) {
-                            iter = calculated_.step_min_durations
-                                       .emplace(step_results.first, Duration::Max())
-                                       .first;
-                        }
-                        if (step_results.second < iter->second) {
-                            iter->second = step_results.second;
-                        }
-                    }
-                    {
-                        auto iter = calculated_.step_max_durations.find(step_results.first);
-                        if (iter == calculated_.step_max_durations.end()) {
-                            iter = calculated_.step_max_durations
-                                       .emplace(step_results.first, Duration::Min())
-                                       .first;
-                        }
-                        if (step_results.second > iter->second) {
-                            iter->second = step_results.second;
-                        }
-                    }
+    void Calculate(const FixtureResult& benchmark, const StepList& steps) {
+        const IterationSamples& samples = benchmark.samples;
+        if (samples.empty()) {
+            return;
+        }
+        if (samples.streaming()) {
+            CalculateStreaming(samples, steps);
+            return;
+        }
+        // Every step is processed separately, so its samples are read sequentially
+        Duration total_duration;
+        for (std::size_t step_id = 0; step_id < samples.step_count(); ++step_id) {
+            Duration sum;
+            Duration min = Duration::Max();
+            Duration max = Duration::Min();
+            bool present = false;
+            for (std::size_t i = 0; i < samples.iteration_count(); ++i) {
+                if (!samples.Has(static_cast<int>(step_id), i)) {
+                    continue;
                 }
+                Duration duration = samples.Get(static_cast<int>(step_id), i);
+                sum += duration;
+                min = std::min(min, duration);
+                max = std::max(max, duration);
+                present = true;
+            }
+            if (!present) {
+                continue;
             }
+            total_duration += sum;
 
             // Divide durations by amount of iterations
-            calculated_.iteration_count = benchmark.iterations.size();
-            total_duration /= calculated_.iteration_count;
-            for (auto& p : calculated_.step_durations) {
-                p.second /= calculated_.iteration_count;
+            const std::string& name = steps.name(static_cast<int>(step_id));
+            calculated_.step_durations[name] = sum / samples.iteration_count();
+            calculated_.step_min_durations[name] = min;
+            calculated_.step_max_durations[name] = max;
+        }
+        calculated_.iteration_count = samples.iteration_count();
+        calculated_.total_duration = total_duration / calculated_.iteration_count;
+    }
+
+    void CalculateStreaming(const IterationSamples& samples, const StepList& steps) {
+        Duration total_duration;
+        for (std::size_t step_id = 0; step_id < samples.step_count(); ++step_id) {
+            const StreamingStatistics& statistics = samples.statistics(static_cast<int>(step_id));
+            if (statistics.count() == 0) {
+                continue;
             }
+            Duration sum = ToDuration(statistics.sum());
+            total_duration += sum;
 
-            calculated_.total_duration = total_duration;
+            const std::string& name = steps.name(static_cast<int>(step_id));
+            calculated_.step_durations[name] = sum / samples.iteration_count();
+            calculated_.step_min_durations[name] = ToDuration(statistics.min());
+            calculated_.step_max_durations[name] = ToDuration(statistics.max());
+            calculated_.step_spreads[name] = {
+                {"stdDev", ToDuration(statistics.standard_deviation())},
+                {"median", ToDuration(statistics.Quantile(0.5))},
+                {"p90", ToDuration(statistics.Quantile(0.9))},
+                {"p99", ToDuration(statistics.Quantile(0.99))}};
         }
+        calculated_.iteration_count = samples.iteration_count();
+        calculated_.total_duration = total_duration / calculated_.iteration_count;
+    }
+
+    static Duration ToDuration(double nanoseconds) {
+        // Rounding errors of a streaming mean must not produce a negative duration
+        return Duration(Duration::InternalType(std::max(0.0, nanoseconds)));
     }
 
     FixtureCalculatedData calculated_;
@@ -0,0 +1,111 @@
+#ifndef KPV_INDICATORS_THROUGHPUT_INDICATOR_H_
+#define KPV_INDICATORS_THROUGHPUT_INDICATOR_H_
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <string>
+
+#include "detail/duration.hpp"
+#include "detail/environment/roofline_ceilings.hpp"
+#include "detail/indicators/duration_indicator.hpp"
+#include "detail/indicators/indicator_interface.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Achieved GFLOP/s, GB/s and arithmetic intensity of a fixture that declares its work amount.
+If ceilings of a device are known, throughput is shown as a percentage of them and a fixture is
+placed on a roofline of a device: it is memory-bound if its intensity is below a ridge point
+(peak flops / bandwidth) and compute-bound otherwise.
+*/
+class ThroughputIndicator : public IndicatorInterface {
+public:
+    ThroughputIndicator(
+        const FixtureResult& benchmark, const StepList& steps,
+        const boost::optional<RooflineCeilings>& ceilings) {
+        Calculate(benchmark, steps, ceilings);
+    }
+
+    bool calculated() const { return static_cast<bool>(gflops_); }
+
+    void SerializeValue(nlohmann::json& tree) override {
+        if (!calculated()) {
+            return;
+        }
+        nlohmann::json throughput = {
+            {"gflops", gflops_.value()},
+            {"gbytesPerSecond", gbytes_per_second_},
+            {"arithmeticIntensity", arithmetic_intensity_}};
+        if (!step_.empty()) {
+            throughput["step"] = step_;
+        }
+        if (percent_of_peak_) {
+            throughput["percentOfPeak"] = percent_of_peak_.value();
+        }
+        if (roofline_) {
+            throughput["roofline"] = roofline_.value();
+        }
+        tree["throughput"] = throughput;
+    }
+
+private:
+    boost::optional<double> gflops_;
+    double gbytes_per_second_ = 0.0;
+    double arithmetic_intensity_ = 0.0;  // Flops per byte
+    std::string step_;
+    // Achieved throughput relative to ceilings of a device, in percent
+    boost::optional<nlohmann::json> percent_of_peak_;
+    boost::optional<nlohmann::json> roofline_;
+
+    void Calculate(
+        const FixtureResult& benchmark, const StepList& steps,
+        const boost::optional<RooflineCeilings>& ceilings) {
+        if (!benchmark.work_amount || benchmark.samples.empty()) {
+            return;
+        }
+        const WorkAmount& work = benchmark.work_amount.value();
+        DurationIndicator durations(benchmark, steps);
+        boost::optional<Duration> duration = work.step.empty()
+                                                 ? durations.total_duration()
+                                                 : durations.step_duration(work.step);
+        if (!duration || !(duration.value() > Duration())) {
+            return;
+        }
+        const double seconds = duration->AsSeconds();
+        gflops_ = work.flops / seconds / 1e9;
+        gbytes_per_second_ = work.bytes / seconds / 1e9;
+        arithmetic_intensity_ = work.bytes > 0.0 ? work.flops / work.bytes : 0.0;
+        step_ = work.step;
+
+        if (!ceilings) {
+            return;
+        }
+        boost::optional<double> peak_gflops = ceilings->PeakGflops(work.precision);
+        percent_of_peak_ = nlohmann::json::object();
+        if (peak_gflops && peak_gflops.value() > 0.0) {
+            (*percent_of_peak_)["flops"] = 100.0 * gflops_.value() / peak_gflops.value();
+        }
+        if (ceilings->gbytes_per_second > 0.0) {
+            (*percent_of_peak_)["bandwidth"] =
+                100.0 * gbytes_per_second_ / ceilings->gbytes_per_second;
+        }
+        if (!peak_gflops || !(ceilings->gbytes_per_second > 0.0) || !(work.bytes > 0.0)) {
+            return;
+        }
+        const double ridge_point = peak_gflops.value() / ceilings->gbytes_per_second;
+        const double attainable_gflops =
+            std::min(peak_gflops.value(), ceilings->gbytes_per_second * arithmetic_intensity_);
+        roofline_ = nlohmann::json{
+            {"peakGflops", peak_gflops.value()},
+            {"peakGbytesPerSecond", ceilings->gbytes_per_second},
+            {"ridgePoint", ridge_point},
+            {"attainableGflops", attainable_gflops},
+            {"boundBy", arithmetic_intensity_ < ridge_point ? "memory" : "compute"},
+            {"fractionOfAttainable", gflops_.value() / attainable_gflops}};
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_INDICATORS_THROUGHPUT_INDICATOR_H_
@@ -0,0 +1,193 @@
+#ifndef KPV_METRICS_METRICS_REGISTRY_H_
+#define KPV_METRICS_METRICS_REGISTRY_H_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "detail/indicators/duration_indicator.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Rolling statistics of fixtures that are run again and again in daemon mode. Mean iteration
+durations of the last window_size runs of every fixture are kept, so a dashboard sees a recent
+level and its range without storing a whole history. Exported in Prometheus text format.
+*/
+class MetricsRegistry {
+public:
+    explicit MetricsRegistry(std::size_t window_size) : window_size_(window_size) {
+        if (window_size_ == 0) {
+            throw std::invalid_argument("Metrics window must hold at least one run.");
+        }
+    }
+
+    void AddFixtureFamilyResults(const FixtureFamilyResult& results) {
+        for (const auto& fixture : results.benchmark) {
+            const FixtureId& id = fixture.first;
+            const FixtureResult& result = fixture.second;
+            Labels labels{results.name, id.device()->UniqueName(), id.algorithm(),
+                          results.element_count ? std::to_string(*results.element_count) : ""};
+            FixtureSeries& series = fixtures_[labels];
+            ++series.runs;
+            if (result.failure_reason || result.samples.empty()) {
+                ++series.failures;
+                continue;
+            }
+            DurationIndicator durations(result, results.steps);
+            series.iteration_seconds.push_back(durations.total_duration().AsSeconds());
+            if (series.iteration_seconds.size() > window_size_) {
+                series.iteration_seconds.pop_front();
+            }
+            series.step_seconds.clear();
+            for (const std::string& step : results.steps.names()) {
+                boost::optional<Duration> step_duration = durations.step_duration(step);
+                if (step_duration) {
+                    series.step_seconds[step] = step_duration->AsSeconds();
+                }
+            }
+        }
+    }
+
+    // unix_time is a wall clock time of the end of a cycle in seconds
+    void CycleFinished(double unix_time) {
+        ++cycle_count_;
+        last_cycle_time_ = unix_time;
+    }
+
+    std::uint64_t cycle_count() const { return cycle_count_; }
+
+    std::string ToPrometheusText() const {
+        std::ostringstream out;
+        out << std::setprecision(std::numeric_limits<double>::max_digits10);
+        WriteHeader(out, "cycles_total", "counter", "Finished benchmark cycles");
+        out << kPrefix << "cycles_total " << cycle_count_ << "\n";
+        WriteHeader(
+            out, "last_cycle_timestamp_seconds", "gauge",
+            "Unix time of the end of the last cycle");
+        out << kPrefix << "last_cycle_timestamp_seconds " << last_cycle_time_ << "\n";
+
+        WriteHeader(out, "fixture_runs_total", "counter", "Runs of a fixture");
+        for (const auto& f : fixtures_) {
+            WriteSample(out, "fixture_runs_total", f.first, "", f.second.runs);
+        }
+        WriteHeader(
+            out, "fixture_failures_total", "counter", "Runs of a fixture that produced no results");
+        for (const auto& f : fixtures_) {
+            WriteSample(out, "fixture_failures_total", f.first, "", f.second.failures);
+        }
+        // Statistics are written only for fixtures that succeeded at least once in a window
+        WriteIterationGauge(
+            out, "iteration_seconds", "Mean iteration duration of the last run",
+            [](const std::deque<double>& window) { return window.back(); });
+        WriteIterationGauge(
+            out, "iteration_window_mean_seconds", "Mean of iteration durations in a window",
+            [](const std::deque<double>& window) {
+                double sum = 0.0;
+                for (double value : window) {
+                    sum += value;
+                }
+                return sum / window.size();
+            });
+        WriteIterationGauge(
+            out, "iteration_window_min_seconds", "Fastest iteration duration in a window",
+            [](const std::deque<double>& window) {
+                return *std::min_element(window.begin(), window.end());
+            });
+        WriteIterationGauge(
+            out, "iteration_window_max_seconds", "Slowest iteration duration in a window",
+            [](const std::deque<double>& window) {
+                return *std::max_element(window.begin(), window.end());
+            });
+        WriteHeader(
+            out, "step_seconds", "gauge", "Mean duration of a step in the last successful run");
+        for (const auto& f : fixtures_) {
+            for (const auto& step : f.second.step_seconds) {
+                WriteSample(out, "step_seconds", f.first, step.first, step.second);
+            }
+        }
+        return out.str();
+    }
+
+private:
+    static constexpr const char* kPrefix = "cl_benchmark_";
+
+    // Family name, device, algorithm and element count (empty if a family has none)
+    using Labels = std::tuple<std::string, std::string, std::string, std::string>;
+
+    struct FixtureSeries {
+        std::deque<double> iteration_seconds;  // Oldest run first
+        std::map<std::string, double> step_seconds;
+        std::uint64_t runs = 0;
+        std::uint64_t failures = 0;
+    };
+
+    std::size_t window_size_;
+    std::map<Labels, FixtureSeries> fixtures_;
+    std::uint64_t cycle_count_ = 0;
+    double last_cycle_time_ = 0.0;
+
+    template <typename F>
+    void WriteIterationGauge(
+        std::ostream& out, const char* name, const char* help, F calculate) const {
+        WriteHeader(out, name, "gauge", help);
+        for (const auto& f : fixtures_) {
+            if (!f.second.iteration_seconds.empty()) {
+                WriteSample(out, name, f.first, "", calculate(f.second.iteration_seconds));
+            }
+        }
+    }
+
+    static void WriteHeader(
+        std::ostream& out, const char* name, const char* type, const char* help) {
+        out << "# HELP " << kPrefix << name << " " << help << "\n";
+        out << "# TYPE " << kPrefix << name << " " << type << "\n";
+    }
+
+    template <typename T>
+    static void WriteSample(
+        std::ostream& out, const char* name, const Labels& labels, const std::string& step,
+        T value) {
+        out << kPrefix << name << "{family=\"" << EscapeLabel(std::get<0>(labels))
+            << "\",device=\"" << EscapeLabel(std::get<1>(labels)) << "\",algorithm=\""
+            << EscapeLabel(std::get<2>(labels)) << "\"";
+        if (!std::get<3>(labels).empty()) {
+            out << ",elements=\"" << std::get<3>(labels) << "\"";
+        }
+        if (!step.empty()) {
+            out << ",step=\"" << EscapeLabel(step) << "\"";
+        }
+        out << "} " << value << "\n";
+    }
+
+    // Backslash, double quote and line feed must be escaped in label values
+    static std::string EscapeLabel(const std::string& value) {
+        std::string result;
+        result.reserve(value.size());
+        for (char c : value) {
+            if (c == '\\' || c == '"') {
+                result += '\\';
+                result += c;
+            } else if (c == '\n') {
+                result += "\\n";
+            } else {
+                result += c;
+            }
+        }
+        return result;
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_METRICS_METRICS_REGISTRY_H_
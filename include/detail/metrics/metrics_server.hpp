@@ -0,0 +1,186 @@
+#ifndef KPV_METRICS_METRICS_SERVER_H_
+#define KPV_METRICS_METRICS_SERVER_H_
+
+#include <atomic>
+#include <boost/log/trivial.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#endif
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Replace a metrics file for a textfile collector (e.g. of node_exporter). Text is written to a
+temporary file that is renamed, so a collector never reads a partially written file.
+*/
+inline void WriteMetricsFile(const std::string& file_name, const std::string& text) {
+    const std::string temporary_name = file_name + ".tmp";
+    {
+        std::ofstream file(temporary_name);
+        file << text;
+        if (!file) {
+            throw std::runtime_error("Cannot write metrics file " + temporary_name);
+        }
+    }
+    if (std::rename(temporary_name.c_str(), file_name.c_str()) != 0) {
+        throw std::runtime_error("Cannot replace metrics file " + file_name);
+    }
+}
+
+/*
+Minimal HTTP endpoint that serves the last published metrics text at /metrics. It listens on
+the loopback interface only and answers one request at a time from a background thread, so a
+scrape never waits for a running fixture. Port 0 binds any free port, see port().
+*/
+class MetricsServer {
+public:
+    explicit MetricsServer(int port) {
+#if defined(__linux__)
+        listener_ = socket(AF_INET, SOCK_STREAM, 0);
+        if (listener_ < 0) {
+            throw std::runtime_error(ErrorMessage("Cannot create a metrics socket"));
+        }
+        const int reuse = 1;
+        setsockopt(listener_, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+        sockaddr_in address = {};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        address.sin_port = htons(static_cast<uint16_t>(port));
+        socklen_t address_size = sizeof(address);
+        if (bind(listener_, reinterpret_cast<sockaddr*>(&address), address_size) != 0 ||
+            listen(listener_, kBacklog) != 0 ||
+            getsockname(listener_, reinterpret_cast<sockaddr*>(&address), &address_size) != 0) {
+            const std::string message =
+                ErrorMessage("Cannot listen on metrics port " + std::to_string(port));
+            close(listener_);
+            throw std::runtime_error(message);
+        }
+        port_ = ntohs(address.sin_port);
+        thread_ = std::thread([this]() { Serve(); });
+        BOOST_LOG_TRIVIAL(info) << "Metrics are served at http://127.0.0.1:" << port_
+                                << "/metrics";
+#else
+        BOOST_LOG_TRIVIAL(warning)
+            << "Metrics endpoint is not supported on this platform, use a metrics file instead";
+        port_ = port;
+#endif
+    }
+
+    MetricsServer(const MetricsServer&) = delete;
+    MetricsServer& operator=(const MetricsServer&) = delete;
+
+    ~MetricsServer() noexcept {
+        stop_ = true;
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+#if defined(__linux__)
+        if (listener_ >= 0) {
+            close(listener_);
+        }
+#endif
+    }
+
+    int port() const { return port_; }
+
+    void Publish(const std::string& text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        text_ = text;
+    }
+
+private:
+    // Poll timeout bounds the time a destructor waits for the thread to notice a stop
+    static const int kPollTimeoutMs = 200;
+    static const int kBacklog = 8;
+    static const std::size_t kMaxRequestSize = 8192;
+
+    int port_ = 0;
+    int listener_ = -1;
+    std::thread thread_;
+    std::atomic<bool> stop_{false};
+    std::mutex mutex_;  // Guards text_
+    std::string text_;
+
+#if defined(__linux__)
+    void Serve() {
+        while (!stop_) {
+            pollfd listener_poll = {listener_, POLLIN, 0};
+            if (poll(&listener_poll, 1, kPollTimeoutMs) <= 0) {
+                continue;
+            }
+            const int connection = accept(listener_, nullptr, nullptr);
+            if (connection < 0) {
+                continue;
+            }
+            Respond(connection);
+            close(connection);
+        }
+    }
+
+    void Respond(int connection) {
+        // Only a request line is needed, the rest of a request is ignored
+        std::string request;
+        char buffer[1024];
+        while (request.find("\r\n") == std::string::npos && request.size() < kMaxRequestSize) {
+            pollfd connection_poll = {connection, POLLIN, 0};
+            if (poll(&connection_poll, 1, kPollTimeoutMs) <= 0) {
+                return;
+            }
+            const ssize_t received = recv(connection, buffer, sizeof(buffer), 0);
+            if (received <= 0) {
+                return;
+            }
+            request.append(buffer, static_cast<std::size_t>(received));
+        }
+        const std::string request_line = request.substr(0, request.find("\r\n"));
+        std::string status = "200 OK";
+        std::string body;
+        if (request_line.compare(0, 4, "GET ") != 0) {
+            status = "405 Method Not Allowed";
+        } else if (
+            request_line.compare(4, 9, "/metrics ") != 0 && request_line.compare(4, 2, "/ ") != 0) {
+            status = "404 Not Found";
+        } else {
+            std::lock_guard<std::mutex> lock(mutex_);
+            body = text_;
+        }
+        const std::string response =
+            "HTTP/1.1 " + status +
+            "\r\nContent-Type: text/plain; version=0.0.4; charset=utf-8\r\nContent-Length: " +
+            std::to_string(body.size()) + "\r\nConnection: close\r\n\r\n" + body;
+        std::size_t sent = 0;
+        while (sent < response.size()) {
+            // A scraper that disconnects early must not kill the process with SIGPIPE
+            const ssize_t result =
+                send(connection, response.data() + sent, response.size() - sent, MSG_NOSIGNAL);
+            if (result <= 0) {
+                return;
+            }
+            sent += static_cast<std::size_t>(result);
+        }
+    }
+
+    static std::string ErrorMessage(const std::string& message) {
+        return message + ": " + std::strerror(errno);
+    }
+#endif
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_METRICS_METRICS_SERVER_H_
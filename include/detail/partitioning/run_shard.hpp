@@ -0,0 +1,89 @@
+#ifndef KPV_PARTITIONING_RUN_SHARD_H_
+#define KPV_PARTITIONING_RUN_SHARD_H_
+
+#include <stdexcept>
+#include <string>
+
+#include "detail/fixtures/fixture_family.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Part of a run executed by one process when a run is split between several processes or machines.
+Index is zero-based, but it is shown to a user as one-based ("1/4" is the first of four shards).
+*/
+struct RunShard {
+    int index = 0;
+    int count = 1;
+
+    bool enabled() const { return count > 1; }
+
+    std::string ToString() const { return std::to_string(index + 1) + "/" + std::to_string(count); }
+
+    /*
+    Parse shard in format "i/N", where 1 <= i <= N
+    */
+    static RunShard Parse(const std::string& str) {
+        RunShard result;
+        try {
+            std::size_t slash_pos = str.find('/');
+            if (slash_pos == std::string::npos) {
+                throw std::invalid_argument("");
+            }
+            std::string index_str = str.substr(0, slash_pos);
+            std::string count_str = str.substr(slash_pos + 1);
+            std::size_t pos = 0;
+            int index = std::stoi(index_str, &pos);
+            if (pos != index_str.size()) {
+                throw std::invalid_argument("");
+            }
+            result.count = std::stoi(count_str, &pos);
+            if (pos != count_str.size() || result.count < 1 || index < 1 ||
+                index > result.count) {
+                throw std::invalid_argument("");
+            }
+            result.index = index - 1;
+        } catch (std::exception&) {
+            throw std::invalid_argument("Incorrect shard \"" + str + "\"");
+        }
+        return result;
+    }
+};
+
+/*
+Assigns work to shards. Unit of work is a whole fixture family: fixtures of a family are compared
+with each other across devices (a device group with its members, devices of a thread sweep or
+a compute unit sweep), so such comparisons are always made by one process.
+Families with fixtures are numbered in registration order, every shard takes them in round-robin
+manner. This order doesn't depend on a process, so every process must be started with the same
+fixture filter and device options, and should see the same devices.
+*/
+class ShardAssigner {
+public:
+    explicit ShardAssigner(const RunShard& shard) : shard_(shard) {}
+
+    /*
+    Remove fixtures that belong to other shards. Must be called for every family of a run in
+    registration order; families that are created again (e.g. in every daemon cycle) need a new
+    assigner.
+    */
+    void SelectFixtures(FixtureFamily& fixture_family) {
+        // Empty families are not counted, so they don't unbalance shards
+        if (fixture_family.fixtures.empty()) {
+            return;
+        }
+        if (next_work_index_ % shard_.count != shard_.index) {
+            fixture_family.fixtures.clear();
+            fixture_family.build_variants.clear();
+        }
+        ++next_work_index_;
+    }
+
+private:
+    RunShard shard_;
+    int next_work_index_ = 0;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_PARTITIONING_RUN_SHARD_H_
@@ -0,0 +1,123 @@
+#ifndef KPV_PARTITIONING_WORK_PARTITIONER_H_
+#define KPV_PARTITIONING_WORK_PARTITIONER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Continuous range of work items [begin, end)
+*/
+struct WorkRange {
+    std::size_t begin = 0;
+    std::size_t end = 0;
+
+    std::size_t size() const { return end - begin; }
+};
+
+enum class PartitionStrategy {
+    kStatic,        // Equal parts for every device
+    kProportional,  // Parts are proportional to measured speed of every device
+    kDynamic        // Devices take small chunks from a shared queue until work is finished
+};
+
+inline std::string PartitionStrategyName(PartitionStrategy strategy) {
+    switch (strategy) {
+        case PartitionStrategy::kStatic:
+            return "static split";
+        case PartitionStrategy::kProportional:
+            return "proportional split";
+        case PartitionStrategy::kDynamic:
+            return "dynamic split";
+    }
+    throw std::invalid_argument("Unknown partition strategy.");
+}
+
+/*
+Split work_size items into parts proportional to weights, one part for every weight.
+Every part except the last one is a multiple of granularity (e.g. work-group size).
+Zero weights are allowed and produce empty parts, but at least one weight must be positive.
+*/
+inline std::vector<WorkRange> ProportionalPartition(
+    std::size_t work_size, const std::vector<double>& weights, std::size_t granularity = 1) {
+    if (weights.empty() || granularity == 0) {
+        throw std::invalid_argument("Weight list is empty or granularity is zero.");
+    }
+    double weight_sum = 0.0;
+    for (double weight : weights) {
+        if (!(weight >= 0.0) || std::isinf(weight)) {
+            throw std::invalid_argument("Partition weight is negative or not finite.");
+        }
+        weight_sum += weight;
+    }
+    if (!(weight_sum > 0.0)) {
+        throw std::invalid_argument("All partition weights are zero.");
+    }
+
+    std::vector<WorkRange> result(weights.size());
+    // Boundaries are rounded from cumulative weights, so rounding errors don't accumulate
+    double cumulative_weight = 0.0;
+    std::size_t begin = 0;
+    for (std::size_t i = 0; i < weights.size(); ++i) {
+        cumulative_weight += weights[i];
+        std::size_t end = work_size;
+        if (i + 1 < weights.size()) {
+            double exact_end = work_size * (cumulative_weight / weight_sum);
+            end = static_cast<std::size_t>(std::llround(exact_end / granularity)) * granularity;
+            end = std::max(begin, std::min(end, work_size));
+        }
+        result[i].begin = begin;
+        result[i].end = end;
+        begin = end;
+    }
+    return result;
+}
+
+inline std::vector<WorkRange> StaticPartition(
+    std::size_t work_size, std::size_t part_count, std::size_t granularity = 1) {
+    return ProportionalPartition(work_size, std::vector<double>(part_count, 1.0), granularity);
+}
+
+/*
+Shared queue of work chunks, used for dynamic partitioning.
+Every device (usually a separate host thread) takes a next chunk when it finished previous one,
+so faster devices process more chunks. Thread-safe.
+*/
+class DynamicPartitioner {
+public:
+    DynamicPartitioner(std::size_t work_size, std::size_t chunk_size)
+        : work_size_(work_size), chunk_size_(chunk_size), next_(0) {
+        if (chunk_size_ == 0) {
+            throw std::invalid_argument("Chunk size cannot be zero.");
+        }
+    }
+
+    // Returns false when all work is taken
+    bool Next(WorkRange& range) {
+        std::size_t begin = next_.fetch_add(chunk_size_);
+        if (begin >= work_size_) {
+            return false;
+        }
+        range.begin = begin;
+        range.end = std::min(begin + chunk_size_, work_size_);
+        return true;
+    }
+
+    void Reset() { next_ = 0; }
+
+private:
+    const std::size_t work_size_;
+    const std::size_t chunk_size_;
+    std::atomic<std::size_t> next_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_PARTITIONING_WORK_PARTITIONER_H_
@@ -1,39 +1,306 @@
 #ifndef KPV_REPORTERS_BENCHMARK_RESULTS_H_
 #define KPV_REPORTERS_BENCHMARK_RESULTS_H_
 
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
 #include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "boost/optional.hpp"
 #include "detail/duration.hpp"
+#include "detail/environment/host_sensors.hpp"
 #include "detail/fixtures/fixture_family.hpp"
 #include "detail/fixtures/fixture_id.hpp"
+#include "detail/statistics/drift_detector.hpp"
+#include "detail/statistics/streaming_statistics.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
+/*
+Step names of a fixture family. Every name is interned once, samples refer to steps by their IDs.
+ID of a step is also an order in which it was added.
+*/
+class StepList {
+public:
+    int Intern(const std::string& name) {
+        auto iter = ids_.find(name);
+        if (iter != ids_.end()) {
+            return iter->second;
+        }
+        if (names_.size() >= static_cast<std::size_t>(std::numeric_limits<int>::max())) {
+            throw std::invalid_argument("Fixture family has too many steps");
+        }
+        int id = static_cast<int>(names_.size());
+        names_.push_back(name);
+        ids_.emplace(name, id);
+        return id;
+    }
 
-struct IterationInfo {
-    std::unordered_map<std::string /* step name */, Duration> durations;
+    /*
+    Same as above, but doesn't allocate memory if a step with ID given as a hint has this name.
+    Fixtures usually produce the same steps in the same order every iteration, so position of an
+    event in the previous iteration is a good hint.
+    */
+    int Intern(const char* name, int hint) {
+        if (hint >= 0 && static_cast<std::size_t>(hint) < names_.size() &&
+            std::strcmp(names_[hint].c_str(), name) == 0) {
+            return hint;
+        }
+        return Intern(std::string(name));
+    }
+
+    const std::string& name(int id) const { return names_.at(id); }
+
+    const std::vector<std::string>& names() const { return names_; }
+
+    std::size_t size() const { return names_.size(); }
+
+private:
+    std::vector<std::string> names_;
+    std::unordered_map<std::string, int> ids_;
 };
 
-struct FixtureResult {
-    std::vector<IterationInfo> iterations;
+/*
+Durations of all iterations of one fixture. Samples of every step are stored in a separate
+contiguous array (struct of arrays), so recording a sample is a single store when memory is
+reserved in advance.
+In streaming mode only the last iteration is stored, every sample is also added to statistics of
+its step, so memory does not grow with a number of iterations.
+*/
+class IterationSamples {
+public:
+    enum class Storage { kAll, kStreaming };
 
-    boost::optional<std::string> failure_reason;
+    explicit IterationSamples(Storage storage = Storage::kAll) : storage_(storage) {}
+
+    bool streaming() const { return storage_ == Storage::kStreaming; }
+
+    /*
+    Preallocate memory for a given total number of iterations, including steps that are not
+    recorded yet. Does nothing in streaming mode.
+    */
+    void Reserve(std::size_t iteration_count) {
+        if (streaming()) {
+            return;
+        }
+        reserved_ = iteration_count;
+        for (auto& step : steps_) {
+            step.reserve(iteration_count);
+        }
+    }
+
+    /*
+    Keep only the first iteration_count iterations, e.g. to remove a drifted end of a series.
+    Not available in streaming mode, where iterations are not stored
+    */
+    void Truncate(std::size_t iteration_count) {
+        if (streaming()) {
+            throw std::logic_error("Iterations cannot be removed in streaming mode");
+        }
+        if (iteration_count >= iteration_count_) {
+            return;
+        }
+        for (auto& step : steps_) {
+            step.resize(iteration_count);
+        }
+        iteration_count_ = iteration_count;
+    }
+
+    /*
+    Start a new iteration, every step of it is missing until it is recorded
+    */
+    void AddIteration() {
+        for (auto& step : steps_) {
+            if (streaming()) {
+                step.back() = Missing();
+            } else {
+                step.push_back(Missing());
+            }
+        }
+        ++iteration_count_;
+    }
+
+    /*
+    Record duration of a step of the last iteration. If step occurs more than once in an
+    iteration, the first duration is kept.
+    */
+    void Record(int step_id, Duration duration) {
+        if (iteration_count_ == 0) {
+            throw std::logic_error("Sample is recorded before an iteration is started");
+        }
+        if (static_cast<std::size_t>(step_id) >= steps_.size()) {
+            AddSteps(step_id + 1);
+        }
+        double& sample = steps_[step_id].back();
+        if (std::isnan(sample)) {
+            sample = duration.duration().count();
+            if (streaming()) {
+                statistics_[step_id].Add(sample);
+            }
+        }
+    }
+
+    /*
+    Statistics of a step in streaming mode. Iterations where a step is missing are not counted.
+    */
+    const StreamingStatistics& statistics(int step_id) const {
+        if (!streaming()) {
+            throw std::logic_error("Statistics are collected in streaming mode only");
+        }
+        return statistics_.at(step_id);
+    }
+
+    /*
+    Replace contents with previously collected statistics of steps given by their IDs, switches
+    to streaming mode
+    */
+    void RestoreStatistics(
+        std::size_t iteration_count,
+        const std::vector<std::pair<int, StreamingStatistics>>& statistics) {
+        *this = IterationSamples(Storage::kStreaming);
+        iteration_count_ = iteration_count;
+        for (const auto& p : statistics) {
+            if (static_cast<std::size_t>(p.first) >= steps_.size()) {
+                AddSteps(p.first + 1);
+            }
+            statistics_[p.first] = p.second;
+        }
+    }
+
+    std::size_t iteration_count() const { return iteration_count_; }
+
+    bool empty() const { return iteration_count_ == 0; }
+
+    // Number of steps that have at least one slot, IDs of other steps have no samples
+    std::size_t step_count() const { return steps_.size(); }
+
+    // In streaming mode only the last iteration is available
+    bool Has(int step_id, std::size_t iteration) const {
+        return static_cast<std::size_t>(step_id) < steps_.size() &&
+               !std::isnan(steps_[step_id].at(Index(iteration)));
+    }
+
+    Duration Get(int step_id, std::size_t iteration) const {
+        if (!Has(step_id, iteration)) {
+            throw std::out_of_range("Step has no sample in this iteration");
+        }
+        return Duration(Duration::InternalType(steps_[step_id][Index(iteration)]));
+    }
+
+    /*
+    Fraction of recorded samples of a step that are shorter than a threshold, approximate in
+    streaming mode
+    */
+    double FractionBelow(int step_id, Duration threshold) const {
+        if (static_cast<std::size_t>(step_id) >= steps_.size()) {
+            return 0.0;
+        }
+        const double threshold_ns = threshold.duration().count();
+        if (streaming()) {
+            return statistics_[step_id].FractionBelow(threshold_ns);
+        }
+        std::size_t below = 0;
+        std::size_t present = 0;
+        for (double sample : steps_[step_id]) {
+            if (!std::isnan(sample)) {
+                ++present;
+                below += sample < threshold_ns ? 1 : 0;
+            }
+        }
+        return present > 0 ? static_cast<double>(below) / present : 0.0;
+    }
+
+    // Sum of durations of all steps of an iteration
+    Duration IterationTotal(std::size_t iteration) const {
+        double result = 0.0;
+        std::size_t index = Index(iteration);
+        for (const auto& step : steps_) {
+            if (!std::isnan(step.at(index))) {
+                result += step[index];
+            }
+        }
+        return Duration(Duration::InternalType(result));
+    }
+
+private:
+    static double Missing() { return std::numeric_limits<double>::quiet_NaN(); }
+
+    void AddSteps(std::size_t step_count) {
+        std::size_t old_size = steps_.size();
+        steps_.resize(step_count);
+        for (std::size_t i = old_size; i < steps_.size(); ++i) {
+            if (streaming()) {
+                steps_[i].assign(1, Missing());
+            } else {
+                steps_[i].reserve(std::max(reserved_, iteration_count_));
+                steps_[i].assign(iteration_count_, Missing());
+            }
+        }
+        if (streaming()) {
+            statistics_.resize(step_count);
+        }
+    }
+
+    std::size_t Index(std::size_t iteration) const {
+        if (!streaming()) {
+            return iteration;
+        }
+        if (iteration + 1 != iteration_count_) {
+            throw std::out_of_range("Only the last iteration is stored in streaming mode");
+        }
+        return 0;
+    }
+
+    Storage storage_;
+    std::vector<std::vector<double /* nanoseconds */>> steps_;
+    std::vector<StreamingStatistics> statistics_;  // Streaming mode only
+    std::size_t iteration_count_ = 0;
+    std::size_t reserved_ = 0;
 };
 
-struct StepInfo {
-    int order = 0;  // Order in which this step was added
+struct FixtureResult {
+    IterationSamples samples;       // Steady state iterations
+    IterationSamples cold_samples;  // First iterations of a fixture
+    bool cold_cache = false;        // Caches were flushed before every cold iteration
+    int queue_count = 1;
+    int launch_count = 1;  // Launches of every batched step in an iteration
+    // IDs of batched steps, their samples are durations of one launch. Other steps of a batched
+    // fixture are measured once per iteration
+    std::set<int> batched_steps;
+    // Profiling timer resolution of a device, known if fixture supports batching
+    boost::optional<Duration> timer_resolution;
+    // Wall clock time of lifecycle phases (initialize, verifyResults, storeResults, finalize,
+    // destroy), of the whole fixture run (total) and build time of its programs (build)
+    std::map<std::string, Duration> lifecycle;
+    // Average wall clock time of one iteration measured on a host (excluding warm-up)
+    boost::optional<Duration> host_iteration_time;
+
+    boost::optional<ResultAccuracy> accuracy;
+    boost::optional<WorkAmount> work_amount;
+    boost::optional<HostAllocationStrategy> host_allocation;
+    // Shift of iteration durations in the timed loop, e.g. because of throttling
+    boost::optional<DriftAnalysis> drift;
+    // Host CPU frequency and temperatures right before and after the timed loop
+    boost::optional<HostSensorReading> sensors_before;
+    boost::optional<HostSensorReading> sensors_after;
 
-    StepInfo(int _order) : order(_order) {}
+    boost::optional<std::string> failure_reason;
 };
 
 struct FixtureFamilyResult {
     std::unordered_map<FixtureId, FixtureResult> benchmark;
-    std::unordered_map<std::string /* step name */, StepInfo> steps;
+    StepList steps;
     std::string name;
     boost::optional<int32_t> element_count;
+    int registration_index = 0;  // Position of a family in fixture registry
+    std::unordered_map<FixtureId, BuildVariantInfo> build_variants;
 };
 }  // namespace cl_benchmark
 }  // namespace kpv
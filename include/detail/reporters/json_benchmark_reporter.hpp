@@ -1,8 +1,19 @@
 #ifndef KPV_REPORTERS_JSON_BENCHMARK_REPORTER_H_
 #define KPV_REPORTERS_JSON_BENCHMARK_REPORTER_H_
 
+#include "detail/data/seed.hpp"
+#include "detail/devices/device_group.hpp"
+#include "detail/devices/host_device.hpp"
 #include "detail/devices/platform_list.hpp"
+#include "detail/devices/simulated_device.hpp"
+#include "detail/environment/device_profile.hpp"
+#include "detail/environment/host_environment.hpp"
+#include "detail/environment/roofline_ceilings.hpp"
+#include "detail/environment/timer_calibration.hpp"
+#include "detail/environment/utc_time.hpp"
 #include "detail/indicators/duration_indicator.hpp"
+#include "detail/indicators/throughput_indicator.hpp"
+#include "detail/partitioning/run_shard.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
@@ -10,34 +21,83 @@ class JsonBenchmarkReporter {
 public:
     JsonBenchmarkReporter(const std::string& file_name) : file_name_(file_name) {}
 
-    void Initialize(const PlatformList& platform_list) {
+    void Initialize(
+        const PlatformList& platform_list, const HostEnvironment& host_environment,
+        uint64_t seed) {
         tree_["baseInfo"] = {{"about", "This file was built by OpenCL benchmark."},
-                             {"time", GetCurrentTimeString()},
-                             {"formatVersion", "0.1.0"}};
+                             {"time", CurrentUtcTimeString()},
+                             {"formatVersion", "0.1.0"},
+                             {"environment", host_environment},
+                             {"seed", SeedToJson(seed)}};
+        tree_["baseInfo"]["driverVersions"] = nlohmann::json::object();
         for (auto& platform : platform_list.AllPlatforms()) {
             nlohmann::json devices = nlohmann::json::array();
             for (auto& device : platform->GetDevices()) {
                 devices.push_back(device->UniqueName());
+                tree_["baseInfo"]["driverVersions"][device->UniqueName()] =
+                    device->DriverVersion();
             }
             tree_["deviceList"][platform->Name()] = devices;
         }
         tree_["fixtureFamilies"] = nlohmann::json::array();
     }
 
+    /*
+    Mark report as a part of a sharded run, so shard reports can be merged and checked for
+    completeness
+    */
+    void SetShard(const RunShard& shard) {
+        tree_["baseInfo"]["shard"] = {{"index", shard.index + 1}, {"count", shard.count}};
+    }
+
+    /*
+    Store timer calibration, resolution of timers is also used to find steps that are too short
+    to be measured precisely
+    */
+    void SetTimerCalibration(const TimerCalibration& calibration) {
+        timer_calibration_ = calibration;
+        tree_["baseInfo"]["timerCalibration"] = calibration;
+    }
+
+    /*
+    Store measured ceilings of a device, fixtures that declare their work amount are placed on
+    a roofline of their device
+    */
+    void SetRooflineCeilings(const std::string& device_name, const RooflineCeilings& ceilings) {
+        roofline_ceilings_[device_name] = ceilings;
+        tree_["baseInfo"]["rooflineCeilings"][device_name] = ceilings;
+    }
+
+    /*
+    Store a profile of a device measured by a characterization pass, its ceilings are used as
+    a reference for fixtures of the device
+    */
+    void SetDeviceProfile(const std::string& device_name, const DeviceProfile& profile) {
+        tree_["baseInfo"]["deviceProfiles"][device_name] = profile;
+        SetRooflineCeilings(device_name, profile.ceilings);
+    }
+
     void AddFixtureFamilyResults(const FixtureFamilyResult& results) {
         using nlohmann::json;
 
-        json fixture_family_tree = {{"name", results.name}};
+        json fixture_family_tree = {
+            {"name", results.name}, {"registrationIndex", results.registration_index}};
         if (results.element_count) {
             fixture_family_tree["elementCount"] = results.element_count.value();
         }
 
         // Add array of step names to preserve their order
-        std::vector<std::string> step_names(results.steps.size());
-        for (const auto& v : results.steps) {
-            step_names[v.second.order] = v.first;
+        fixture_family_tree["steps"] = results.steps.names();
+
+        // Average iteration duration of all successful fixtures, needed to compare device groups
+        // with their members
+        std::unordered_map<FixtureId, Duration> total_durations;
+        for (auto& data : results.benchmark) {
+            if (!data.second.samples.empty()) {
+                total_durations.emplace(
+                    data.first, DurationIndicator(data.second, results.steps).total_duration());
+            }
         }
-        fixture_family_tree["steps"] = step_names;
 
         json fixture_tree = json::array();
         for (auto& data : results.benchmark) {
@@ -46,14 +106,58 @@ public:
 
             // Add number of iterations, if any
             // Otherwise add failure reason
-            size_t iteration_count = data.second.iterations.size();
+            size_t iteration_count = data.second.samples.iteration_count();
             if (iteration_count > 0) {
                 current_fixture_tree["iterationCount"] = iteration_count;
-                DurationIndicator indicator{data.second};
+                DurationIndicator indicator(data.second, results.steps);
                 indicator.SerializeValue(current_fixture_tree);
+                auto group = std::dynamic_pointer_cast<DeviceGroup>(data.first.device());
+                if (group && group->devices().size() > 1) {
+                    current_fixture_tree["multiDevice"] = SerializeDeviceGroupScaling(
+                        *group, total_durations.at(data.first), total_durations,
+                        results.element_count);
+                }
+                // Simulated devices execute nothing, so all host time is the harness overhead.
+                // For real devices it would be mixed with execution and transfer time
+                if (data.second.host_iteration_time &&
+                    std::dynamic_pointer_cast<SimulatedDevice>(data.first.device())) {
+                    current_fixture_tree["harnessOverheadPerIteration"] =
+                        data.second.host_iteration_time.value();
+                }
+                SerializeTimerResolution(
+                    data.first, data.second, results.steps, current_fixture_tree);
+                SerializeColdIterations(data.second, results.steps, current_fixture_tree);
+                if (data.second.accuracy) {
+                    current_fixture_tree["accuracy"] = {
+                        {"maxRelativeError", data.second.accuracy->max_relative_error},
+                        {"meanRelativeError", data.second.accuracy->mean_relative_error}};
+                }
+                SerializeThroughput(data.first, data.second, results.steps, current_fixture_tree);
+                if (data.second.host_allocation) {
+                    current_fixture_tree["hostAllocation"] = data.second.host_allocation.value();
+                }
+                if (data.second.drift) {
+                    current_fixture_tree["drift"] = data.second.drift.value();
+                }
+                SerializeHostSensors(data.second, current_fixture_tree);
+                SerializeParallelScaling(data.first, total_durations, current_fixture_tree);
+                if (data.second.queue_count > 1) {
+                    current_fixture_tree["queueCount"] = data.second.queue_count;
+                    SerializeQueueScaling(
+                        data.first, total_durations.at(data.first), results,
+                        total_durations, current_fixture_tree);
+                }
             } else if (data.second.failure_reason) {
                 current_fixture_tree["failureReason"] = data.second.failure_reason.value();
             }
+            if (!data.second.lifecycle.empty()) {
+                current_fixture_tree["lifecycle"] = data.second.lifecycle;
+            }
+            auto variant = results.build_variants.find(data.first);
+            if (variant != results.build_variants.end()) {
+                current_fixture_tree["buildVariant"] =
+                    SerializeBuildVariant(data.first, variant->second, total_durations);
+            }
 
             fixture_tree.push_back(current_fixture_tree);
         }
@@ -82,22 +186,265 @@ public:
     }
 
 private:
-    // TODO move to some free function?
-    std::string GetCurrentTimeString() {
-        // TODO replace with some library?
-        // Based on https://stackoverflow.com/a/10467633
-        time_t now = time(nullptr);
-        struct tm tstruct;
-        char buf[80];
-        // TODO gmtime is not thread-safe, do something with that?
-        tstruct = *gmtime(&now);
-        strftime(buf, sizeof(buf), "%FT%TZ", &tstruct);
-        return buf;
+    /*
+    Compare device group fixture with fixtures of the same family on groups of a single member
+    device. Groups are timed on a host, so they are compared only with each other: fixtures of
+    member devices timed by device events would not include host threads, transfers and enqueue
+    cost.
+    */
+    nlohmann::json SerializeDeviceGroupScaling(
+        const DeviceGroup& group, Duration group_duration,
+        const std::unordered_map<FixtureId, Duration>& total_durations,
+        boost::optional<int32_t> element_count) {
+        nlohmann::json result = {{"deviceCount", group.devices().size()}};
+        if (element_count && group_duration > Duration()) {
+            result["combinedThroughput"] = element_count.value() / group_duration.AsSeconds();
+        }
+
+        // Best duration of every member device alone (among all algorithms)
+        std::unordered_map<std::shared_ptr<DeviceInterface>, Duration> member_durations;
+        for (const auto& p : total_durations) {
+            auto single_group = std::dynamic_pointer_cast<DeviceGroup>(p.first.device());
+            if (!single_group || single_group->devices().size() != 1) {
+                continue;
+            }
+            const auto& member = single_group->devices().front();
+            const auto& members = group.devices();
+            if (std::find(members.cbegin(), members.cend(), member) == members.cend()) {
+                continue;
+            }
+            auto iter = member_durations.find(member);
+            if (iter == member_durations.end()) {
+                member_durations.emplace(member, p.second);
+            } else if (p.second < iter->second) {
+                iter->second = p.second;
+            }
+        }
+        if (member_durations.empty() || !(group_duration > Duration())) {
+            return result;
+        }
+
+        auto best = std::min_element(
+            member_durations.cbegin(), member_durations.cend(),
+            [](const std::pair<const std::shared_ptr<DeviceInterface>, Duration>& lhs,
+               const std::pair<const std::shared_ptr<DeviceInterface>, Duration>& rhs) {
+                return lhs.second < rhs.second;
+            });
+        result["bestSingleDevice"] = best->first->UniqueName();
+        result["speedupOverBestDevice"] = best->second / group_duration;
+
+        // Efficiency is defined only if every member has its own results
+        if (member_durations.size() == group.devices().size()) {
+            double member_throughput_sum = 0.0;
+            for (const auto& p : member_durations) {
+                member_throughput_sum += 1.0 / p.second.AsSeconds();
+            }
+            result["scalingEfficiency"] =
+                (1.0 / group_duration.AsSeconds()) / member_throughput_sum;
+        }
+        return result;
+    }
+
+    /*
+    Compare fixture that uses several command queues with the fastest single-queue fixture on the
+    same device. Speedup above 1 means that the device executes work from different queues
+    concurrently.
+    */
+    void SerializeQueueScaling(
+        const FixtureId& fixture_id, Duration duration, const FixtureFamilyResult& results,
+        const std::unordered_map<FixtureId, Duration>& total_durations, nlohmann::json& tree) {
+        if (results.element_count && duration > Duration()) {
+            tree["aggregateThroughput"] = results.element_count.value() / duration.AsSeconds();
+        }
+        boost::optional<Duration> single_queue_duration;
+        for (const auto& p : total_durations) {
+            if (p.first.device() != fixture_id.device() ||
+                results.benchmark.at(p.first).queue_count != 1) {
+                continue;
+            }
+            if (!single_queue_duration || p.second < single_queue_duration.value()) {
+                single_queue_duration = p.second;
+            }
+        }
+        if (single_queue_duration && duration > Duration()) {
+            tree["speedupOverSingleQueue"] = single_queue_duration.value() / duration;
+        }
+    }
+
+    /*
+    Devices of a thread sweep (host devices) or of a compute unit sweep (an OpenCL device and its
+    sub-devices) have the same sweep name and differ by a number of parallel workers
+    */
+    struct SweepPoint {
+        std::string sweep;
+        int workers = 1;
+    };
+
+    static boost::optional<SweepPoint> GetSweepPoint(
+        const std::shared_ptr<DeviceInterface>& device) {
+        if (auto host_device = std::dynamic_pointer_cast<HostDevice>(device)) {
+            return SweepPoint{"host", host_device->thread_count()};
+        }
+        if (auto opencl_device = std::dynamic_pointer_cast<OpenClDevice>(device)) {
+            return SweepPoint{opencl_device->RootName(), opencl_device->compute_units()};
+        }
+        return boost::none;
+    }
+
+    /*
+    Compare a fixture with the same algorithm on a device of the same sweep with one worker.
+    Written only if a family has the fixture on several devices of a sweep, as threadScaling for
+    host devices and computeUnitScaling for OpenCL ones.
+    */
+    void SerializeParallelScaling(
+        const FixtureId& fixture_id, const std::unordered_map<FixtureId, Duration>& total_durations,
+        nlohmann::json& tree) {
+        auto duration = total_durations.find(fixture_id);
+        const boost::optional<SweepPoint> point = GetSweepPoint(fixture_id.device());
+        if (!point || duration == total_durations.end() || !(duration->second > Duration())) {
+            return;
+        }
+        int sweep_fixture_count = 0;
+        boost::optional<Duration> one_worker_duration;
+        for (const auto& p : total_durations) {
+            const boost::optional<SweepPoint> other = GetSweepPoint(p.first.device());
+            if (!other || other->sweep != point->sweep ||
+                p.first.algorithm() != fixture_id.algorithm()) {
+                continue;
+            }
+            ++sweep_fixture_count;
+            if (other->workers == 1) {
+                one_worker_duration = p.second;
+            }
+        }
+        if (sweep_fixture_count < 2 || !one_worker_duration) {
+            return;
+        }
+        const double speedup = one_worker_duration.value() / duration->second;
+        const double efficiency = speedup / point->workers;
+        if (std::dynamic_pointer_cast<HostDevice>(fixture_id.device())) {
+            tree["threadScaling"] = {
+                {"threadCount", point->workers},
+                {"speedupOverOneThread", speedup},
+                {"parallelEfficiency", efficiency}};
+        } else {
+            tree["computeUnitScaling"] = {
+                {"computeUnits", point->workers},
+                {"speedupOverOneComputeUnit", speedup},
+                {"parallelEfficiency", efficiency}};
+        }
+    }
+
+    /*
+    Options of a fixture that is a build variant of another one and its speedup over the reference
+    fixture built with default options. Speedup is meaningful together with accuracy of results.
+    */
+    nlohmann::json SerializeBuildVariant(
+        const FixtureId& fixture_id, const BuildVariantInfo& info,
+        const std::unordered_map<FixtureId, Duration>& total_durations) {
+        nlohmann::json result = {
+            {"name", info.variant.name},
+            {"options", info.variant.options},
+            {"reference", info.reference.Serialize()}};
+        auto duration = total_durations.find(fixture_id);
+        auto reference_duration = total_durations.find(info.reference);
+        if (duration != total_durations.end() && reference_duration != total_durations.end() &&
+            duration->second > Duration()) {
+            result["speedupOverReference"] = reference_duration->second / duration->second;
+        }
+        return result;
+    }
+
+    void SerializeThroughput(
+        const FixtureId& fixture_id, const FixtureResult& result, const StepList& steps,
+        nlohmann::json& tree) {
+        boost::optional<RooflineCeilings> ceilings;
+        auto iter = roofline_ceilings_.find(fixture_id.device()->UniqueName());
+        if (iter != roofline_ceilings_.end()) {
+            ceilings = iter->second;
+        }
+        ThroughputIndicator(result, steps, ceilings).SerializeValue(tree);
+    }
+
+    /*
+    Host CPU frequency and temperatures around the timed loop. A frequency drop explains a drift
+    of host fixtures and of OpenCL CPU devices
+    */
+    void SerializeHostSensors(const FixtureResult& result, nlohmann::json& tree) {
+        if (!result.sensors_before || !result.sensors_after) {
+            return;
+        }
+        const HostSensorReading& before = result.sensors_before.value();
+        const HostSensorReading& after = result.sensors_after.value();
+        nlohmann::json sensors = {{"before", before}, {"after", after}};
+        if (before.mean_frequency_mhz && after.mean_frequency_mhz &&
+            before.mean_frequency_mhz.value() > 0.0) {
+            sensors["frequencyChange"] =
+                after.mean_frequency_mhz.value() / before.mean_frequency_mhz.value() - 1.0;
+        }
+        tree["hostSensors"] = sensors;
+    }
+
+    /*
+    First iterations of a fixture, in the same format as steady state ones
+    */
+    void SerializeColdIterations(
+        const FixtureResult& result, const StepList& steps, nlohmann::json& tree) {
+        if (result.cold_samples.empty()) {
+            return;
+        }
+        nlohmann::json cold = {
+            {"iterationCount", result.cold_samples.iteration_count()},
+            {"coldCache", result.cold_cache}};
+        FixtureResult cold_result;
+        cold_result.samples = result.cold_samples;
+        DurationIndicator(cold_result, steps).SerializeValue(cold);
+        tree["cold"] = cold;
+    }
+
+    /*
+    Write resolution of a timer used for a fixture and steps that have samples within a few ticks
+    of it, with a fraction of such samples. Samples of batched steps are durations of one launch,
+    so their ticks are divided by a number of launches, other steps are measured once
+    */
+    void SerializeTimerResolution(
+        const FixtureId& fixture_id, const FixtureResult& result, const StepList& steps,
+        nlohmann::json& tree) {
+        static const int kResolutionTicks = 5;
+        boost::optional<Duration> resolution = result.timer_resolution;
+        if (!resolution && timer_calibration_) {
+            resolution = timer_calibration_->Resolution(fixture_id.device());
+        }
+        if (!resolution) {
+            return;
+        }
+        tree["timerResolution"] = resolution.value();
+        if (result.timer_resolution) {
+            // Fixture supports batching
+            tree["launchesPerBatch"] = result.launch_count;
+            tree["effectiveTimerResolution"] = resolution.value() / result.launch_count;
+        }
+        const Duration threshold = resolution.value() * kResolutionTicks;
+        const Duration batched_threshold = threshold / result.launch_count;
+        nlohmann::json imprecise_steps = nlohmann::json::object();
+        for (std::size_t step_id = 0; step_id < result.samples.step_count(); ++step_id) {
+            const bool batched = result.batched_steps.count(static_cast<int>(step_id)) > 0;
+            double fraction = result.samples.FractionBelow(
+                static_cast<int>(step_id), batched ? batched_threshold : threshold);
+            if (fraction > 0.0) {
+                imprecise_steps[steps.name(static_cast<int>(step_id))] = fraction;
+            }
+        }
+        if (!imprecise_steps.empty()) {
+            tree["stepsNearTimerResolution"] = imprecise_steps;
+        }
     }
 
     static const bool pretty_ = true;  // TODO make configurable?
     std::string file_name_;
     nlohmann::json tree_;
+    boost::optional<TimerCalibration> timer_calibration_;
+    std::map<std::string /* unique device name */, RooflineCeilings> roofline_ceilings_;
 };
 
 }  // namespace cl_benchmark
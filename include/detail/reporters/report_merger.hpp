@@ -0,0 +1,163 @@
+#ifndef KPV_REPORTERS_REPORT_MERGER_H_
+#define KPV_REPORTERS_REPORT_MERGER_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "detail/data/seed.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+// Seed of a report, 0 if it is missing
+inline uint64_t SeedOf(const nlohmann::json& base_info) {
+    return base_info.count("seed") > 0 ? SeedFromJson(base_info.at("seed")) : 0;
+}
+
+/*
+Combine JSON reports of several shards of one run into a single report.
+Base information is taken from the first report, driver versions and device lists are joined
+without duplicates. Fixtures of families with the same name are joined into one family, families
+are sorted in registration order.
+Shards run whole families, so comparisons between fixtures of a family (e.g. device group
+against its member devices) are already complete and are not recalculated.
+*/
+inline nlohmann::json MergeReports(const std::vector<nlohmann::json>& reports) {
+    using nlohmann::json;
+    if (reports.empty()) {
+        throw std::invalid_argument("No reports to merge");
+    }
+
+    json result = reports.front();
+    json& base_info = result["baseInfo"];
+    base_info.erase("shard");
+    result["deviceList"] = json::object();
+    result["fixtureFamilies"] = json::array();
+
+    std::set<int> shard_indices;
+    int shard_count = 0;
+    std::unordered_map<std::string, std::size_t> family_positions;
+    for (const json& report : reports) {
+        const json& info = report.at("baseInfo");
+        if (SeedOf(info) != SeedOf(base_info)) {
+            BOOST_LOG_TRIVIAL(warning) << "Merged reports use different input data seeds";
+        }
+        if (info.count("shard") > 0) {
+            int count = info.at("shard").at("count").get<int>();
+            if (shard_count != 0 && count != shard_count) {
+                BOOST_LOG_TRIVIAL(warning) << "Merged reports have different shard count";
+            }
+            shard_count = count;
+            if (!shard_indices.insert(info.at("shard").at("index").get<int>()).second) {
+                BOOST_LOG_TRIVIAL(warning)
+                    << "Shard " << info.at("shard").at("index").get<int>()
+                    << " is given more than once";
+            }
+        }
+        if (info.count("driverVersions") > 0) {
+            base_info["driverVersions"].update(info.at("driverVersions"));
+        }
+        if (info.count("timerCalibration") > 0) {
+            base_info["timerCalibration"]["devices"].update(
+                info.at("timerCalibration").at("devices"));
+        }
+        if (info.count("rooflineCeilings") > 0) {
+            base_info["rooflineCeilings"].update(info.at("rooflineCeilings"));
+        }
+        if (info.count("deviceProfiles") > 0) {
+            base_info["deviceProfiles"].update(info.at("deviceProfiles"));
+        }
+
+        for (const auto& platform : report.at("deviceList").items()) {
+            json& devices = result["deviceList"][platform.key()];
+            if (devices.is_null()) {
+                devices = json::array();
+            }
+            for (const json& device : platform.value()) {
+                if (std::find(devices.cbegin(), devices.cend(), device) == devices.cend()) {
+                    devices.push_back(device);
+                }
+            }
+        }
+
+        for (const json& family : report.at("fixtureFamilies")) {
+            const std::string name = family.at("name").get<std::string>();
+            auto position = family_positions.find(name);
+            if (position == family_positions.end()) {
+                family_positions.emplace(name, result["fixtureFamilies"].size());
+                result["fixtureFamilies"].push_back(family);
+                continue;
+            }
+            json& merged_family = result["fixtureFamilies"][position->second];
+            json& steps = merged_family["steps"];
+            for (const json& step : family.at("steps")) {
+                if (std::find(steps.cbegin(), steps.cend(), step) == steps.cend()) {
+                    steps.push_back(step);
+                }
+            }
+            json& fixtures = merged_family["fixtures"];
+            for (const json& fixture : family.at("fixtures")) {
+                auto same_fixture = std::find_if(
+                    fixtures.cbegin(), fixtures.cend(), [&fixture](const json& f) {
+                        return f.at("name") == fixture.at("name");
+                    });
+                if (same_fixture != fixtures.cend()) {
+                    BOOST_LOG_TRIVIAL(warning)
+                        << "Fixture " << fixture.at("name").get<std::string>() << " of family \""
+                        << name << "\" is found in several reports, only the first one is kept";
+                    continue;
+                }
+                fixtures.push_back(fixture);
+            }
+        }
+    }
+
+    for (int i = 0; i < shard_count; ++i) {
+        if (shard_indices.count(i + 1) == 0) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Shard " << i + 1 << "/" << shard_count << " is missing, report is incomplete";
+        }
+    }
+
+    // Reports of older versions have no registration index, their order is kept as is
+    json& families = result["fixtureFamilies"];
+    std::vector<json> sorted_families(families.begin(), families.end());
+    std::stable_sort(
+        sorted_families.begin(), sorted_families.end(), [](const json& lhs, const json& rhs) {
+            return lhs.value("registrationIndex", -1) < rhs.value("registrationIndex", -1);
+        });
+    families = sorted_families;
+    return result;
+}
+
+/*
+Read reports from files, merge them and write the result to output file
+*/
+inline void MergeReportFiles(
+    const std::vector<std::string>& input_file_names, const std::string& output_file_name) {
+    std::vector<nlohmann::json> reports;
+    for (const std::string& file_name : input_file_names) {
+        std::ifstream file(file_name);
+        if (!file) {
+            throw std::runtime_error("Cannot open report file " + file_name);
+        }
+        reports.push_back(nlohmann::json::parse(file));
+    }
+    nlohmann::json result = MergeReports(reports);
+
+    std::ofstream o(output_file_name);
+    o.exceptions(std::ios_base::badbit | std::ios_base::failbit | std::ios_base::eofbit);
+    o << std::setw(4) << result << std::endl;
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_REPORTERS_REPORT_MERGER_H_
@@ -1,10 +1,16 @@
 #ifndef KPV_RUN_SETTINGS_H_
 #define KPV_RUN_SETTINGS_H_
 
+#include <cstddef>
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "detail/duration.hpp"
+#include "detail/fixtures/build_variant.hpp"
+#include "detail/partitioning/run_shard.hpp"
+#include "detail/simulation/duration_distribution.hpp"
+#include "detail/statistics/drift_detector.hpp"
 
 namespace kpv {
 namespace cl_benchmark {
@@ -18,6 +24,13 @@ struct DeviceConfiguration {
     bool cpu_opencl_devices = true;
     bool gpu_opencl_devices = true;
     bool other_opencl_devices = true;
+    std::vector<DurationDistribution> simulated_devices;  // One distribution per simulated device
+    int host_threads = 0;               // Threads of the host device, 0 for all hardware threads
+    std::size_t host_chunk_size = 0;    // Indices in a chunk of a host parallel loop, 0 for auto
+    bool host_thread_sweep = false;     // Host devices with 1, 2, 4... threads up to host_threads
+    std::vector<int> host_pinned_cpus;  // CPUs of host worker threads, same as runner ones
+    // OpenCL CPU devices are split into sub-devices with 1, 2, 4... compute units
+    bool compute_unit_sweep = false;
 };
 
 struct RunSettings {
@@ -29,8 +42,35 @@ struct RunSettings {
     bool verify_results = true;
     bool store_results = true;
     std::string additional_params;
-    enum Operation { kList, kRunAllExcept, kRunOnly } operation;
+    enum Operation { kList, kRunAllExcept, kRunOnly, kMerge, kCharacterize } operation;
     DeviceConfiguration device_config = DeviceConfiguration(true);
+    std::vector<int> pinned_cpus;      // Empty if runner threads are not pinned
+    uint64_t seed = 0;                 // Seed used to generate input data
+    std::string checkpoint_file_name;  // Empty if checkpoints are not written
+    bool resume = false;               // Skip fixtures that are finished in a checkpoint file
+    RunShard shard;                    // Part of a run executed by this process
+    std::vector<std::string> merge_file_names;  // Reports to merge in kMerge mode
+    Duration total_budget;             // Zero if iterations are chosen from target execution time
+    std::string estimates_file_name;   // Previous report used to estimate fixture costs
+    bool dry_run = false;              // Print a plan of a run without running it
+    bool streaming_statistics = false;  // Keep statistics of durations instead of all samples
+    // Launches of batched steps, 0 if chosen from profiling timer resolution of a device
+    int launch_count = 1;
+    int cold_iterations = 1;  // First iterations that are reported separately from steady state
+    bool cold_cache = false;  // Flush caches before every cold iteration
+    std::vector<BuildVariant> build_variants;  // Benchmarked in addition to default build options
+    int compile_threads = 2;  // Threads that build programs of next fixtures, 0 to build in place
+    // Peak performance of devices written in kCharacterize mode and used as a reference by runs
+    std::string device_profiles_file_name = "device_profiles.json";
+    // Daemon mode: fixtures are run again every daemon_interval, zero runs them once
+    Duration daemon_interval;
+    int daemon_cycles = 0;             // Cycles of a daemon before it exits, 0 for no limit
+    int metrics_port = 0;              // Loopback port of a metrics endpoint, 0 if not served
+    std::string metrics_file_name;     // Empty if metrics are not written to a file
+    int metrics_window = 10;           // Runs of a fixture in rolling statistics of metrics
+    // Smallest relative shift of iteration durations in a timed loop that is reported as drift
+    double drift_threshold = 0.05;
+    DriftAction drift_action = DriftAction::kFlag;  // What is done with drifted iterations
 };
 }  // namespace cl_benchmark
 }  // namespace kpv
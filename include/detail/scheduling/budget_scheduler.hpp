@@ -0,0 +1,274 @@
+#ifndef KPV_SCHEDULING_BUDGET_SCHEDULER_H_
+#define KPV_SCHEDULING_BUDGET_SCHEDULER_H_
+
+#include <algorithm>
+#include <boost/log/trivial.hpp>
+#include <boost/optional.hpp>
+#include <cmath>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "detail/duration.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+What is known about a fixture before it is run
+*/
+struct FixtureCostEstimate {
+    boost::optional<Duration> iteration_duration;
+    boost::optional<double> variation;  // Coefficient of variation of iteration duration
+};
+
+/*
+Planned share of the budget for one fixture
+*/
+struct FixturePlan {
+    std::string key;
+    boost::optional<Duration> iteration_duration;  // Empty if cost is not known yet
+    Duration time;
+    boost::optional<int> iteration_count;  // Steady state iterations, cold ones are overhead
+};
+
+/*
+Splits a total time budget between all fixtures of a run.
+Time given to a fixture is proportional to variation * sqrt(iteration duration), this minimizes
+sum of relative variances of average durations for a given total time (Neyman allocation).
+Unknown durations are replaced by an average of known ones, unknown variations by an average
+of known ones as well (or the same value for all fixtures if none is known).
+Plan is recalculated when a fixture finishes its warm-up (its real cost is known) and when it is
+finished (time spent on initialization, verification and so on is known).
+*/
+class BudgetScheduler {
+public:
+    BudgetScheduler(Duration total_budget, int min_iterations, int max_iterations)
+        : total_budget_(total_budget),
+          min_iterations_(min_iterations),
+          max_iterations_(max_iterations) {}
+
+    /*
+    Add a fixture that will be run. Key must be unique within a run.
+    */
+    void AddFixture(const std::string& key, const FixtureCostEstimate& estimate) {
+        if (!items_.emplace(key, Item{estimate, false}).second) {
+            throw std::invalid_argument("Fixture \"" + key + "\" is already scheduled");
+        }
+        order_.push_back(key);
+    }
+
+    /*
+    Update fixture cost after cold iterations and get number of steady state iterations
+    */
+    int PlanIterations(const std::string& key, Duration iteration_duration) {
+        items_.at(key).estimate.iteration_duration = iteration_duration;
+        for (const FixturePlan& plan : Plan()) {
+            if (plan.key == key) {
+                if (RemainingBudget() <= Duration() && !budget_exhausted_logged_) {
+                    BOOST_LOG_TRIVIAL(warning)
+                        << "Time budget is exhausted, remaining fixtures are run with minimum "
+                           "number of iterations";
+                    budget_exhausted_logged_ = true;
+                }
+                return plan.iteration_count.value();
+            }
+        }
+        throw std::invalid_argument("Fixture \"" + key + "\" is not scheduled or finished");
+    }
+
+    /*
+    Mark fixture as finished. Wall time is time of the whole fixture run, including
+    initialization and warm-up.
+    */
+    void FixtureFinished(const std::string& key, Duration wall_time, int iteration_count) {
+        Item& item = items_.at(key);
+        item.finished = true;
+        spent_ += wall_time;
+        Duration iterations_time;
+        if (item.estimate.iteration_duration) {
+            iterations_time = item.estimate.iteration_duration.value() * iteration_count;
+        }
+        double overhead = std::max(0.0, (wall_time.duration() - iterations_time.duration()).count());
+        overhead_sum_ += overhead;
+        ++overhead_count_;
+    }
+
+    /*
+    Current plan for fixtures that are not finished yet, in order they were added
+    */
+    std::vector<FixturePlan> Plan() const {
+        std::vector<const std::string*> remaining;
+        double known_duration_sum = 0.0;
+        int known_duration_count = 0;
+        double known_variation_sum = 0.0;
+        int known_variation_count = 0;
+        for (const std::string& key : order_) {
+            const Item& item = items_.at(key);
+            if (item.estimate.iteration_duration) {
+                known_duration_sum += item.estimate.iteration_duration->duration().count();
+                ++known_duration_count;
+            }
+            if (item.estimate.variation) {
+                known_variation_sum += item.estimate.variation.value();
+                ++known_variation_count;
+            }
+            if (!item.finished) {
+                remaining.push_back(&key);
+            }
+        }
+        const double default_duration =
+            known_duration_count > 0 ? known_duration_sum / known_duration_count : 0.0;
+        const double default_variation =
+            known_variation_count > 0 ? known_variation_sum / known_variation_count : 1.0;
+
+        std::vector<double> weights;
+        double weight_sum = 0.0;
+        for (const std::string* key : remaining) {
+            const FixtureCostEstimate& estimate = items_.at(*key).estimate;
+            double duration = estimate.iteration_duration
+                                  ? estimate.iteration_duration->duration().count()
+                                  : default_duration;
+            double weight = estimate.variation.value_or(default_variation) *
+                            (duration > 0.0 ? std::sqrt(duration) : 1.0);
+            weights.push_back(weight);
+            weight_sum += weight;
+        }
+
+        double budget = std::max(0.0, RemainingBudget().duration().count());
+        std::vector<FixturePlan> result;
+        for (std::size_t i = 0; i < remaining.size(); ++i) {
+            FixturePlan plan;
+            plan.key = *remaining[i];
+            plan.iteration_duration = items_.at(plan.key).estimate.iteration_duration;
+            double share = weight_sum > 0.0 ? weights[i] / weight_sum
+                                            : 1.0 / static_cast<double>(remaining.size());
+            plan.time = Duration(Duration::InternalType(budget * share));
+            if (plan.iteration_duration && plan.iteration_duration.value() > Duration()) {
+                double count = std::floor(plan.time / plan.iteration_duration.value());
+                plan.iteration_count = static_cast<int>(std::min<double>(
+                    std::max<double>(count, min_iterations_), max_iterations_));
+                plan.time = plan.iteration_duration.value() * plan.iteration_count.value();
+            } else if (plan.iteration_duration) {
+                plan.iteration_count = max_iterations_;
+            }
+            result.push_back(plan);
+        }
+        return result;
+    }
+
+    /*
+    Budget left for iterations of unfinished fixtures, expected overhead of every fixture
+    (initialization, verification and so on) is excluded
+    */
+    Duration RemainingBudget() const {
+        std::size_t remaining_count = std::count_if(
+            items_.cbegin(), items_.cend(),
+            [](const std::pair<const std::string, Item>& p) { return !p.second.finished; });
+        double overhead =
+            overhead_count_ > 0 ? overhead_sum_ / overhead_count_ * remaining_count : 0.0;
+        double budget = (total_budget_.duration() - spent_.duration()).count() - overhead;
+        return Duration(Duration::InternalType(std::max(0.0, budget)));
+    }
+
+    void LogPlan() const {
+        Duration planned_time;
+        bool all_known = true;
+        for (const FixturePlan& plan : Plan()) {
+            planned_time += plan.time;
+            if (plan.iteration_count) {
+                BOOST_LOG_TRIVIAL(info)
+                    << "Plan: " << plan.key << " - " << plan.iteration_count.value()
+                    << " iterations, " << plan.time.AsSeconds() << " s";
+            } else {
+                all_known = false;
+                BOOST_LOG_TRIVIAL(info) << "Plan: " << plan.key << " - about "
+                                        << plan.time.AsSeconds() << " s, cost is not known yet";
+            }
+        }
+        BOOST_LOG_TRIVIAL(info) << "Planned time of iterations is " << planned_time.AsSeconds()
+                                << " s of " << total_budget_.AsSeconds() << " s budget";
+        if (all_known && planned_time > RemainingBudget()) {
+            BOOST_LOG_TRIVIAL(warning)
+                << "Budget is too small for minimum number of iterations of every fixture";
+        }
+    }
+
+private:
+    struct Item {
+        FixtureCostEstimate estimate;
+        bool finished = false;
+    };
+
+    Duration total_budget_;
+    int min_iterations_;
+    int max_iterations_;
+    std::unordered_map<std::string, Item> items_;
+    std::vector<std::string> order_;
+    Duration spent_;
+    double overhead_sum_ = 0.0;  // Nanoseconds
+    int overhead_count_ = 0;
+    bool budget_exhausted_logged_ = false;
+};
+
+/*
+Key of a fixture used to find it in a previous report
+*/
+inline std::string ScheduleKey(const std::string& family_name, const std::string& fixture_name) {
+    return family_name + ": " + fixture_name;
+}
+
+/*
+Read fixture costs from a report of a previous run.
+Variation is estimated from a range of step durations (range of a sample is roughly four standard
+deviations), so it is quite rough, but good enough to find noisy fixtures.
+*/
+inline std::unordered_map<std::string, FixtureCostEstimate> LoadCostEstimates(
+    const nlohmann::json& report) {
+    std::unordered_map<std::string, FixtureCostEstimate> result;
+    for (const nlohmann::json& family : report.at("fixtureFamilies")) {
+        for (const nlohmann::json& fixture : family.at("fixtures")) {
+            FixtureCostEstimate estimate;
+            if (fixture.count("compressedDuration") > 0) {
+                Duration avg, min, max;
+                for (const auto& step : fixture.at("compressedDuration").items()) {
+                    avg += step.value().at("avg").get<Duration>();
+                    min += step.value().at("min").get<Duration>();
+                    max += step.value().at("max").get<Duration>();
+                }
+                estimate.iteration_duration = avg;
+                if (avg > Duration()) {
+                    estimate.variation = (max.duration() - min.duration()) / avg.duration() / 4;
+                }
+            } else if (fixture.count("fullDuration") > 0) {
+                Duration total;
+                for (const auto& step : fixture.at("fullDuration").items()) {
+                    total += step.value().at(0).get<Duration>();
+                }
+                estimate.iteration_duration = total;
+            } else {
+                continue;
+            }
+            result.emplace(
+                ScheduleKey(
+                    family.at("name").get<std::string>(), fixture.at("name").get<std::string>()),
+                estimate);
+        }
+    }
+    return result;
+}
+
+inline std::unordered_map<std::string, FixtureCostEstimate> LoadCostEstimates(
+    const std::string& file_name) {
+    std::ifstream file(file_name);
+    if (!file) {
+        throw std::runtime_error("Cannot open report file " + file_name);
+    }
+    return LoadCostEstimates(nlohmann::json::parse(file));
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_SCHEDULING_BUDGET_SCHEDULER_H_
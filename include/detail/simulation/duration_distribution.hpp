@@ -0,0 +1,139 @@
+#ifndef KPV_SIMULATION_DURATION_DISTRIBUTION_H_
+#define KPV_SIMULATION_DURATION_DISTRIBUTION_H_
+
+#include <algorithm>
+#include <boost/tokenizer.hpp>
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "detail/duration.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Distribution of simulated operation durations.
+Not thread-safe, every simulated device owns its own distribution.
+*/
+class DurationDistribution {
+public:
+    enum class Kind {
+        kFixed,        // Always the same duration
+        kNormal,       // Normal distribution, parameter is standard deviation relative to mean
+        kHeavyTailed,  // Pareto distribution with given mean, parameter is its shape (> 1)
+        kDrifting      // Mean grows by parameter (relative to initial mean) every sample
+    };
+
+    DurationDistribution(Kind kind, Duration mean, double parameter = 0.0, uint64_t seed = 0)
+        : kind_(kind), mean_(mean), parameter_(parameter), engine_(seed) {
+        if (kind_ == Kind::kHeavyTailed && !(parameter_ > 1.0)) {
+            throw std::invalid_argument("Shape of heavy-tailed distribution must be above 1");
+        }
+        if (parameter_ < 0.0) {
+            throw std::invalid_argument("Distribution parameter cannot be negative");
+        }
+    }
+
+    /*
+    Parse distribution from a string "kind:mean[:parameter]", where kind is one of fixed, normal,
+    heavy and drift, e.g. "normal:10mcs:0.05"
+    */
+    static DurationDistribution Parse(const std::string& str, uint64_t seed = 0) {
+        boost::char_separator<char> colon(":");
+        boost::tokenizer<boost::char_separator<char>> tokenizer(str, colon);
+        std::vector<std::string> tokens(tokenizer.begin(), tokenizer.end());
+        if (tokens.size() < 2 || tokens.size() > 3) {
+            throw std::invalid_argument("Incorrect simulated distribution \"" + str + "\"");
+        }
+        Kind kind;
+        double parameter = 0.0;
+        if (tokens[0] == "fixed") {
+            kind = Kind::kFixed;
+        } else if (tokens[0] == "normal") {
+            kind = Kind::kNormal;
+            parameter = 0.05;
+        } else if (tokens[0] == "heavy") {
+            kind = Kind::kHeavyTailed;
+            parameter = 3.0;
+        } else if (tokens[0] == "drift") {
+            kind = Kind::kDrifting;
+            parameter = 0.001;
+        } else {
+            throw std::invalid_argument("Unknown simulated distribution \"" + tokens[0] + "\"");
+        }
+        if (tokens.size() == 3) {
+            try {
+                parameter = std::stod(tokens[2]);
+            } catch (std::exception&) {
+                throw std::invalid_argument("Incorrect distribution parameter \"" + str + "\"");
+            }
+        }
+        return DurationDistribution(kind, ParseDuration(tokens[1]), parameter, seed);
+    }
+
+    Duration Next() {
+        const double mean = mean_.duration().count();
+        double result = mean;
+        switch (kind_) {
+            case Kind::kFixed:
+                break;
+            case Kind::kNormal:
+                result = std::normal_distribution<double>(mean, mean * parameter_)(engine_);
+                break;
+            case Kind::kHeavyTailed: {
+                // Inverse transform sampling, scale is chosen so the mean is preserved
+                double scale = mean * (parameter_ - 1.0) / parameter_;
+                double u = std::uniform_real_distribution<double>(0.0, 1.0)(engine_);
+                result = scale / std::pow(1.0 - u, 1.0 / parameter_);
+                break;
+            }
+            case Kind::kDrifting:
+                result = mean * (1.0 + parameter_ * sample_index_);
+                break;
+        }
+        ++sample_index_;
+        return Duration(Duration::InternalType(std::max(0.0, result)));
+    }
+
+    std::string Description() const {
+        std::stringstream result;
+        switch (kind_) {
+            case Kind::kFixed:
+                result << "fixed";
+                break;
+            case Kind::kNormal:
+                result << "normal";
+                break;
+            case Kind::kHeavyTailed:
+                result << "heavy-tailed";
+                break;
+            case Kind::kDrifting:
+                result << "drifting";
+                break;
+        }
+        result << ", " << mean_.duration().count() << " ns";
+        if (kind_ != Kind::kFixed) {
+            result << ", " << parameter_;
+        }
+        return result.str();
+    }
+
+    Kind kind() const { return kind_; }
+
+    Duration mean() const { return mean_; }
+
+private:
+    Kind kind_;
+    Duration mean_;
+    double parameter_;
+    std::mt19937_64 engine_;
+    uint64_t sample_index_ = 0;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_SIMULATION_DURATION_DISTRIBUTION_H_
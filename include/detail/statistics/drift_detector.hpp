@@ -0,0 +1,160 @@
+#ifndef KPV_STATISTICS_DRIFT_DETECTOR_H_
+#define KPV_STATISTICS_DRIFT_DETECTOR_H_
+
+#include <algorithm>
+#include <boost/optional.hpp>
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "detail/duration.hpp"
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+What is done with iterations after a change point: they are only reported, removed from
+results, or removed and measured again
+*/
+enum class DriftAction { kFlag, kDiscard, kRerun };
+
+inline const char* DriftActionName(DriftAction action) {
+    switch (action) {
+    case DriftAction::kFlag:
+        return "flag";
+    case DriftAction::kDiscard:
+        return "discard";
+    case DriftAction::kRerun:
+        return "rerun";
+    }
+    throw std::invalid_argument("Unknown drift action.");
+}
+
+inline DriftAction DriftActionFromName(const std::string& name) {
+    for (auto action : {DriftAction::kFlag, DriftAction::kDiscard, DriftAction::kRerun}) {
+        if (name == DriftActionName(action)) {
+            return action;
+        }
+    }
+    throw std::invalid_argument("Unknown drift action: " + name);
+}
+
+/*
+Shift of a mean of a series at one iteration, e.g. when a device starts throttling
+*/
+struct ChangePoint {
+    std::size_t index = 0;  // First iteration after a change
+    double mean_before = 0.0;  // Nanoseconds
+    double mean_after = 0.0;
+    double relative_shift = 0.0;  // Positive if iterations became slower
+    double score = 0.0;           // Shift in units of its standard error
+};
+
+/*
+Find the most significant shift of a mean in a series of iteration durations (binary
+segmentation with a single split). Noise is estimated from differences of neighbouring
+iterations, so it is not inflated by the shift itself. A shift is reported only if it is both
+significant and larger than min_relative_shift, so tiny but stable differences of long runs are
+not flagged. Means are taken after a median filter of kFilterWidth iterations, so isolated slow
+iterations (interrupts, page faults) are not mistaken for a shift of a short segment.
+*/
+inline boost::optional<ChangePoint> DetectChangePoint(
+    const std::vector<double>& series, double min_relative_shift) {
+    static const std::size_t kMinSegment = 5;
+    static const std::size_t kFilterWidth = 5;
+    static const double kMinScore = 5.0;
+    const std::size_t n = series.size();
+    if (n < 2 * kMinSegment) {
+        return boost::none;
+    }
+
+    // Median absolute difference of neighbours is sqrt(2) * 0.6745 sigma for normal noise
+    std::vector<double> differences(n - 1);
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        differences[i] = std::abs(series[i + 1] - series[i]);
+    }
+    std::nth_element(
+        differences.begin(), differences.begin() + differences.size() / 2, differences.end());
+    const double sigma = differences[differences.size() / 2] / (std::sqrt(2.0) * 0.6745);
+
+    std::vector<double> prefix(n + 1, 0.0);
+    std::vector<double> window;
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::size_t begin = i >= kFilterWidth / 2 ? i - kFilterWidth / 2 : 0;
+        const std::size_t end = std::min(i + kFilterWidth / 2 + 1, n);
+        window.assign(series.begin() + begin, series.begin() + end);
+        // Windows at the ends are shorter, a lower median of an even window skips a slow outlier
+        const std::size_t middle = (window.size() - 1) / 2;
+        std::nth_element(window.begin(), window.begin() + middle, window.end());
+        prefix[i + 1] = prefix[i] + window[middle];
+    }
+    boost::optional<ChangePoint> best;
+    for (std::size_t k = kMinSegment; k + kMinSegment <= n; ++k) {
+        const double before = prefix[k] / k;
+        const double after = (prefix[n] - prefix[k]) / (n - k);
+        const double error = sigma * std::sqrt(1.0 / k + 1.0 / (n - k));
+        const double shift = std::abs(after - before);
+        // Constant series with a step has no noise at all
+        const double score = error > 0.0 ? shift / error
+                                          : (shift > 0.0 ? std::numeric_limits<double>::max()
+                                                         : 0.0);
+        // Without noise every split around a step has the same score, the step has the largest
+        // shift
+        if (!best || score > best->score ||
+            (score == best->score && shift > std::abs(best->mean_after - best->mean_before))) {
+            best = ChangePoint{k, before, after, before > 0.0 ? (after - before) / before : 0.0,
+                               score};
+        }
+    }
+    if (!best || best->score < kMinScore || std::abs(best->relative_shift) < min_relative_shift) {
+        return boost::none;
+    }
+    return best;
+}
+
+/*
+Drift found in the timed loop of a fixture and what was done with it
+*/
+struct DriftAnalysis {
+    ChangePoint change_point;
+    DriftAction action = DriftAction::kFlag;
+    std::size_t discarded_iterations = 0;  // Iterations after a change point that were removed
+    std::size_t rerun_iterations = 0;      // Iterations measured again instead of removed ones
+    bool persists = false;                 // Drift is found again in results after a re-run
+};
+
+inline void to_json(nlohmann::json& j, const DriftAnalysis& d) {
+    j = nlohmann::json::object(
+        {{"changePoint", d.change_point.index},
+         {"meanBefore", Duration(Duration::InternalType(d.change_point.mean_before))},
+         {"meanAfter", Duration(Duration::InternalType(d.change_point.mean_after))},
+         {"relativeShift", d.change_point.relative_shift},
+         {"score", d.change_point.score},
+         {"action", DriftActionName(d.action)}});
+    if (d.discarded_iterations > 0) {
+        j["discardedIterations"] = d.discarded_iterations;
+    }
+    if (d.action == DriftAction::kRerun) {
+        j["rerunIterations"] = d.rerun_iterations;
+        j["persists"] = d.persists;
+    }
+}
+
+inline void from_json(const nlohmann::json& j, DriftAnalysis& d) {
+    d.change_point.index = j.at("changePoint").get<std::size_t>();
+    d.change_point.mean_before = j.at("meanBefore").get<Duration>().duration().count();
+    d.change_point.mean_after = j.at("meanAfter").get<Duration>().duration().count();
+    d.change_point.relative_shift = j.at("relativeShift").get<double>();
+    d.change_point.score = j.at("score").get<double>();
+    d.action = DriftActionFromName(j.at("action").get<std::string>());
+    d.discarded_iterations = j.value("discardedIterations", std::size_t(0));
+    d.rerun_iterations = j.value("rerunIterations", std::size_t(0));
+    d.persists = j.value("persists", false);
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_STATISTICS_DRIFT_DETECTOR_H_
@@ -0,0 +1,182 @@
+#ifndef KPV_STATISTICS_STREAMING_STATISTICS_H_
+#define KPV_STATISTICS_STREAMING_STATISTICS_H_
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+#include "nlohmann/json.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Histogram with logarithmic buckets: every power of two is split into kSubBuckets buckets of equal
+relative width, so any quantile is known with about 0.6% relative error. Range is 1 ns to
+2^44 ns (about 4.9 hours), values outside of it go to the first or the last bucket.
+Memory is allocated once in a constructor and does not depend on a number of samples.
+*/
+class LogHistogram {
+public:
+    static constexpr int kSubBuckets = 64;
+    static constexpr int kOctaves = 44;
+    static constexpr int kBucketCount = kSubBuckets * kOctaves;
+
+    LogHistogram() : buckets_(kBucketCount, 0) {}
+
+    void Add(double value) {
+        ++buckets_[BucketIndex(value)];
+        ++count_;
+    }
+
+    /*
+    Value below which a given fraction q of samples lies, taken as a geometric middle of a bucket
+    */
+    double Quantile(double q) const {
+        if (count_ == 0) {
+            throw std::logic_error("Quantile of an empty histogram is requested");
+        }
+        q = std::min(std::max(q, 0.0), 1.0);
+        uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * count_)));
+        uint64_t cumulative = 0;
+        for (int i = 0; i < kBucketCount; ++i) {
+            cumulative += buckets_[i];
+            if (cumulative >= rank) {
+                return BucketMiddle(i);
+            }
+        }
+        return BucketMiddle(kBucketCount - 1);
+    }
+
+    uint64_t count() const { return count_; }
+
+    // Number of values in buckets that are entirely below a given value
+    uint64_t CountBelow(double value) const {
+        uint64_t result = 0;
+        for (int i = 0; i < BucketIndex(value); ++i) {
+            result += buckets_[i];
+        }
+        return result;
+    }
+
+    static int BucketIndex(double value) {
+        if (!(value > 1.0)) {
+            return 0;
+        }
+        double index = std::floor(std::log2(value) * kSubBuckets);
+        return static_cast<int>(std::min<double>(index, kBucketCount - 1));
+    }
+
+    static double BucketMiddle(int index) {
+        return std::exp2((index + 0.5) / kSubBuckets);
+    }
+
+    friend void to_json(nlohmann::json& j, const LogHistogram& h) {
+        // Only non-empty buckets are stored, as pairs of index and count
+        j = nlohmann::json::array();
+        for (int i = 0; i < kBucketCount; ++i) {
+            if (h.buckets_[i] > 0) {
+                j.push_back({i, h.buckets_[i]});
+            }
+        }
+    }
+
+    friend void from_json(const nlohmann::json& j, LogHistogram& h) {
+        h = LogHistogram();
+        for (const nlohmann::json& bucket : j) {
+            int index = bucket.at(0).get<int>();
+            if (index < 0 || index >= kBucketCount) {
+                throw std::invalid_argument("Incorrect histogram bucket index");
+            }
+            uint64_t count = bucket.at(1).get<uint64_t>();
+            h.buckets_[index] += count;
+            h.count_ += count;
+        }
+    }
+
+private:
+    std::vector<uint64_t> buckets_;
+    uint64_t count_ = 0;
+};
+
+/*
+Statistics of a stream of values that are not stored: mean and variance (Welford's algorithm),
+minimum, maximum and a histogram for quantiles
+*/
+class StreamingStatistics {
+public:
+    void Add(double value) {
+        ++count_;
+        double delta = value - mean_;
+        mean_ += delta / count_;
+        m2_ += delta * (value - mean_);
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+        histogram_.Add(value);
+    }
+
+    uint64_t count() const { return count_; }
+
+    double mean() const { return mean_; }
+
+    double sum() const { return mean_ * count_; }
+
+    // Sample variance, zero if there are less than two values
+    double variance() const { return count_ > 1 ? m2_ / (count_ - 1) : 0.0; }
+
+    double standard_deviation() const { return std::sqrt(variance()); }
+
+    double min() const { return min_; }
+
+    double max() const { return max_; }
+
+    // Quantile is clamped to a range of values, so extreme quantiles are exact
+    double Quantile(double q) const {
+        if (count_ > 0 && q <= 0.0) {
+            return min_;
+        }
+        if (count_ > 0 && q >= 1.0) {
+            return max_;
+        }
+        return std::min(std::max(histogram_.Quantile(q), min_), max_);
+    }
+
+    // Approximate fraction of values below a given one
+    double FractionBelow(double value) const {
+        if (count_ == 0 || value <= min_) {
+            return 0.0;
+        }
+        if (value > max_) {
+            return 1.0;
+        }
+        return static_cast<double>(histogram_.CountBelow(value)) / count_;
+    }
+
+    friend void to_json(nlohmann::json& j, const StreamingStatistics& s) {
+        j = {{"count", s.count_}, {"mean", s.mean_}, {"m2", s.m2_},
+             {"min", s.min_},     {"max", s.max_},   {"histogram", s.histogram_}};
+    }
+
+    friend void from_json(const nlohmann::json& j, StreamingStatistics& s) {
+        j.at("count").get_to(s.count_);
+        j.at("mean").get_to(s.mean_);
+        j.at("m2").get_to(s.m2_);
+        j.at("min").get_to(s.min_);
+        j.at("max").get_to(s.max_);
+        j.at("histogram").get_to(s.histogram_);
+    }
+
+private:
+    uint64_t count_ = 0;
+    double mean_ = 0.0;
+    double m2_ = 0.0;  // Sum of squared differences from the mean
+    double min_ = std::numeric_limits<double>::infinity();
+    double max_ = -std::numeric_limits<double>::infinity();
+    LogHistogram histogram_;
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_STATISTICS_STREAMING_STATISTICS_H_
@@ -0,0 +1,47 @@
+#ifndef KPV_THREADING_RUN_IN_PARALLEL_H_
+#define KPV_THREADING_RUN_IN_PARALLEL_H_
+
+#include <cstddef>
+#include <exception>
+#include <thread>
+#include <vector>
+
+#include "detail/environment/thread_affinity.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Call func(index) for every index in [0, count) range, every call is made on its own thread.
+Returns when all calls are finished. If any call throws, the first exception (by index) is
+rethrown after all threads are joined.
+Threads are pinned to pinned_cpus if the list is not empty.
+*/
+template <typename F>
+void RunInParallel(
+    std::size_t count, F func, const std::vector<int>& pinned_cpus = std::vector<int>()) {
+    std::vector<std::exception_ptr> errors(count);
+    std::vector<std::thread> threads;
+    threads.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        threads.emplace_back([&func, &errors, &pinned_cpus, i]() {
+            try {
+                PinCurrentThread(pinned_cpus);
+                func(i);
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        });
+    }
+    for (std::thread& t : threads) {
+        t.join();
+    }
+    for (std::exception_ptr& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_THREADING_RUN_IN_PARALLEL_H_
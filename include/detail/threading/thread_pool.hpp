@@ -0,0 +1,223 @@
+#ifndef KPV_THREADING_THREAD_POOL_H_
+#define KPV_THREADING_THREAD_POOL_H_
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "detail/environment/thread_affinity.hpp"
+#include "detail/partitioning/work_partitioner.hpp"
+
+namespace kpv {
+namespace cl_benchmark {
+/*
+Fixed set of threads that execute parallel loops of host fixtures. An index range is cut into
+chunks that are dealt to threads in contiguous blocks, a thread that finishes its block steals
+chunks from the end of blocks of other threads, so uneven work is balanced.
+Calling thread is one of the threads of a pool, so a pool of one thread runs loops serially
+without synchronization. Worker threads are pinned to pinned_cpus if the list is not empty.
+*/
+class ThreadPool {
+public:
+    // chunk_size is a default number of indices in a chunk, 0 to choose it from a range size
+    explicit ThreadPool(
+        int thread_count, std::size_t chunk_size = 0,
+        const std::vector<int>& pinned_cpus = std::vector<int>())
+        : queues_(std::max(thread_count, 1)), chunk_size_(chunk_size) {
+        workers_.reserve(queues_.size() - 1);
+        for (std::size_t i = 1; i < queues_.size(); ++i) {
+            workers_.emplace_back([this, i, pinned_cpus]() {
+                PinCurrentThread(pinned_cpus);
+                WorkerLoop(i);
+            });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool() noexcept {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        start_condition_.notify_all();
+        for (std::thread& t : workers_) {
+            t.join();
+        }
+    }
+
+    int thread_count() const { return static_cast<int>(queues_.size()); }
+
+    /*
+    Number of indices in a chunk of a loop over count indices. Chunk k is
+    [k * chunk_size, min((k + 1) * chunk_size, count)), so results may be stored per chunk.
+    Automatic size gives every thread several chunks to steal.
+    */
+    std::size_t ChunkSize(std::size_t count) const {
+        static const std::size_t kChunksPerThread = 8;
+        if (chunk_size_ > 0) {
+            return chunk_size_;
+        }
+        const std::size_t chunk_count = queues_.size() * kChunksPerThread;
+        return std::max<std::size_t>((count + chunk_count - 1) / chunk_count, 1);
+    }
+
+    /*
+    Call func(begin, end) for every chunk of [0, count) range and return when all of them are
+    finished. If a call throws, remaining chunks are skipped and the first exception is rethrown.
+    Loops must not be started from inside of func.
+    */
+    template <typename F>
+    void ParallelFor(std::size_t count, F func) {
+        ParallelFor(count, ChunkSize(count), func);
+    }
+
+    template <typename F>
+    void ParallelFor(std::size_t count, std::size_t chunk_size, F func) {
+        if (count == 0) {
+            return;
+        }
+        if (chunk_size == 0) {
+            throw std::invalid_argument("Chunk size of a parallel loop must be positive.");
+        }
+        const std::size_t chunk_count = (count + chunk_size - 1) / chunk_size;
+        if (queues_.size() == 1 || chunk_count == 1) {
+            for (std::size_t begin = 0; begin < count; begin += chunk_size) {
+                func(begin, std::min(begin + chunk_size, count));
+            }
+            return;
+        }
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ = [&func](std::size_t begin, std::size_t end) { func(begin, end); };
+        error_ = nullptr;
+        failed_ = false;
+        remaining_chunks_ = chunk_count;
+        // Every thread gets a contiguous block of chunks, so neighbouring data stay on one thread
+        const std::vector<WorkRange> blocks = StaticPartition(chunk_count, queues_.size());
+        for (std::size_t i = 0; i < queues_.size(); ++i) {
+            std::lock_guard<std::mutex> queue_lock(queues_[i].mutex);
+            for (std::size_t chunk = blocks[i].begin; chunk < blocks[i].end; ++chunk) {
+                queues_[i].chunks.push_back(
+                    WorkRange{chunk * chunk_size, std::min((chunk + 1) * chunk_size, count)});
+            }
+        }
+        active_workers_ = workers_.size();
+        ++generation_;
+        lock.unlock();
+        start_condition_.notify_all();
+
+        RunChunks(0);
+
+        lock.lock();
+        // Workers may still look for chunks to steal after the last one is finished
+        finish_condition_.wait(
+            lock, [this]() { return remaining_chunks_ == 0 && active_workers_ == 0; });
+        job_ = nullptr;
+        if (error_) {
+            std::exception_ptr error = error_;
+            error_ = nullptr;
+            std::rethrow_exception(error);
+        }
+    }
+
+private:
+    struct WorkQueue {
+        std::mutex mutex;
+        std::deque<WorkRange> chunks;
+    };
+
+    std::vector<WorkQueue> queues_;  // One per thread, the calling thread has index 0
+    std::vector<std::thread> workers_;
+    const std::size_t chunk_size_;
+
+    // Counters are updated after every chunk, so they don't take the mutex
+    std::atomic<std::size_t> remaining_chunks_{0};
+    std::atomic<bool> failed_{false};  // Remaining chunks are skipped
+
+    std::mutex mutex_;  // Guards all members below
+    std::condition_variable start_condition_;
+    std::condition_variable finish_condition_;
+    std::function<void(std::size_t, std::size_t)> job_;
+    std::exception_ptr error_;
+    std::size_t active_workers_ = 0;
+    std::size_t generation_ = 0;
+    bool stop_ = false;
+
+    void WorkerLoop(std::size_t index) {
+        std::size_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                start_condition_.wait(
+                    lock, [&]() { return stop_ || generation_ != seen_generation; });
+                if (stop_) {
+                    return;
+                }
+                seen_generation = generation_;
+            }
+            RunChunks(index);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                --active_workers_;
+            }
+            finish_condition_.notify_all();
+        }
+    }
+
+    // Own chunks are taken from the front, stolen ones from the back of other queues
+    bool TakeChunk(std::size_t index, WorkRange& chunk) {
+        for (std::size_t i = 0; i < queues_.size(); ++i) {
+            const std::size_t victim = (index + i) % queues_.size();
+            std::lock_guard<std::mutex> lock(queues_[victim].mutex);
+            std::deque<WorkRange>& chunks = queues_[victim].chunks;
+            if (chunks.empty()) {
+                continue;
+            }
+            if (victim == index) {
+                chunk = chunks.front();
+                chunks.pop_front();
+            } else {
+                chunk = chunks.back();
+                chunks.pop_back();
+            }
+            return true;
+        }
+        return false;
+    }
+
+    void RunChunks(std::size_t index) {
+        WorkRange chunk;
+        while (TakeChunk(index, chunk)) {
+            if (!failed_) {
+                try {
+                    job_(chunk.begin, chunk.end);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (!error_) {
+                        error_ = std::current_exception();
+                    }
+                    failed_ = true;
+                }
+            }
+            if (--remaining_chunks_ == 0) {
+                // Mutex is taken, so the notification is not lost between a check and a wait
+                std::lock_guard<std::mutex> lock(mutex_);
+                finish_condition_.notify_all();
+            }
+        }
+    }
+};
+}  // namespace cl_benchmark
+}  // namespace kpv
+
+#endif  // KPV_THREADING_THREAD_POOL_H_
@@ -0,0 +1,63 @@
+#include <chrono>
+#include <string>
+
+#include "catch.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+
+TEST_CASE("Step names are interned once", "[benchmark_results]") {
+    using namespace kpv::cl_benchmark;
+    StepList steps;
+    REQUIRE(steps.Intern("copy") == 0);
+    REQUIRE(steps.Intern("run") == 1);
+    REQUIRE(steps.Intern(std::string("copy")) == 0);
+    // Wrong hint falls back to a lookup
+    REQUIRE(steps.Intern("run", 0) == 1);
+    REQUIRE(steps.Intern("run", 1) == 1);
+    REQUIRE(steps.Intern("new", 5) == 2);
+    REQUIRE(steps.size() == 3);
+    REQUIRE(steps.name(2) == "new");
+}
+
+TEST_CASE("Samples are stored per step", "[benchmark_results]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    IterationSamples samples;
+    samples.Reserve(3);
+    REQUIRE_THROWS_AS(samples.Record(0, Duration(1ns)), std::logic_error);
+
+    samples.AddIteration();
+    samples.Record(0, Duration(1ns));
+    samples.Record(0, Duration(100ns));  // The first duration of a step is kept
+    samples.AddIteration();
+    samples.Record(1, Duration(2ns));  // A step that appears later
+    samples.Record(0, Duration(3ns));
+
+    REQUIRE(samples.iteration_count() == 2);
+    REQUIRE(samples.step_count() == 2);
+    REQUIRE(samples.Get(0, 0) == Duration(1ns));
+    REQUIRE_FALSE(samples.Has(1, 0));
+    REQUIRE(samples.Get(1, 1) == Duration(2ns));
+    REQUIRE(samples.IterationTotal(0) == Duration(1ns));
+    REQUIRE(samples.IterationTotal(1) == Duration(5ns));
+}
+
+TEST_CASE("Last iterations are removed", "[benchmark_results]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    IterationSamples samples;
+    for (int i = 1; i <= 3; ++i) {
+        samples.AddIteration();
+        samples.Record(0, Duration(1ns) * i);
+    }
+    samples.Truncate(5);
+    REQUIRE(samples.iteration_count() == 3);
+    samples.Truncate(1);
+    REQUIRE(samples.iteration_count() == 1);
+    samples.AddIteration();
+    samples.Record(0, Duration(7ns));
+    REQUIRE(samples.Get(0, 0) == Duration(1ns));
+    REQUIRE(samples.Get(0, 1) == Duration(7ns));
+
+    IterationSamples streaming(IterationSamples::Storage::kStreaming);
+    REQUIRE_THROWS_AS(streaming.Truncate(0), std::logic_error);
+}
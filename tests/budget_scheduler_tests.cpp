@@ -0,0 +1,68 @@
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/scheduling/budget_scheduler.hpp"
+
+TEST_CASE("Budget is split using variation and cost", "[budget_scheduler]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    BudgetScheduler scheduler(Duration(10s), 1, 1000000000);
+    FixtureCostEstimate noisy;
+    noisy.iteration_duration = Duration(1ms);
+    noisy.variation = 0.2;
+    FixtureCostEstimate stable;
+    stable.iteration_duration = Duration(1ms);
+    stable.variation = 0.1;
+    scheduler.AddFixture("noisy", noisy);
+    scheduler.AddFixture("stable", stable);
+
+    std::vector<FixturePlan> plan = scheduler.Plan();
+    REQUIRE(plan.size() == 2);
+    REQUIRE(plan[0].key == "noisy");
+    // Noisy fixture gets two thirds of the budget
+    REQUIRE(plan[0].iteration_count.value() == 6666);
+    REQUIRE(plan[1].iteration_count.value() == 3333);
+}
+
+TEST_CASE("Budget is re-planned when costs are known", "[budget_scheduler]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    BudgetScheduler scheduler(Duration(10s), 2, 1000000000);
+    scheduler.AddFixture("first", FixtureCostEstimate());
+    scheduler.AddFixture("second", FixtureCostEstimate());
+
+    std::vector<FixturePlan> plan = scheduler.Plan();
+    REQUIRE_FALSE(plan[0].iteration_count.is_initialized());
+    REQUIRE(plan[0].time == Duration(5s));
+
+    REQUIRE(scheduler.PlanIterations("first", Duration(1ms)) == 5000);
+    // Half of a second is spent on initialization and other overhead
+    scheduler.FixtureFinished("first", Duration(5500ms), 5000);
+    REQUIRE(scheduler.RemainingBudget() == Duration(4s));
+    REQUIRE(scheduler.PlanIterations("second", Duration(1ms)) == 4000);
+
+    // Minimum number of iterations is used when budget is exhausted
+    scheduler.FixtureFinished("second", Duration(20s), 4000);
+    REQUIRE(scheduler.RemainingBudget() == Duration());
+}
+
+TEST_CASE("Cost estimates are read from a report", "[budget_scheduler]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    nlohmann::json report = {
+        {"fixtureFamilies",
+         {{{"name", "family"},
+           {"fixtures",
+            {{{"name", "device"},
+              {"compressedDuration",
+               {{"step",
+                 {{"avg", Duration(10ns)}, {"min", Duration(8ns)}, {"max", Duration(16ns)}}}}}},
+             {{"name", "failed device"}, {"failureReason", "error"}}}}}}}};
+    auto estimates = LoadCostEstimates(report);
+    REQUIRE(estimates.size() == 1);
+    const FixtureCostEstimate& estimate = estimates.at(ScheduleKey("family", "device"));
+    REQUIRE(estimate.iteration_duration.value() == Duration(10ns));
+    REQUIRE(estimate.variation.value() == Approx(0.2));
+}
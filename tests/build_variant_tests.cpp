@@ -0,0 +1,90 @@
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/fixtures/fixture_family.hpp"
+#include "test_device.hpp"
+
+namespace {
+class TestFixture : public kpv::cl_benchmark::Fixture {
+public:
+    TestFixture(bool supports_variants, const std::string& build_options)
+        : supports_variants_(supports_variants), build_options_(build_options) {}
+
+    kpv::cl_benchmark::EventList Execute(const kpv::cl_benchmark::RuntimeParams&) override {
+        return kpv::cl_benchmark::EventList();
+    }
+
+    std::shared_ptr<kpv::cl_benchmark::Fixture> CreateBuildVariant(
+        const std::string& build_options) override {
+        if (!supports_variants_) {
+            return nullptr;
+        }
+        return std::make_shared<TestFixture>(true, build_options_ + build_options);
+    }
+
+    const std::string& build_options() const { return build_options_; }
+
+private:
+    bool supports_variants_;
+    std::string build_options_;
+};
+}  // namespace
+
+TEST_CASE("Build variants are parsed", "[build_variant]") {
+    using namespace kpv::cl_benchmark;
+    auto variants = ParseBuildVariants("mad-enable, -cl-denorms-are-zero");
+    REQUIRE(variants.size() == 2);
+    REQUIRE(variants[0].name == "mad-enable");
+    REQUIRE(variants[0].options == "-cl-mad-enable");
+    REQUIRE(variants[1].name == "-cl-denorms-are-zero");
+    REQUIRE(variants[1].options == "-cl-denorms-are-zero");
+
+    REQUIRE(ParseBuildVariants("all").size() == KnownBuildVariants().size());
+    REQUIRE(ParseBuildVariants("").empty());
+    REQUIRE_THROWS_AS(ParseBuildVariants("fast-math"), std::invalid_argument);
+}
+
+TEST_CASE("Build variants are added as algorithms", "[build_variant]") {
+    using namespace kpv::cl_benchmark;
+    std::shared_ptr<DeviceInterface> device = std::make_shared<TestDevice>("device");
+    FixtureFamily family;
+    family.name = "family";
+    FixtureId plain(family.name, device, "");
+    FixtureId named(family.name, device, "named");
+    FixtureId unsupported(family.name, device, "unsupported");
+    family.fixtures.emplace(plain, std::make_shared<TestFixture>(true, ""));
+    family.fixtures.emplace(named, std::make_shared<TestFixture>(true, ""));
+    family.fixtures.emplace(unsupported, std::make_shared<TestFixture>(false, ""));
+
+    ExpandBuildVariants(family, ParseBuildVariants("fast-relaxed-math,mad-enable"));
+    REQUIRE(family.fixtures.size() == 7);
+    REQUIRE(family.build_variants.size() == 4);
+
+    FixtureId plain_variant(family.name, device, "fast-relaxed-math");
+    REQUIRE(family.fixtures.count(plain_variant) == 1);
+    REQUIRE(family.build_variants.at(plain_variant).reference == plain);
+    auto fixture = std::dynamic_pointer_cast<TestFixture>(family.fixtures.at(plain_variant));
+    REQUIRE(fixture->build_options() == "-cl-fast-relaxed-math");
+
+    FixtureId named_variant(family.name, device, "named, mad-enable");
+    REQUIRE(family.fixtures.count(named_variant) == 1);
+    REQUIRE(family.build_variants.at(named_variant).reference == named);
+    REQUIRE(family.build_variants.at(named_variant).variant.options == "-cl-mad-enable");
+
+    REQUIRE(family.fixtures.count(FixtureId(family.name, device, "unsupported, mad-enable")) == 0);
+}
+
+TEST_CASE("No build variants keep a family unchanged", "[build_variant]") {
+    using namespace kpv::cl_benchmark;
+    std::shared_ptr<DeviceInterface> device = std::make_shared<TestDevice>("device");
+    FixtureFamily family;
+    family.name = "family";
+    family.fixtures.emplace(
+        FixtureId(family.name, device, ""), std::make_shared<TestFixture>(true, ""));
+    ExpandBuildVariants(family, {});
+    REQUIRE(family.fixtures.size() == 1);
+    REQUIRE(family.build_variants.empty());
+}
@@ -0,0 +1,12 @@
+#include "catch.hpp"
+#include "detail/environment/cache_flusher.hpp"
+
+TEST_CASE("Cache flusher covers a given size", "[cache_flusher]") {
+    using kpv::cl_benchmark::CacheFlusher;
+    CacheFlusher flusher(1024 * 1024);
+    REQUIRE(flusher.size() >= 1024 * 1024);
+    flusher.Flush();
+    flusher.Flush();
+    const std::size_t default_size = CacheFlusher::kDefaultSize;
+    REQUIRE(CacheFlusher().size() >= default_size);
+}
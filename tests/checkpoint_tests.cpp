@@ -0,0 +1,209 @@
+#include <cstdio>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/checkpoint.hpp"
+#include "test_device.hpp"
+
+namespace {
+const char* kFileName = "checkpoint_test.jsonl";
+
+// Result of a fixture after it is written to a checkpoint and restored from it
+kpv::cl_benchmark::FixtureResult RoundTrip(
+    const kpv::cl_benchmark::FixtureResult& result,
+    const kpv::cl_benchmark::FixtureFamilyResult& written_ff_result =
+        kpv::cl_benchmark::FixtureFamilyResult()) {
+    using namespace kpv::cl_benchmark;
+    FixtureId id("family", std::make_shared<TestDevice>("device"), "algorithm");
+    {
+        uint64_t seed = 0;
+        Checkpoint checkpoint(kFileName, false, seed);
+        checkpoint.Add(id, written_ff_result, result);
+    }
+    uint64_t seed = 0;
+    Checkpoint checkpoint(kFileName, true, seed);
+    FixtureFamilyResult ff_result;
+    FixtureResult restored;
+    const bool found = checkpoint.Restore(id, ff_result, restored);
+    std::remove(kFileName);
+    REQUIRE(found);
+    return restored;
+}
+}  // namespace
+
+TEST_CASE("Checkpoint restores finished fixtures and seed", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    auto device = std::make_shared<TestDevice>("device");
+    FixtureId finished_id("family", device, "algorithm");
+    FixtureId other_id("family", device, "other algorithm");
+
+    {
+        // Above 2^53, so it is lost if written as a JSON number
+        uint64_t seed = 18446744073709551557u;
+        Checkpoint checkpoint(kFileName, false, seed);
+        FixtureFamilyResult ff_result;
+        int b = ff_result.steps.Intern("b");
+        int a = ff_result.steps.Intern("a");
+        ff_result.steps.Intern("not recorded");
+        FixtureResult result;
+        result.samples.AddIteration();
+        result.samples.Record(a, Duration(5ns));
+        result.samples.Record(b, Duration(7ns));
+        result.cold_samples.AddIteration();
+        result.cold_samples.Record(b, Duration(70ns));
+        result.cold_cache = true;
+        checkpoint.Add(finished_id, ff_result, result);
+    }
+
+    uint64_t seed = 0;
+    Checkpoint checkpoint(kFileName, true, seed);
+    REQUIRE(seed == 18446744073709551557u);
+    REQUIRE(checkpoint.completed_count() == 1);
+
+    FixtureFamilyResult ff_result;
+    ff_result.steps.Intern("a");
+    FixtureResult result;
+    REQUIRE_FALSE(checkpoint.Restore(other_id, ff_result, result));
+    REQUIRE(checkpoint.Restore(finished_id, ff_result, result));
+    REQUIRE(ff_result.steps.names() == std::vector<std::string>({"a", "b", "not recorded"}));
+    REQUIRE(result.samples.iteration_count() == 1);
+    REQUIRE(result.samples.Get(0, 0) == Duration(5ns));
+    REQUIRE(result.samples.Get(1, 0) == Duration(7ns));
+    REQUIRE_FALSE(result.samples.Has(2, 0));
+    REQUIRE(result.cold_samples.iteration_count() == 1);
+    REQUIRE(result.cold_samples.Get(1, 0) == Duration(70ns));
+    REQUIRE(result.cold_cache);
+
+    std::remove(kFileName);
+}
+
+TEST_CASE("Checkpoint restores queue count and lifecycle", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    FixtureResult result;
+    result.queue_count = 2;
+    result.lifecycle["initialize"] = Duration(1ms);
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.queue_count == 2);
+    REQUIRE(restored.lifecycle.at("initialize") == Duration(1ms));
+}
+
+TEST_CASE("Checkpoint restores host iteration time", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    FixtureResult result;
+    result.host_iteration_time = Duration(1500ns);
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.host_iteration_time.is_initialized());
+    REQUIRE(restored.host_iteration_time.value() == Duration(1500ns));
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).host_iteration_time.is_initialized());
+}
+
+TEST_CASE("Checkpoint restores batching", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    FixtureFamilyResult ff_result;
+    ff_result.steps.Intern("Copy");
+    const int kernel = ff_result.steps.Intern("Kernel");
+    FixtureResult result;
+    result.launch_count = 8;
+    result.timer_resolution = Duration(80ns);
+    result.batched_steps = {kernel};
+
+    // Restored into a family without steps, so step IDs are the same
+    FixtureResult restored = RoundTrip(result, ff_result);
+    REQUIRE(restored.launch_count == 8);
+    REQUIRE(restored.timer_resolution.value() == Duration(80ns));
+    REQUIRE(restored.batched_steps == std::set<int>({kernel}));
+}
+
+TEST_CASE("Checkpoint restores accuracy", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    FixtureResult result;
+    result.accuracy = ResultAccuracy{0.5, 0.25};
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.accuracy.is_initialized());
+    REQUIRE(restored.accuracy->max_relative_error == 0.5);
+    REQUIRE(restored.accuracy->mean_relative_error == 0.25);
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).accuracy.is_initialized());
+}
+
+TEST_CASE("Checkpoint restores work amount", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    FixtureResult result;
+    result.work_amount = WorkAmount{2e9, 1e8, WorkAmount::Precision::kDouble, "a"};
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.work_amount.is_initialized());
+    REQUIRE(restored.work_amount->flops == 2e9);
+    REQUIRE(restored.work_amount->bytes == 1e8);
+    REQUIRE(restored.work_amount->precision == WorkAmount::Precision::kDouble);
+    REQUIRE(restored.work_amount->step == "a");
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).work_amount.is_initialized());
+}
+
+TEST_CASE("Checkpoint restores host allocation", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    FixtureResult result;
+    HostAllocationStrategy host_allocation;
+    host_allocation.alignment = 4096;
+    host_allocation.use_host_ptr = true;
+    result.host_allocation = host_allocation;
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.host_allocation.is_initialized());
+    REQUIRE(restored.host_allocation->alignment == 4096);
+    REQUIRE(restored.host_allocation->huge_pages == HostAllocationStrategy::HugePages::kNone);
+    REQUIRE(restored.host_allocation->use_host_ptr);
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).host_allocation.is_initialized());
+}
+
+TEST_CASE("Checkpoint restores drift", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    FixtureResult result;
+    DriftAnalysis drift;
+    drift.change_point.index = 40;
+    drift.change_point.mean_before = 100.0;
+    drift.change_point.mean_after = 120.0;
+    drift.change_point.relative_shift = 0.2;
+    drift.action = DriftAction::kRerun;
+    drift.discarded_iterations = 10;
+    drift.rerun_iterations = 10;
+    result.drift = drift;
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.drift.is_initialized());
+    REQUIRE(restored.drift->change_point.index == 40);
+    REQUIRE(restored.drift->change_point.mean_after == Approx(120.0));
+    REQUIRE(restored.drift->action == DriftAction::kRerun);
+    REQUIRE(restored.drift->discarded_iterations == 10);
+    REQUIRE(restored.drift->rerun_iterations == 10);
+    REQUIRE_FALSE(restored.drift->persists);
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).drift.is_initialized());
+}
+
+TEST_CASE("Checkpoint restores host sensors", "[checkpoint]") {
+    using namespace kpv::cl_benchmark;
+    FixtureResult result;
+    HostSensorReading sensors;
+    sensors.mean_frequency_mhz = 3000.0;
+    sensors.temperatures["x86_pkg_temp"] = 55.0;
+    result.sensors_before = sensors;
+    result.sensors_after = HostSensorReading();
+
+    FixtureResult restored = RoundTrip(result);
+    REQUIRE(restored.sensors_before.is_initialized());
+    REQUIRE(restored.sensors_before->mean_frequency_mhz.value() == 3000.0);
+    REQUIRE_FALSE(restored.sensors_before->min_frequency_mhz.is_initialized());
+    REQUIRE(restored.sensors_before->temperatures.at("x86_pkg_temp") == 55.0);
+    REQUIRE(restored.sensors_after.is_initialized());
+    REQUIRE(restored.sensors_after->temperatures.empty());
+    REQUIRE_FALSE(RoundTrip(FixtureResult()).sensors_before.is_initialized());
+}
@@ -0,0 +1,62 @@
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/data/data_generator.hpp"
+#include "detail/data/seed.hpp"
+
+TEST_CASE("Data generator output doesn't depend on thread count", "[data_generator]") {
+    using namespace kpv::cl_benchmark;
+    const std::size_t count = 1000000;
+    std::vector<double> single_thread(count);
+    std::vector<double> multiple_threads(count);
+    DataGenerator(42, {}, 1).FillUniformReal(single_thread, -1.0, 1.0, "test");
+    DataGenerator(42, {}, 7).FillUniformReal(multiple_threads, -1.0, 1.0, "test");
+    REQUIRE(single_thread == multiple_threads);
+}
+
+TEST_CASE("Data generator output depends on seed and stream name", "[data_generator]") {
+    using namespace kpv::cl_benchmark;
+    const std::size_t count = 1000;
+    std::vector<int32_t> reference(count);
+    std::vector<int32_t> same(count);
+    std::vector<int32_t> other_seed(count);
+    std::vector<int32_t> other_stream(count);
+    DataGenerator(1).FillUniformInt(reference, 0, 1000000, "a");
+    DataGenerator(1).FillUniformInt(same, 0, 1000000, "a");
+    DataGenerator(2).FillUniformInt(other_seed, 0, 1000000, "a");
+    DataGenerator(1).FillUniformInt(other_stream, 0, 1000000, "b");
+    REQUIRE(reference == same);
+    REQUIRE(reference != other_seed);
+    REQUIRE(reference != other_stream);
+}
+
+TEST_CASE("Data generator output is in requested range", "[data_generator]") {
+    using namespace kpv::cl_benchmark;
+    const std::size_t count = 100000;
+    std::vector<int32_t> ints(count);
+    DataGenerator(3).FillUniformInt(ints, -5, 20, "ints");
+    REQUIRE(*std::min_element(ints.cbegin(), ints.cend()) == -5);
+    REQUIRE(*std::max_element(ints.cbegin(), ints.cend()) == 20);
+
+    std::vector<float> floats(count);
+    DataGenerator(3).FillUniformReal(floats, 1e-6f, 1e6f, "floats");
+    REQUIRE(*std::min_element(floats.cbegin(), floats.cend()) >= 1e-6f);
+    REQUIRE(*std::max_element(floats.cbegin(), floats.cend()) <= 1e6f);
+}
+
+TEST_CASE("Seeds are written as strings without precision loss", "[data_generator]") {
+    using namespace kpv::cl_benchmark;
+    // Not representable as a double
+    const uint64_t seed = 18446744073709551557u;
+    REQUIRE(SeedToJson(seed).is_string());
+    REQUIRE(SeedFromJson(SeedToJson(seed)) == seed);
+    REQUIRE(SeedFromJson(nlohmann::json(uint64_t{123})) == 123);
+    REQUIRE(SeedFromString("18446744073709551557") == seed);
+    REQUIRE(SeedFromString("\"42\"") == 42);
+    REQUIRE_THROWS_AS(SeedFromString(""), std::invalid_argument);
+    REQUIRE_THROWS_AS(SeedFromString("-1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(SeedFromString("12x"), std::invalid_argument);
+    REQUIRE_THROWS_AS(SeedFromString("18446744073709551616"), std::invalid_argument);
+}
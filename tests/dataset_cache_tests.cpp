@@ -0,0 +1,42 @@
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/data/dataset_cache.hpp"
+
+TEST_CASE("Dataset cache creates a dataset once per key", "[dataset_cache]") {
+    using namespace kpv::cl_benchmark;
+    DatasetCache cache;
+    int factory_calls = 0;
+    auto factory = [&factory_calls]() {
+        ++factory_calls;
+        return std::vector<int>{1, 2, 3};
+    };
+    auto first = cache.GetOrCreate<std::vector<int>>("a", factory);
+    auto second = cache.GetOrCreate<std::vector<int>>("a", factory);
+    REQUIRE(factory_calls == 1);
+    REQUIRE(first == second);
+    REQUIRE(*first == std::vector<int>({1, 2, 3}));
+
+    cache.GetOrCreate<std::vector<int>>("b", factory);
+    REQUIRE(factory_calls == 2);
+    REQUIRE(cache.size() == 2);
+}
+
+TEST_CASE("Dataset cache rejects a key stored with another type", "[dataset_cache]") {
+    using namespace kpv::cl_benchmark;
+    DatasetCache cache;
+    cache.GetOrCreate<int>("a", []() { return 1; });
+    REQUIRE_THROWS_AS(
+        cache.GetOrCreate<std::string>("a", []() { return std::string(); }), std::logic_error);
+}
+
+TEST_CASE("Datasets outlive cache while they are used", "[dataset_cache]") {
+    using namespace kpv::cl_benchmark;
+    DatasetCache cache;
+    auto dataset = cache.GetOrCreate<std::string>("a", []() { return std::string("data"); });
+    cache.Clear();
+    REQUIRE(cache.size() == 0);
+    REQUIRE(*dataset == "data");
+}
@@ -0,0 +1,78 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include "catch.hpp"
+#include "detail/environment/device_profile.hpp"
+
+namespace {
+kpv::cl_benchmark::DeviceProfile MakeProfile(
+    const std::string& device_name, const std::string& driver_version) {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    DeviceProfile profile;
+    profile.device_name = device_name;
+    profile.driver_version = driver_version;
+    profile.measurement_time = "2020-01-01T00:00:00Z";
+    profile.ceilings.gbytes_per_second = 400.0;
+    profile.ceilings.single_gflops = 10000.0;
+    profile.local_gbytes_per_second = 4000.0;
+    profile.launch_latency = Duration(5us);
+    profile.host_to_device_gbytes_per_second = 12.0;
+    profile.device_to_host_gbytes_per_second = 13.0;
+    return profile;
+}
+}  // namespace
+
+TEST_CASE("Device profiles are stored by device name and driver version", "[device_profile]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    const std::string file_name = "device_profile_test.json";
+    std::remove(file_name.c_str());
+    {
+        DeviceProfileStore profiles(file_name);
+        REQUIRE(profiles.size() == 0);
+        DeviceProfile gpu = MakeProfile("GPU", "1.0");
+        gpu.ceilings.double_gflops = 500.0;
+        profiles.Add(gpu);
+        profiles.Add(MakeProfile("GPU", "2.0"));
+        // Measured again with the same driver
+        DeviceProfile cpu = MakeProfile("CPU", "1.0");
+        profiles.Add(cpu);
+        cpu.local_gbytes_per_second = 1000.0;
+        profiles.Add(cpu);
+        REQUIRE(profiles.size() == 3);
+        profiles.Save();
+    }
+
+    DeviceProfileStore profiles(file_name);
+    REQUIRE(profiles.size() == 3);
+    REQUIRE_FALSE(profiles.Find("GPU", "3.0").is_initialized());
+    REQUIRE_FALSE(profiles.Find("Accelerator", "1.0").is_initialized());
+    boost::optional<DeviceProfile> gpu = profiles.Find("GPU", "1.0");
+    REQUIRE(gpu.is_initialized());
+    REQUIRE(gpu->measurement_time == "2020-01-01T00:00:00Z");
+    REQUIRE(gpu->ceilings.gbytes_per_second == 400.0);
+    REQUIRE(gpu->ceilings.single_gflops == 10000.0);
+    REQUIRE(gpu->ceilings.double_gflops.value() == 500.0);
+    REQUIRE(gpu->launch_latency == Duration(5us));
+    REQUIRE(gpu->host_to_device_gbytes_per_second == 12.0);
+    REQUIRE(gpu->device_to_host_gbytes_per_second == 13.0);
+    REQUIRE_FALSE(profiles.Find("GPU", "2.0")->ceilings.double_gflops.is_initialized());
+    REQUIRE(profiles.Find("CPU", "1.0")->local_gbytes_per_second == 1000.0);
+
+    std::remove(file_name.c_str());
+}
+
+TEST_CASE("Broken device profile file is ignored", "[device_profile]") {
+    using namespace kpv::cl_benchmark;
+    const std::string file_name = "device_profile_broken_test.json";
+    {
+        std::ofstream file(file_name);
+        file << "{\"profiles\": [{\"device\": \"GPU\"";
+    }
+    DeviceProfileStore profiles(file_name);
+    REQUIRE(profiles.size() == 0);
+    std::remove(file_name.c_str());
+}
@@ -0,0 +1,83 @@
+#include <random>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/statistics/drift_detector.hpp"
+
+namespace {
+// Normal noise with 1% deviation around a mean of 1000
+std::vector<double> NoisySeries(std::size_t size, std::mt19937& engine) {
+    std::normal_distribution<double> noise(1000.0, 10.0);
+    std::vector<double> result(size);
+    for (double& value : result) {
+        value = noise(engine);
+    }
+    return result;
+}
+}  // namespace
+
+TEST_CASE("Stable series has no change point", "[drift_detector]") {
+    using namespace kpv::cl_benchmark;
+    std::mt19937 engine(42);
+    for (int i = 0; i < 20; ++i) {
+        REQUIRE_FALSE(DetectChangePoint(NoisySeries(500, engine), 0.05).is_initialized());
+    }
+    REQUIRE_FALSE(DetectChangePoint(std::vector<double>(100, 7.0), 0.05).is_initialized());
+    // Too short to split into two segments
+    REQUIRE_FALSE(DetectChangePoint({1.0, 1.0, 1.0, 2.0, 2.0, 2.0}, 0.05).is_initialized());
+}
+
+TEST_CASE("Shift of a mean is found", "[drift_detector]") {
+    using namespace kpv::cl_benchmark;
+    std::mt19937 engine(7);
+
+    SECTION("Noisy series becomes slower") {
+        std::vector<double> series = NoisySeries(400, engine);
+        for (std::size_t i = 300; i < series.size(); ++i) {
+            series[i] *= 1.2;
+        }
+        boost::optional<ChangePoint> change_point = DetectChangePoint(series, 0.05);
+        REQUIRE(change_point.is_initialized());
+        REQUIRE(change_point->index >= 295);
+        REQUIRE(change_point->index <= 305);
+        REQUIRE(change_point->relative_shift == Approx(0.2).margin(0.01));
+        REQUIRE(change_point->mean_before == Approx(1000.0).margin(5.0));
+        // A threshold above a shift hides it
+        REQUIRE_FALSE(DetectChangePoint(series, 0.3).is_initialized());
+    }
+
+    SECTION("Noiseless step") {
+        std::vector<double> series(30, 100.0);
+        for (std::size_t i = 12; i < series.size(); ++i) {
+            series[i] = 80.0;
+        }
+        boost::optional<ChangePoint> change_point = DetectChangePoint(series, 0.05);
+        REQUIRE(change_point.is_initialized());
+        REQUIRE(change_point->index == 12);
+        REQUIRE(change_point->relative_shift == Approx(-0.2));
+    }
+
+    SECTION("Gradual drift") {
+        std::vector<double> series = NoisySeries(400, engine);
+        for (std::size_t i = 0; i < series.size(); ++i) {
+            series[i] += i;  // Mean grows by 40% over a run
+        }
+        REQUIRE(DetectChangePoint(series, 0.05).is_initialized());
+    }
+
+    SECTION("A few outliers are not drift") {
+        std::vector<double> series = NoisySeries(400, engine);
+        series[100] = 5000.0;
+        series[396] = 5000.0;
+        series[399] = 5000.0;
+        REQUIRE_FALSE(DetectChangePoint(series, 0.05).is_initialized());
+    }
+}
+
+TEST_CASE("Drift action names", "[drift_detector]") {
+    using namespace kpv::cl_benchmark;
+    for (auto action : {DriftAction::kFlag, DriftAction::kDiscard, DriftAction::kRerun}) {
+        REQUIRE(DriftActionFromName(DriftActionName(action)) == action);
+    }
+    REQUIRE_THROWS_AS(DriftActionFromName("ignore"), std::invalid_argument);
+}
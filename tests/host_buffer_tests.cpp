@@ -0,0 +1,63 @@
+#include <cstdint>
+#include <utility>
+
+#include "catch.hpp"
+#include "detail/data/host_buffer.hpp"
+
+TEST_CASE("Host buffer is aligned and initialized", "[host_buffer]") {
+    using namespace kpv::cl_benchmark;
+    for (std::size_t alignment :
+         {std::size_t(8), std::size_t(HostAllocationStrategy::kCacheLineSize),
+          std::size_t(HostAllocationStrategy::kPageSize)}) {
+        HostAllocationStrategy strategy;
+        strategy.alignment = alignment;
+        HostBuffer<double> buffer(1000, strategy);
+        REQUIRE(buffer.size() == 1000);
+        REQUIRE(reinterpret_cast<std::uintptr_t>(buffer.data()) % alignment == 0);
+        REQUIRE(buffer[0] == 0.0);
+        REQUIRE(buffer[999] == 0.0);
+        REQUIRE(buffer.strategy().alignment == alignment);
+    }
+
+    HostAllocationStrategy strategy;
+    strategy.alignment = 3;
+    REQUIRE_THROWS_AS(HostBuffer<float>(10, strategy), std::invalid_argument);
+}
+
+TEST_CASE("Host buffer reports huge pages it actually uses", "[host_buffer]") {
+    using namespace kpv::cl_benchmark;
+    HostAllocationStrategy strategy;
+    strategy.huge_pages = HostAllocationStrategy::HugePages::kExplicit;
+    // Buffer is smaller than a huge page
+    HostBuffer<float> small_buffer(16, strategy);
+    REQUIRE(small_buffer.strategy().huge_pages == HostAllocationStrategy::HugePages::kNone);
+
+    // Reserved huge pages may be unavailable, any result is valid but memory must be usable
+    HostBuffer<float> large_buffer(HostAllocationStrategy::kHugePageSize, strategy);
+    large_buffer[large_buffer.size() - 1] = 1.0f;
+    REQUIRE(large_buffer[large_buffer.size() - 1] == 1.0f);
+    if (large_buffer.strategy().huge_pages != HostAllocationStrategy::HugePages::kNone) {
+        REQUIRE(
+            reinterpret_cast<std::uintptr_t>(large_buffer.data()) %
+                HostAllocationStrategy::kHugePageSize ==
+            0);
+    }
+
+    HostBuffer<float> moved(std::move(large_buffer));
+    REQUIRE(large_buffer.data() == nullptr);
+    REQUIRE(moved[moved.size() - 1] == 1.0f);
+}
+
+TEST_CASE("Host allocation strategy is serialized", "[host_buffer]") {
+    using namespace kpv::cl_benchmark;
+    HostAllocationStrategy strategy;
+    strategy.alignment = 4096;
+    strategy.huge_pages = HostAllocationStrategy::HugePages::kTransparent;
+    strategy.use_host_ptr = true;
+    const nlohmann::json tree = strategy;
+    REQUIRE(tree.at("hugePages") == "transparent");
+    const HostAllocationStrategy restored = tree.get<HostAllocationStrategy>();
+    REQUIRE(restored.alignment == 4096);
+    REQUIRE(restored.huge_pages == HostAllocationStrategy::HugePages::kTransparent);
+    REQUIRE(restored.use_host_ptr);
+}
@@ -0,0 +1,49 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <string>
+
+#include "catch.hpp"
+#include "detail/reporters/json_benchmark_reporter.hpp"
+#include "test_device.hpp"
+
+TEST_CASE("Batched and single steps are compared with their own timer ticks", "[reporter]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    const std::string file_name = "reporter_test.json";
+    FixtureId id("family", std::make_shared<TestDevice>("device"), "algorithm");
+    FixtureFamilyResult ff_result;
+    ff_result.name = "family";
+    const int kernel = ff_result.steps.Intern("Kernel");
+    const int copy = ff_result.steps.Intern("Copy");
+    const int big_copy = ff_result.steps.Intern("Big copy");
+    FixtureResult result;
+    result.timer_resolution = Duration(1000ns);
+    result.launch_count = 10;
+    result.batched_steps = {kernel};
+    for (int i = 0; i < 4; ++i) {
+        result.samples.AddIteration();
+        // Per launch, 4 ticks of an effective resolution of 100 ns
+        result.samples.Record(kernel, Duration(400ns));
+        // 2 ticks of a timer, but 20 ticks of an effective resolution
+        result.samples.Record(copy, Duration(2000ns));
+        result.samples.Record(big_copy, Duration(10000ns));
+    }
+    ff_result.benchmark.emplace(id, result);
+
+    JsonBenchmarkReporter reporter(file_name);
+    reporter.AddFixtureFamilyResults(ff_result);
+    reporter.Flush();
+    std::ifstream file(file_name);
+    const nlohmann::json fixture =
+        nlohmann::json::parse(file).at("fixtureFamilies").at(0).at("fixtures").at(0);
+    file.close();
+    std::remove(file_name.c_str());
+
+    REQUIRE(fixture.at("launchesPerBatch") == 10);
+    const nlohmann::json& steps = fixture.at("stepsNearTimerResolution");
+    REQUIRE(steps.size() == 2);
+    REQUIRE(steps.at("Kernel") == 1.0);
+    REQUIRE(steps.at("Copy") == 1.0);
+}
@@ -0,0 +1,157 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/metrics/metrics_registry.hpp"
+#include "detail/metrics/metrics_server.hpp"
+#include "test_device.hpp"
+
+#if defined(__linux__)
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+// Family with one fixture, every iteration has a single "Run" step of a given duration
+kpv::cl_benchmark::FixtureFamilyResult MakeFamilyResult(
+    const std::shared_ptr<kpv::cl_benchmark::DeviceInterface>& device, double milliseconds) {
+    using namespace kpv::cl_benchmark;
+    FixtureFamilyResult ff_result;
+    ff_result.name = "family";
+    ff_result.element_count = 1024;
+    const int run = ff_result.steps.Intern("Run");
+    FixtureResult result;
+    for (int i = 0; i < 2; ++i) {
+        result.samples.AddIteration();
+        result.samples.Record(
+            run, Duration(std::chrono::duration<double, std::milli>(milliseconds)));
+    }
+    ff_result.benchmark.emplace(FixtureId("family", device, "algorithm"), result);
+    return ff_result;
+}
+
+bool Contains(const std::string& text, const std::string& line) {
+    return text.find(line + "\n") != std::string::npos;
+}
+
+// Value of a sample given by a metric name with labels, NaN if it is missing
+double Value(const std::string& text, const std::string& sample) {
+    const std::size_t position = text.find(sample + " ");
+    if (position == std::string::npos) {
+        return std::nan("");
+    }
+    return std::stod(text.substr(position + sample.size() + 1));
+}
+
+const char* kLabels = "{family=\"family\",device=\"device \\\"0\\\"\",algorithm=\"algorithm\","
+                      "elements=\"1024\"}";
+
+#if defined(__linux__)
+std::string HttpGet(int port, const std::string& path) {
+    const int connection = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    if (connect(connection, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+        close(connection);
+        return "";
+    }
+    const std::string request = "GET " + path + " HTTP/1.1\r\nHost: localhost\r\n\r\n";
+    send(connection, request.data(), request.size(), MSG_NOSIGNAL);
+    std::string response;
+    char buffer[1024];
+    ssize_t received = 0;
+    while ((received = recv(connection, buffer, sizeof(buffer), 0)) > 0) {
+        response.append(buffer, static_cast<std::size_t>(received));
+    }
+    close(connection);
+    return response;
+}
+#endif
+}  // namespace
+
+TEST_CASE("Metrics keep a rolling window of runs", "[metrics]") {
+    using namespace kpv::cl_benchmark;
+    auto device = std::make_shared<TestDevice>("device \"0\"");
+    MetricsRegistry metrics(2);
+    for (double milliseconds : {1.0, 4.0, 2.0}) {
+        metrics.AddFixtureFamilyResults(MakeFamilyResult(device, milliseconds));
+        metrics.CycleFinished(1000.0);
+    }
+    REQUIRE(metrics.cycle_count() == 3);
+
+    const std::string text = metrics.ToPrometheusText();
+    REQUIRE(Contains(text, "# TYPE cl_benchmark_fixture_runs_total counter"));
+    REQUIRE(Contains(text, "cl_benchmark_cycles_total 3"));
+    REQUIRE(Contains(text, "cl_benchmark_last_cycle_timestamp_seconds 1000"));
+    REQUIRE(Contains(text, std::string("cl_benchmark_fixture_runs_total") + kLabels + " 3"));
+    REQUIRE(Contains(text, std::string("cl_benchmark_fixture_failures_total") + kLabels + " 0"));
+    REQUIRE(
+        Value(text, std::string("cl_benchmark_iteration_seconds") + kLabels) == Approx(0.002));
+    // The first run has left a window of two runs
+    REQUIRE(
+        Value(text, std::string("cl_benchmark_iteration_window_mean_seconds") + kLabels) ==
+        Approx(0.003));
+    REQUIRE(
+        Value(text, std::string("cl_benchmark_iteration_window_min_seconds") + kLabels) ==
+        Approx(0.002));
+    REQUIRE(
+        Value(text, std::string("cl_benchmark_iteration_window_max_seconds") + kLabels) ==
+        Approx(0.004));
+    REQUIRE(
+        Value(
+            text,
+            "cl_benchmark_step_seconds{family=\"family\",device=\"device \\\"0\\\"\","
+            "algorithm=\"algorithm\",elements=\"1024\",step=\"Run\"}") == Approx(0.002));
+}
+
+TEST_CASE("Failed runs are counted without statistics", "[metrics]") {
+    using namespace kpv::cl_benchmark;
+    auto device = std::make_shared<TestDevice>("device \"0\"");
+    MetricsRegistry metrics(10);
+    FixtureFamilyResult ff_result = MakeFamilyResult(device, 1.0);
+    ff_result.benchmark.begin()->second.failure_reason = std::string("error");
+    metrics.AddFixtureFamilyResults(ff_result);
+
+    const std::string text = metrics.ToPrometheusText();
+    REQUIRE(Contains(text, std::string("cl_benchmark_fixture_failures_total") + kLabels + " 1"));
+    REQUIRE(text.find("cl_benchmark_iteration_seconds{") == std::string::npos);
+    REQUIRE_THROWS_AS(MetricsRegistry(0), std::invalid_argument);
+}
+
+TEST_CASE("Metrics file is replaced", "[metrics]") {
+    using namespace kpv::cl_benchmark;
+    const std::string file_name = "metrics_test.prom";
+    WriteMetricsFile(file_name, "first 1\n");
+    WriteMetricsFile(file_name, "second 2\n");
+    std::ifstream file(file_name);
+    std::stringstream content;
+    content << file.rdbuf();
+    REQUIRE(content.str() == "second 2\n");
+    std::remove(file_name.c_str());
+}
+
+#if defined(__linux__)
+TEST_CASE("Metrics are served over HTTP", "[metrics]") {
+    using namespace kpv::cl_benchmark;
+    MetricsServer server(0);
+    REQUIRE(server.port() > 0);
+    server.Publish("cl_benchmark_cycles_total 1\n");
+
+    const std::string response = HttpGet(server.port(), "/metrics");
+    REQUIRE(response.compare(0, 15, "HTTP/1.1 200 OK") == 0);
+    REQUIRE(response.find("Content-Type: text/plain; version=0.0.4") != std::string::npos);
+    REQUIRE(response.find("\r\n\r\ncl_benchmark_cycles_total 1\n") != std::string::npos);
+
+    REQUIRE(HttpGet(server.port(), "/other").compare(0, 12, "HTTP/1.1 404") == 0);
+}
+#endif
@@ -0,0 +1,19 @@
+#include <chrono>
+
+#include "catch.hpp"
+#include "detail/events/opencl_event_batch.hpp"
+
+TEST_CASE("Launch count makes a batch much longer than timer resolution", "[batching]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    // Long kernels are not batched
+    REQUIRE(RequiredLaunchCount(Duration(1000ns), Duration(1ms), 1) == 1);
+    REQUIRE(RequiredLaunchCount(Duration(1000ns), Duration(10us), 1) == 10);
+    // Measured with more launches, already enough
+    REQUIRE(RequiredLaunchCount(Duration(1000ns), Duration(10us), 10) == 10);
+    // Zero duration is an upper bound of resolution / launch count
+    REQUIRE(RequiredLaunchCount(Duration(80ns), Duration(0ns), 1) == 100);
+    REQUIRE(RequiredLaunchCount(Duration(80ns), Duration(0ns), 100) == 4096);
+    // Unknown resolution disables batching
+    REQUIRE(RequiredLaunchCount(Duration(0ns), Duration(0ns), 1) == 1);
+}
@@ -0,0 +1,117 @@
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/compilation/program_cache.hpp"
+
+namespace {
+kpv::cl_benchmark::ProgramSource MakeSource(
+    const std::string& source, const std::string& options = std::string()) {
+    return kpv::cl_benchmark::ProgramSource{boost::compute::context(), source, options};
+}
+}  // namespace
+
+TEST_CASE("Program cache builds every program once", "[program_cache]") {
+    using namespace kpv::cl_benchmark;
+    std::atomic<int> build_count(0);
+    ProgramCache cache(0, [&build_count](const ProgramSource&) {
+        ++build_count;
+        return boost::compute::program();
+    });
+    cache.Prefetch(MakeSource("a"));
+    REQUIRE(cache.size() == 0);
+
+    cache.Get(MakeSource("a"));
+    cache.Get(MakeSource("a"));
+    REQUIRE(build_count == 1);
+    cache.Get(MakeSource("a", "-cl-mad-enable"));
+    cache.Get(MakeSource("b"));
+    REQUIRE(build_count == 3);
+    REQUIRE(cache.size() == 3);
+}
+
+TEST_CASE("Program cache builds prefetched programs in background", "[program_cache]") {
+    using namespace kpv::cl_benchmark;
+    std::atomic<int> build_count(0);
+    ProgramCache cache(2, [&build_count](const ProgramSource&) {
+        ++build_count;
+        return boost::compute::program();
+    });
+    REQUIRE(cache.thread_count() == 2);
+    for (const char* source : {"a", "b", "c", "a"}) {
+        cache.Prefetch(MakeSource(source));
+    }
+    REQUIRE(cache.size() == 3);
+    for (const char* source : {"c", "b", "a"}) {
+        cache.Get(MakeSource(source));
+    }
+    REQUIRE(build_count == 3);
+}
+
+TEST_CASE("Program cache rethrows build errors", "[program_cache]") {
+    using namespace kpv::cl_benchmark;
+    int build_count = 0;
+    ProgramCache cache(0, [&build_count](const ProgramSource&) -> boost::compute::program {
+        ++build_count;
+        throw std::runtime_error("Build failed");
+    });
+    REQUIRE_THROWS_AS(cache.Get(MakeSource("a")), std::runtime_error);
+    REQUIRE_THROWS_AS(cache.Get(MakeSource("a")), std::runtime_error);
+    REQUIRE(build_count == 1);
+}
+
+TEST_CASE("Program cache keeps build durations", "[program_cache]") {
+    using namespace kpv::cl_benchmark;
+    std::atomic<int> build_count(0);
+    ProgramCache cache(2, [&build_count](const ProgramSource&) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        ++build_count;
+        return boost::compute::program();
+    });
+    REQUIRE_FALSE(cache.TakeBuildDuration(MakeSource("a")).is_initialized());
+    for (const char* source : {"a", "b", "c"}) {
+        cache.Prefetch(MakeSource(source));
+    }
+    cache.WaitForPrefetches();
+    REQUIRE(build_count == 3);
+    for (const char* source : {"a", "b", "c"}) {
+        boost::optional<Duration> duration = cache.TakeBuildDuration(MakeSource(source));
+        REQUIRE(duration.is_initialized());
+        REQUIRE(duration.value() >= Duration(std::chrono::milliseconds(10)));
+        // The next user of a program gets it from the cache without building
+        cache.Get(MakeSource(source));
+        REQUIRE_FALSE(cache.TakeBuildDuration(MakeSource(source)).is_initialized());
+    }
+    cache.Get(MakeSource("d"));
+    REQUIRE(cache.TakeBuildDuration(MakeSource("d")).is_initialized());
+    REQUIRE(build_count == 4);
+    // Nothing to wait for
+    cache.WaitForPrefetches();
+}
+
+TEST_CASE("Compile pipeline prefetches programs of next fixtures", "[program_cache]") {
+    using namespace kpv::cl_benchmark;
+    auto cache = std::make_shared<ProgramCache>(
+        1, [](const ProgramSource&) { return boost::compute::program(); });
+    CompilePipeline pipeline(cache, 1);
+    pipeline.AddFixture({MakeSource("a")});
+    pipeline.AddFixture({});
+    pipeline.AddFixture({MakeSource("b"), MakeSource("c")});
+    pipeline.AddFixture({MakeSource("a")});
+
+    pipeline.StartFixture();
+    REQUIRE(cache->size() == 1);
+    pipeline.StartFixture();
+    REQUIRE(cache->size() == 3);
+    pipeline.StartFixture();
+    pipeline.StartFixture();
+    REQUIRE(cache->size() == 3);
+    // Fixtures beyond the list are ignored
+    pipeline.StartFixture();
+    REQUIRE(cache->size() == 3);
+}
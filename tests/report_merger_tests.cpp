@@ -0,0 +1,40 @@
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/reporters/report_merger.hpp"
+
+namespace {
+nlohmann::json MakeReport(int shard_index, const nlohmann::json& families) {
+    return {{"baseInfo",
+             {{"seed", 1},
+              {"shard", {{"index", shard_index}, {"count", 2}}},
+              {"driverVersions", {{"device " + std::to_string(shard_index), "1.0"}}}}},
+            {"deviceList", {{"platform", {"common", "device " + std::to_string(shard_index)}}}},
+            {"fixtureFamilies", families}};
+}
+}  // namespace
+
+TEST_CASE("Shard reports are merged", "[report_merger]") {
+    using nlohmann::json;
+    std::vector<json> reports = {
+        MakeReport(
+            1, {{{"name", "second"}, {"registrationIndex", 1}, {"steps", {"run"}},
+                 {"fixtures", {{{"name", "device 1"}}}}}}),
+        MakeReport(
+            2, {{{"name", "first"}, {"registrationIndex", 0}, {"steps", {"copy"}},
+                 {"fixtures", {{{"name", "device 2"}}}}},
+                {{"name", "second"}, {"registrationIndex", 1}, {"steps", {"copy", "run"}},
+                 {"fixtures", {{{"name", "device 2"}}}}}})};
+
+    json result = kpv::cl_benchmark::MergeReports(reports);
+    REQUIRE(result["baseInfo"].count("shard") == 0);
+    REQUIRE(result["baseInfo"]["driverVersions"].size() == 2);
+    REQUIRE(result["deviceList"]["platform"] == json({"common", "device 1", "device 2"}));
+
+    const json& families = result["fixtureFamilies"];
+    REQUIRE(families.size() == 2);
+    REQUIRE(families[0]["name"] == "first");
+    REQUIRE(families[1]["name"] == "second");
+    REQUIRE(families[1]["steps"] == json({"run", "copy"}));
+    REQUIRE(families[1]["fixtures"].size() == 2);
+}
@@ -0,0 +1,29 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/threading/run_in_parallel.hpp"
+
+TEST_CASE("RunInParallel calls function for every index", "[run_in_parallel]") {
+    using namespace kpv::cl_benchmark;
+    std::vector<int> calls(8, 0);
+    RunInParallel(calls.size(), [&calls](std::size_t index) { ++calls[index]; });
+    REQUIRE(calls == std::vector<int>(8, 1));
+}
+
+TEST_CASE("RunInParallel rethrows exceptions after all threads finish", "[run_in_parallel]") {
+    using namespace kpv::cl_benchmark;
+    std::atomic<int> finished{0};
+    REQUIRE_THROWS_AS(
+        RunInParallel(
+            4,
+            [&finished](std::size_t index) {
+                if (index == 2) {
+                    throw std::runtime_error("failure");
+                }
+                ++finished;
+            }),
+        std::runtime_error);
+    REQUIRE(finished == 3);
+}
@@ -0,0 +1,111 @@
+#include <memory>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/partitioning/run_shard.hpp"
+#include "test_device.hpp"
+
+namespace {
+class TestFixture : public kpv::cl_benchmark::Fixture {
+public:
+    kpv::cl_benchmark::EventList Execute(const kpv::cl_benchmark::RuntimeParams&) override {
+        return kpv::cl_benchmark::EventList();
+    }
+};
+
+kpv::cl_benchmark::FixtureFamily MakeFamily(
+    const std::string& name,
+    const std::vector<std::shared_ptr<kpv::cl_benchmark::DeviceInterface>>& devices) {
+    kpv::cl_benchmark::FixtureFamily family;
+    family.name = name;
+    for (const auto& device : devices) {
+        for (const auto& algorithm : {"a", "b"}) {
+            family.fixtures.emplace(
+                kpv::cl_benchmark::FixtureId(name, device, algorithm),
+                std::make_shared<TestFixture>());
+        }
+    }
+    return family;
+}
+}  // namespace
+
+TEST_CASE("Shard is parsed", "[run_shard]") {
+    using namespace kpv::cl_benchmark;
+    RunShard shard = RunShard::Parse("2/4");
+    REQUIRE(shard.index == 1);
+    REQUIRE(shard.count == 4);
+    REQUIRE(shard.ToString() == "2/4");
+    REQUIRE_FALSE(RunShard::Parse("1/1").enabled());
+    REQUIRE_THROWS_AS(RunShard::Parse("0/4"), std::invalid_argument);
+    REQUIRE_THROWS_AS(RunShard::Parse("5/4"), std::invalid_argument);
+    REQUIRE_THROWS_AS(RunShard::Parse("2"), std::invalid_argument);
+    REQUIRE_THROWS_AS(RunShard::Parse("2/4x"), std::invalid_argument);
+}
+
+TEST_CASE("Shards split whole families without overlaps", "[run_shard]") {
+    using namespace kpv::cl_benchmark;
+    std::vector<std::shared_ptr<DeviceInterface>> devices = {
+        std::make_shared<TestDevice>("gpu"), std::make_shared<TestDevice>("cpu"),
+        std::make_shared<TestDevice>("accelerator")};
+    const int kShardCount = 2;
+    std::vector<ShardAssigner> assigners;
+    for (int i = 0; i < kShardCount; ++i) {
+        RunShard shard;
+        shard.index = i;
+        shard.count = kShardCount;
+        assigners.emplace_back(shard);
+    }
+
+    std::set<std::string> seen;
+    std::size_t total_count = 0;
+    std::vector<int> family_counts(kShardCount);
+    for (const auto& family_name : {"first", "second", "third", "fourth"}) {
+        for (int i = 0; i < kShardCount; ++i) {
+            FixtureFamily family = MakeFamily(family_name, devices);
+            assigners[i].SelectFixtures(family);
+            if (family.fixtures.empty()) {
+                continue;
+            }
+            // Comparisons between devices of a family need all of them in one shard
+            REQUIRE(family.fixtures.size() == 6);
+            ++family_counts[i];
+            total_count += family.fixtures.size();
+            for (const auto& p : family.fixtures) {
+                seen.insert(family_name + p.first.device()->UniqueName() + p.first.algorithm());
+            }
+        }
+        // Empty families are not assigned to any shard
+        for (auto& assigner : assigners) {
+            FixtureFamily empty_family = MakeFamily("empty", {});
+            assigner.SelectFixtures(empty_family);
+        }
+    }
+    REQUIRE(total_count == 24);
+    REQUIRE(seen.size() == 24);
+    REQUIRE(family_counts == std::vector<int>({2, 2}));
+}
+
+TEST_CASE("New assigners select the same families every time", "[run_shard]") {
+    using namespace kpv::cl_benchmark;
+    std::vector<std::shared_ptr<DeviceInterface>> devices = {std::make_shared<TestDevice>("cpu")};
+    RunShard shard = RunShard::Parse("1/3");
+    // Two families are not a multiple of three shards, so a reused assigner would shift
+    auto select = [&devices](ShardAssigner& assigner) {
+        std::vector<std::string> selected;
+        for (const auto& family_name : {"first", "second"}) {
+            FixtureFamily family = MakeFamily(family_name, devices);
+            assigner.SelectFixtures(family);
+            if (!family.fixtures.empty()) {
+                selected.push_back(family_name);
+            }
+        }
+        return selected;
+    };
+    for (int cycle = 0; cycle < 3; ++cycle) {
+        ShardAssigner assigner(shard);
+        REQUIRE(select(assigner) == std::vector<std::string>({"first"}));
+    }
+}
@@ -0,0 +1,58 @@
+#include <chrono>
+#include <stdexcept>
+
+#include "catch.hpp"
+#include "detail/indicators/duration_indicator.hpp"
+#include "detail/simulation/duration_distribution.hpp"
+
+namespace {
+kpv::cl_benchmark::Duration AverageDuration(
+    kpv::cl_benchmark::DurationDistribution& distribution, int count) {
+    kpv::cl_benchmark::StepList steps;
+    int step_id = steps.Intern("step");
+    kpv::cl_benchmark::FixtureResult result;
+    for (int i = 0; i < count; ++i) {
+        result.samples.AddIteration();
+        result.samples.Record(step_id, distribution.Next());
+    }
+    return kpv::cl_benchmark::DurationIndicator(result, steps).total_duration();
+}
+}  // namespace
+
+TEST_CASE("Simulated distributions are parsed", "[simulated_device]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    DurationDistribution normal = DurationDistribution::Parse("normal:10mcs:0.1");
+    REQUIRE(normal.kind() == DurationDistribution::Kind::kNormal);
+    REQUIRE(normal.mean() == Duration(10us));
+    REQUIRE(DurationDistribution::Parse("fixed:1ms").kind() == DurationDistribution::Kind::kFixed);
+    REQUIRE_THROWS_AS(DurationDistribution::Parse("uniform:1ms"), std::invalid_argument);
+    REQUIRE_THROWS_AS(DurationDistribution::Parse("normal"), std::invalid_argument);
+    REQUIRE_THROWS_AS(DurationDistribution::Parse("heavy:1ms:0.5"), std::invalid_argument);
+}
+
+TEST_CASE("Average duration converges to distribution mean", "[simulated_device]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    DurationDistribution fixed(DurationDistribution::Kind::kFixed, Duration(1us));
+    REQUIRE(AverageDuration(fixed, 10) == Duration(1us));
+
+    DurationDistribution normal(DurationDistribution::Kind::kNormal, Duration(1us), 0.1, 1);
+    REQUIRE(
+        AverageDuration(normal, 100000).duration().count() ==
+        Approx(1000.0).epsilon(0.01));
+
+    DurationDistribution heavy(DurationDistribution::Kind::kHeavyTailed, Duration(1us), 3.0, 2);
+    REQUIRE(
+        AverageDuration(heavy, 100000).duration().count() ==
+        Approx(1000.0).epsilon(0.05));
+}
+
+TEST_CASE("Drifting distribution grows linearly", "[simulated_device]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    DurationDistribution drift(DurationDistribution::Kind::kDrifting, Duration(100ns), 0.5);
+    REQUIRE(drift.Next() == Duration(100ns));
+    REQUIRE(drift.Next() == Duration(150ns));
+    REQUIRE(drift.Next() == Duration(200ns));
+}
@@ -0,0 +1,94 @@
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/indicators/duration_indicator.hpp"
+#include "detail/statistics/streaming_statistics.hpp"
+
+TEST_CASE("Streaming statistics match exact ones", "[streaming_statistics]") {
+    using namespace kpv::cl_benchmark;
+    std::mt19937_64 engine(1);
+    std::lognormal_distribution<double> distribution(10.0, 0.5);
+    std::vector<double> values;
+    StreamingStatistics statistics;
+    for (int i = 0; i < 100000; ++i) {
+        double value = distribution(engine);
+        values.push_back(value);
+        statistics.Add(value);
+    }
+
+    double sum = 0.0;
+    for (double value : values) {
+        sum += value;
+    }
+    double mean = sum / values.size();
+    double squares = 0.0;
+    for (double value : values) {
+        squares += (value - mean) * (value - mean);
+    }
+    std::sort(values.begin(), values.end());
+
+    REQUIRE(statistics.count() == values.size());
+    REQUIRE(statistics.mean() == Approx(mean));
+    REQUIRE(statistics.variance() == Approx(squares / (values.size() - 1)));
+    REQUIRE(statistics.min() == values.front());
+    REQUIRE(statistics.max() == values.back());
+    for (double q : {0.5, 0.9, 0.99}) {
+        double exact = values[static_cast<std::size_t>(std::ceil(q * values.size())) - 1];
+        REQUIRE(statistics.Quantile(q) == Approx(exact).epsilon(0.006));
+    }
+}
+
+TEST_CASE("Streaming statistics survive serialization", "[streaming_statistics]") {
+    using namespace kpv::cl_benchmark;
+    StreamingStatistics statistics;
+    for (double value : {5.0, 1000.0, 1e6, 0.5, 3e20}) {
+        statistics.Add(value);
+    }
+    REQUIRE(statistics.Quantile(0.0) == 0.5);
+    REQUIRE(statistics.Quantile(1.0) == 3e20);
+
+    StreamingStatistics restored = nlohmann::json(statistics).get<StreamingStatistics>();
+    REQUIRE(restored.count() == statistics.count());
+    REQUIRE(restored.mean() == statistics.mean());
+    REQUIRE(restored.variance() == statistics.variance());
+    REQUIRE(restored.Quantile(0.5) == statistics.Quantile(0.5));
+}
+
+TEST_CASE("Streaming samples keep only the last iteration", "[streaming_statistics]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    StepList steps;
+    int first = steps.Intern("first");
+    int second = steps.Intern("second");
+    FixtureResult result;
+    result.samples = IterationSamples(IterationSamples::Storage::kStreaming);
+    for (int i = 1; i <= 100; ++i) {
+        result.samples.AddIteration();
+        result.samples.Record(first, Duration(std::chrono::nanoseconds(i)));
+        result.samples.Record(first, Duration(1000ns));  // Ignored, the first duration is kept
+        if (i % 2 == 0) {
+            result.samples.Record(second, Duration(10ns));
+        }
+    }
+    REQUIRE(result.samples.iteration_count() == 100);
+    REQUIRE(result.samples.IterationTotal(99) == Duration(110ns));
+    REQUIRE_THROWS_AS(result.samples.Get(first, 0), std::out_of_range);
+    REQUIRE(result.samples.statistics(first).count() == 100);
+    REQUIRE(result.samples.statistics(second).count() == 50);
+
+    nlohmann::json tree;
+    DurationIndicator indicator(result, steps);
+    indicator.SerializeValue(tree);
+    const nlohmann::json& step = tree.at("compressedDuration").at("first");
+    REQUIRE(step.at("avg").get<Duration>() == Duration(50.5ns));
+    REQUIRE(step.at("min").get<Duration>() == Duration(1ns));
+    REQUIRE(step.at("max").get<Duration>() == Duration(100ns));
+    REQUIRE(step.count("p99") == 1);
+    // Missing iterations count as zero duration in an average, as for stored samples
+    REQUIRE(
+        tree.at("compressedDuration").at("second").at("avg").get<Duration>() == Duration(5ns));
+    REQUIRE(indicator.total_duration() == Duration(55.5ns));
+}
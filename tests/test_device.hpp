@@ -0,0 +1,28 @@
+#ifndef KPV_TESTS_TEST_DEVICE_H_
+#define KPV_TESTS_TEST_DEVICE_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "detail/devices/device_interface.hpp"
+
+/*
+Device without a platform for tests that only need a name to key results
+*/
+class TestDevice : public kpv::cl_benchmark::DeviceInterface {
+public:
+    explicit TestDevice(const std::string& name) : name_(name) {}
+    std::string Name() override { return name_; }
+    std::vector<std::string> Extensions() override { return {}; }
+    std::string UniqueName() override { return name_; }
+    std::string DriverVersion() override { return "1.0"; }
+    std::weak_ptr<kpv::cl_benchmark::PlatformInterface> platform() override {
+        return std::weak_ptr<kpv::cl_benchmark::PlatformInterface>();
+    }
+
+private:
+    std::string name_;
+};
+
+#endif  // KPV_TESTS_TEST_DEVICE_H_
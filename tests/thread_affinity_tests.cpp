@@ -0,0 +1,21 @@
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/environment/thread_affinity.hpp"
+
+TEST_CASE("CPU list parser handles single values and ranges", "[thread_affinity]") {
+    using namespace kpv::cl_benchmark;
+    REQUIRE(ParseCpuList("").empty());
+    REQUIRE(ParseCpuList("3") == std::vector<int>{3});
+    REQUIRE(ParseCpuList("0,2,4-7") == std::vector<int>({0, 2, 4, 5, 6, 7}));
+    REQUIRE(ParseCpuList(" 1 , 0-1 ") == std::vector<int>({0, 1}));
+}
+
+TEST_CASE("CPU list parser rejects incorrect values", "[thread_affinity]") {
+    using namespace kpv::cl_benchmark;
+    REQUIRE_THROWS_AS(ParseCpuList("a"), std::invalid_argument);
+    REQUIRE_THROWS_AS(ParseCpuList("-1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(ParseCpuList("3-1"), std::invalid_argument);
+    REQUIRE_THROWS_AS(ParseCpuList("1x"), std::invalid_argument);
+}
@@ -0,0 +1,88 @@
+#include <atomic>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/devices/platform_list.hpp"
+#include "detail/threading/thread_pool.hpp"
+
+TEST_CASE("Thread pool covers every index once", "[thread_pool]") {
+    using namespace kpv::cl_benchmark;
+    for (int thread_count : {1, 3, 8}) {
+        ThreadPool pool(thread_count);
+        REQUIRE(pool.thread_count() == thread_count);
+        for (std::size_t count : {std::size_t(0), std::size_t(1), std::size_t(1000)}) {
+            std::vector<std::atomic<int>> calls(count);
+            for (auto& call : calls) {
+                call = 0;
+            }
+            pool.ParallelFor(count, [&calls](std::size_t begin, std::size_t end) {
+                for (std::size_t i = begin; i < end; ++i) {
+                    ++calls[i];
+                }
+            });
+            for (auto& call : calls) {
+                REQUIRE(call == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("Thread pool makes chunks of a given size", "[thread_pool]") {
+    using namespace kpv::cl_benchmark;
+    ThreadPool pool(4, 10);
+    REQUIRE(pool.ChunkSize(1000) == 10);
+    std::vector<int> chunk_sizes(11, 0);
+    pool.ParallelFor(105, [&chunk_sizes](std::size_t begin, std::size_t end) {
+        REQUIRE(begin % 10 == 0);
+        chunk_sizes[begin / 10] = static_cast<int>(end - begin);
+    });
+    REQUIRE(chunk_sizes == std::vector<int>({10, 10, 10, 10, 10, 10, 10, 10, 10, 10, 5}));
+
+    // Automatic chunk size gives several chunks to every thread
+    ThreadPool auto_pool(4);
+    REQUIRE(auto_pool.ChunkSize(3200) == 100);
+    REQUIRE(auto_pool.ChunkSize(3) == 1);
+}
+
+TEST_CASE("Thread pool rethrows an exception of a chunk", "[thread_pool]") {
+    using namespace kpv::cl_benchmark;
+    ThreadPool pool(4);
+    REQUIRE_THROWS_AS(
+        pool.ParallelFor(
+            100, 1,
+            [](std::size_t begin, std::size_t) {
+                if (begin == 50) {
+                    throw std::runtime_error("failure");
+                }
+            }),
+        std::runtime_error);
+    // Pool is usable after a failure
+    std::atomic<int> sum{0};
+    pool.ParallelFor(100, 1, [&sum](std::size_t, std::size_t) { sum += 1; });
+    REQUIRE(sum == 100);
+}
+
+TEST_CASE("Thread sweep adds host devices with growing thread counts", "[thread_pool]") {
+    using namespace kpv::cl_benchmark;
+    DeviceConfiguration config(false);
+    config.host_device = true;
+    config.host_threads = 6;
+    config.host_thread_sweep = true;
+    PlatformList platform_list(config);
+    std::vector<int> thread_counts;
+    for (auto& device : platform_list.HostPlatforms().front()->GetDevices()) {
+        thread_counts.push_back(std::dynamic_pointer_cast<HostDevice>(device)->thread_count());
+    }
+    REQUIRE(thread_counts == std::vector<int>({1, 2, 4, 6}));
+    auto first = platform_list.HostPlatforms().front()->GetDevices().front();
+    REQUIRE(first->Name() == "Host CPU, 1 thread");
+    REQUIRE(std::dynamic_pointer_cast<HostDevice>(first)->thread_pool().thread_count() == 1);
+
+    config.host_thread_sweep = false;
+    PlatformList single_list(config);
+    auto device = single_list.HostPlatforms().front()->GetDevices().front();
+    REQUIRE(single_list.HostPlatforms().front()->GetDevices().size() == 1);
+    REQUIRE(device->Name() == "Host CPU");
+    REQUIRE(std::dynamic_pointer_cast<HostDevice>(device)->thread_count() == 6);
+}
@@ -0,0 +1,116 @@
+#include <chrono>
+
+#include "catch.hpp"
+#include "detail/indicators/throughput_indicator.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+
+namespace {
+// Every iteration has a 1 ms "Calculating" step and a 1 ms "Copying" step
+kpv::cl_benchmark::FixtureResult MakeResult(kpv::cl_benchmark::StepList& steps) {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    FixtureResult result;
+    const int calculating = steps.Intern("Calculating");
+    const int copying = steps.Intern("Copying");
+    for (int i = 0; i < 4; ++i) {
+        result.samples.AddIteration();
+        result.samples.Record(calculating, Duration(1ms));
+        result.samples.Record(copying, Duration(1ms));
+    }
+    return result;
+}
+}  // namespace
+
+TEST_CASE("Fixture without work amount has no throughput", "[throughput_indicator]") {
+    using namespace kpv::cl_benchmark;
+    StepList steps;
+    FixtureResult result = MakeResult(steps);
+    ThroughputIndicator indicator(result, steps, boost::none);
+    REQUIRE_FALSE(indicator.calculated());
+    nlohmann::json tree = nlohmann::json::object();
+    indicator.SerializeValue(tree);
+    REQUIRE(tree.count("throughput") == 0);
+}
+
+TEST_CASE("Throughput is calculated for a step", "[throughput_indicator]") {
+    using namespace kpv::cl_benchmark;
+    StepList steps;
+    FixtureResult result = MakeResult(steps);
+    WorkAmount work;
+    work.flops = 2e9;
+    work.bytes = 1e8;
+    work.step = "Calculating";
+    result.work_amount = work;
+
+    nlohmann::json tree = nlohmann::json::object();
+    ThroughputIndicator(result, steps, boost::none).SerializeValue(tree);
+    REQUIRE(tree.at("throughput").at("gflops").get<double>() == Approx(2000.0));
+    REQUIRE(tree.at("throughput").at("gbytesPerSecond").get<double>() == Approx(100.0));
+    REQUIRE(tree.at("throughput").at("arithmeticIntensity").get<double>() == Approx(20.0));
+    REQUIRE(tree.at("throughput").at("step") == "Calculating");
+    REQUIRE(tree.at("throughput").count("roofline") == 0);
+
+    // Whole iteration is used without a step
+    result.work_amount->step.clear();
+    tree = nlohmann::json::object();
+    ThroughputIndicator(result, steps, boost::none).SerializeValue(tree);
+    REQUIRE(tree.at("throughput").at("gflops").get<double>() == Approx(1000.0));
+    REQUIRE(tree.at("throughput").count("step") == 0);
+
+    // Unknown step
+    result.work_amount->step = "Missing";
+    REQUIRE_FALSE(ThroughputIndicator(result, steps, boost::none).calculated());
+}
+
+TEST_CASE("Fixture is placed on a roofline", "[throughput_indicator]") {
+    using namespace kpv::cl_benchmark;
+    StepList steps;
+    FixtureResult result = MakeResult(steps);
+    RooflineCeilings ceilings;
+    ceilings.gbytes_per_second = 500.0;
+    ceilings.single_gflops = 10000.0;  // Ridge point is at 20 flops per byte
+    WorkAmount work;
+    work.step = "Calculating";
+
+    SECTION("Memory-bound") {
+        work.flops = 2e8;
+        work.bytes = 4e8;
+        result.work_amount = work;
+        nlohmann::json tree = nlohmann::json::object();
+        ThroughputIndicator(result, steps, ceilings).SerializeValue(tree);
+        const nlohmann::json& roofline = tree.at("throughput").at("roofline");
+        REQUIRE(roofline.at("boundBy") == "memory");
+        REQUIRE(roofline.at("ridgePoint").get<double>() == Approx(20.0));
+        REQUIRE(roofline.at("attainableGflops").get<double>() == Approx(250.0));
+        REQUIRE(roofline.at("fractionOfAttainable").get<double>() == Approx(0.8));
+        // 200 GFLOP/s and 400 GB/s
+        const nlohmann::json& percent = tree.at("throughput").at("percentOfPeak");
+        REQUIRE(percent.at("flops").get<double>() == Approx(2.0));
+        REQUIRE(percent.at("bandwidth").get<double>() == Approx(80.0));
+    }
+
+    SECTION("Compute-bound") {
+        work.flops = 5e9;
+        work.bytes = 1e8;
+        result.work_amount = work;
+        nlohmann::json tree = nlohmann::json::object();
+        ThroughputIndicator(result, steps, ceilings).SerializeValue(tree);
+        const nlohmann::json& roofline = tree.at("throughput").at("roofline");
+        REQUIRE(roofline.at("boundBy") == "compute");
+        REQUIRE(roofline.at("attainableGflops").get<double>() == Approx(10000.0));
+        REQUIRE(roofline.at("fractionOfAttainable").get<double>() == Approx(0.5));
+    }
+
+    SECTION("Double precision peak is unknown") {
+        work.flops = 5e9;
+        work.bytes = 1e8;
+        work.precision = WorkAmount::Precision::kDouble;
+        result.work_amount = work;
+        nlohmann::json tree = nlohmann::json::object();
+        ThroughputIndicator(result, steps, ceilings).SerializeValue(tree);
+        REQUIRE(tree.at("throughput").count("roofline") == 0);
+        REQUIRE(tree.at("throughput").at("percentOfPeak").count("flops") == 0);
+        REQUIRE(tree.at("throughput").at("percentOfPeak").at("bandwidth").get<double>() ==
+                Approx(20.0));
+    }
+}
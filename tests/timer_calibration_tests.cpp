@@ -0,0 +1,64 @@
+#include <chrono>
+#include <memory>
+
+#include "catch.hpp"
+#include "detail/environment/timer_calibration.hpp"
+#include "detail/reporters/benchmark_results.hpp"
+
+TEST_CASE("Host clock is calibrated", "[timer_calibration]") {
+    using namespace kpv::cl_benchmark;
+    DeviceConfiguration config(false);
+    config.simulated_devices.push_back(DurationDistribution::Parse("fixed:1mcs"));
+    PlatformList platform_list(config);
+
+    TimerCalibration calibration = TimerCalibration::Collect(platform_list);
+    REQUIRE(calibration.host.resolution > Duration());
+    REQUIRE(calibration.host.resolution < Duration(std::chrono::milliseconds(1)));
+    REQUIRE(calibration.host.read_overhead > Duration());
+    REQUIRE(calibration.devices.empty());
+
+    // Simulated devices have no timer
+    auto device = platform_list.SimulatedPlatforms().front()->GetDevices().front();
+    REQUIRE_FALSE(calibration.Resolution(device).is_initialized());
+
+    nlohmann::json tree = calibration;
+    REQUIRE(tree.at("host").count("resolution") == 1);
+    REQUIRE(tree.at("devices").empty());
+}
+
+TEST_CASE("Host device is measured with a host clock", "[timer_calibration]") {
+    using namespace kpv::cl_benchmark;
+    DeviceConfiguration config(false);
+    config.host_device = true;
+    PlatformList platform_list(config);
+    REQUIRE(platform_list.HostPlatforms().size() == 1);
+    REQUIRE(platform_list.AllPlatforms().size() == 1);
+
+    auto device = platform_list.HostPlatforms().front()->GetDevices().front();
+    REQUIRE(std::dynamic_pointer_cast<HostDevice>(device)->thread_count() >= 1);
+    REQUIRE(device->platform().lock() == platform_list.HostPlatforms().front());
+
+    TimerCalibration calibration = TimerCalibration::Collect(platform_list);
+    REQUIRE(calibration.Resolution(device).value() == calibration.host.resolution);
+}
+
+TEST_CASE("Samples shorter than a threshold are counted", "[timer_calibration]") {
+    using namespace kpv::cl_benchmark;
+    using namespace std::literals::chrono_literals;
+    for (auto storage : {IterationSamples::Storage::kAll, IterationSamples::Storage::kStreaming}) {
+        IterationSamples samples(storage);
+        for (int i = 1; i <= 10; ++i) {
+            samples.AddIteration();
+            samples.Record(0, Duration(std::chrono::nanoseconds(i * 100)));
+            if (i % 2 == 0) {
+                samples.Record(1, Duration(1s));
+            }
+        }
+        REQUIRE(samples.FractionBelow(0, Duration(50ns)) == 0.0);
+        // Histogram buckets are narrow, so the value is exact here
+        REQUIRE(samples.FractionBelow(0, Duration(350ns)) == Approx(0.3));
+        REQUIRE(samples.FractionBelow(0, Duration(2000ns)) == 1.0);
+        REQUIRE(samples.FractionBelow(1, Duration(2000ns)) == 0.0);
+        REQUIRE(samples.FractionBelow(2, Duration(2000ns)) == 0.0);
+    }
+}
@@ -0,0 +1,60 @@
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+#include "catch.hpp"
+#include "detail/partitioning/work_partitioner.hpp"
+
+namespace {
+// Check that ranges cover [0, work_size) without gaps and overlaps
+void RequireContinuous(const std::vector<kpv::cl_benchmark::WorkRange>& ranges, size_t work_size) {
+    size_t expected_begin = 0;
+    for (const auto& range : ranges) {
+        REQUIRE(range.begin == expected_begin);
+        REQUIRE(range.end >= range.begin);
+        expected_begin = range.end;
+    }
+    REQUIRE(expected_begin == work_size);
+}
+}  // namespace
+
+TEST_CASE("Static partition splits work equally", "[work_partitioner]") {
+    using namespace kpv::cl_benchmark;
+    auto ranges = StaticPartition(100, 4);
+    REQUIRE(ranges.size() == 4);
+    RequireContinuous(ranges, 100);
+    for (const auto& range : ranges) {
+        REQUIRE(range.size() == 25);
+    }
+    RequireContinuous(StaticPartition(7, 3), 7);
+    RequireContinuous(StaticPartition(2, 5), 2);
+}
+
+TEST_CASE("Proportional partition follows weights and granularity", "[work_partitioner]") {
+    using namespace kpv::cl_benchmark;
+    auto ranges = ProportionalPartition(1000, {3.0, 1.0});
+    RequireContinuous(ranges, 1000);
+    REQUIRE(ranges[0].size() == 750);
+    REQUIRE(ranges[1].size() == 250);
+
+    ranges = ProportionalPartition(1000, {1.0, 0.0, 1.0}, 64);
+    RequireContinuous(ranges, 1000);
+    REQUIRE(ranges[0].size() % 64 == 0);
+    REQUIRE(ranges[1].size() == 0);
+
+    REQUIRE_THROWS_AS(ProportionalPartition(10, {0.0, 0.0}), std::invalid_argument);
+    REQUIRE_THROWS_AS(ProportionalPartition(10, {-1.0, 2.0}), std::invalid_argument);
+}
+
+TEST_CASE("Dynamic partitioner hands out all work exactly once", "[work_partitioner]") {
+    using namespace kpv::cl_benchmark;
+    DynamicPartitioner partitioner(10, 4);
+    std::vector<WorkRange> ranges;
+    WorkRange range;
+    while (partitioner.Next(range)) {
+        ranges.push_back(range);
+    }
+    REQUIRE(ranges.size() == 3);
+    RequireContinuous(ranges, 10);
+    REQUIRE(ranges.back().size() == 2);
+}